@@ -1,6 +1,11 @@
 #include "matmul.hpp"
+#include "calcapp/system.hpp"
+#include "numeric/cpu_features.hpp"
 #include <valarray>
 #include <numeric>
+#include <vector>
+#include <limits>
+#include <chrono>
 
 #ifdef HAVE_BOOST_UBLAS
 # include <boost/numeric/ublas/matrix.hpp>
@@ -162,7 +167,7 @@ namespace Calc
       }
     };
 
-    //TODO: allow non-POD types in block version(replace VLA with aligned_alloc or std::valarray)
+    //TODO: allow non-POD types in block version(packed buffers are raw aligned memory)
     template<typename T> struct BlockTraits
     {
       typedef T type;
@@ -203,7 +208,54 @@ namespace Calc
     {
       template<typename T> inline void perform(const AlgoParameters& p)
       {
-        //TODO: strassen multiplication should be better for large matrices
+        if(!std::is_class<T>::value)
+        {
+        numeric::dgemm_strassen<typename BlockTraits<T>::type>(numeric::TMatrixStorage::RowMajor,
+            p.a->getDataPtr<typename BlockTraits<T>::type>(),
+            p.b->getDataPtr<typename BlockTraits<T>::type>(),
+            p.c->getDataPtr<typename BlockTraits<T>::type>(),
+            p.a->getRowsNum(), p.a->getColumnsNum(), p.b->getRowsNum(), p.b->getColumnsNum(), p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
+      }
+    };
+
+    //cache oblivious recursive c++ version for matrices in row major order
+    struct numeric_cpp_recursive : numeric::MPFuncBase<numeric_cpp_recursive,AlgoParameters>
+    {
+      template<typename T> inline void perform(const AlgoParameters& p)
+      {
+        if(!std::is_class<T>::value)
+        {
+        numeric::dgemm_recursive<typename BlockTraits<T>::type>(numeric::TMatrixStorage::RowMajor,
+            numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+            p.a->getDataPtr<typename BlockTraits<T>::type>(),
+            p.b->getDataPtr<typename BlockTraits<T>::type>(),
+            p.c->getDataPtr<typename BlockTraits<T>::type>(),
+            p.a->getRowsNum(), p.a->getColumnsNum(), p.b->getRowsNum(), p.b->getColumnsNum(), p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
+      }
+    };
+
+    //cache oblivious recursive c++ version for matrices in tiled storage
+    struct numeric_cpp_recursive_tiled : numeric::MPFuncBase<numeric_cpp_recursive_tiled,AlgoParameters>
+    {
+      template<typename T> inline void perform(const AlgoParameters& p)
+      {
+        if(!std::is_class<T>::value)
+        {
+        numeric::dgemm_recursive<typename BlockTraits<T>::type>(numeric::TMatrixStorage::Tiled,
+            numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+            p.a->getDataPtr<typename BlockTraits<T>::type>(),
+            p.b->getDataPtr<typename BlockTraits<T>::type>(),
+            p.c->getDataPtr<typename BlockTraits<T>::type>(),
+            p.a->getRowsNum(), p.a->getColumnsNum(), p.b->getRowsNum(), p.b->getColumnsNum(), p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
       }
     };
 
@@ -433,12 +485,105 @@ namespace Calc
     };
 #endif
 
+    //block algorithm tuner: exhaustive search over micro kernels supported by cpu
+    //and block sizes around ones derived from cache sizes.
+    //nc is not searched and is taken from cache sizes: it's thousands of columns, so any trial matrix
+    //small enough to time in reasonable time fits in single panel of B and all nc candidates run the same code
+    template<typename T> void tune_block(const numeric::TThreading threading, Logger& log)
+    {
+      constexpr size_t sz = 512;
+      constexpr int repeats = 3;
+      log.fdebug("cpu: %s, L1 %zu KiB, L2 %zu KiB(%zu KiB reported by system), L3 %zu KiB, cache line %zu bytes",
+          numeric::cpu_model_name().c_str(), numeric::cache_size(1)/1024, numeric::cache_size(2)/1024,
+          SysUtil::getCpuL2CacheSize()/1024, numeric::cache_size(3)/1024, numeric::cache_line_size());
+      std::vector<T> a(sz*sz), b(sz*sz), c(sz*sz);
+      for(size_t i = 0; i < sz*sz; i++)
+      {
+        a[i] = T(i % 7) - T(3);
+        b[i] = T(i % 5) - T(2);
+      }
+      numeric::BlockConfig<T>& config = numeric::block_config<T>();
+      numeric::BlockConfig<T> best = config;
+      double best_time = std::numeric_limits<double>::max();
+      for(const numeric::BlockKernel<T>& kernel : numeric::block_kernels<T>())
+      {
+        const numeric::BlockSizes base = numeric::default_block_sizes(sizeof(T), kernel.mr, kernel.nr);
+        const size_t kc_set[] = { base.kc / 2, base.kc, base.kc * 2 };
+        const size_t mc_set[] = { base.mc / 2, base.mc, base.mc * 2 };
+        for(size_t kc : kc_set)
+          for(size_t mc : mc_set)
+          {
+            config.kernel = &kernel;
+            config.sizes.kc = ( kc < 16 ? 16 : kc );
+            config.sizes.mc = ( mc < kernel.mr ? kernel.mr : mc / kernel.mr * kernel.mr );
+            config.sizes.nc = base.nc;
+            double time = std::numeric_limits<double>::max();
+            for(int r = 0; r < repeats; r++)
+            {
+              std::fill(c.begin(), c.end(), T(0));
+              const auto start = std::chrono::steady_clock::now();
+              numeric::dgemm_block<T>(numeric::TMatrixStorage::RowMajor, a.data(), b.data(), c.data(), sz, threading);
+              const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+              time = ( elapsed < time ? elapsed : time );
+            }
+            log.fdebug("kernel %s, mc %zu, kc %zu, nc %zu: %.2f GFLOPS", kernel.name,
+                config.sizes.mc, config.sizes.kc, config.sizes.nc, 2e-9 * sz * sz * sz / time);
+            if(time < best_time)
+            {
+              best_time = time;
+              best = config;
+            }
+          }
+      }
+      config = best;
+      const numeric::BlockProfileEntry entry = { best.kernel->name, best.sizes };
+      const std::string path = numeric::block_profile_path();
+      log.fnote("best %s block configuration: kernel %s(mr %zu, nr %zu), mc %zu, kc %zu, nc %zu: %.2f GFLOPS",
+          numeric::block_profile_type_name<T>(), best.kernel->name, best.kernel->mr, best.kernel->nr,
+          best.sizes.mc, best.sizes.kc, best.sizes.nc, 2e-9 * sz * sz * sz / best_time);
+      if(!numeric::write_block_profile(path, numeric::block_profile_type_name<T>(), entry))
+        throw Calc::ParameterError("Failed to write block tuning profile");
+      log.fnote("tuning profile saved to %s", path.c_str());
+    }
+
+    //block configuration in use, either tuned one loaded from profile or one derived from cache sizes
+    template<typename T> void log_block_config(Logger& log)
+    {
+      const numeric::BlockConfig<T>& config = numeric::block_config<T>();
+      log.fnote("%s block configuration: kernel %s(mr %zu, nr %zu), mc %zu, kc %zu, nc %zu",
+          numeric::block_profile_type_name<T>(), config.kernel->name, config.kernel->mr, config.kernel->nr,
+          config.sizes.mc, config.sizes.kc, config.sizes.nc);
+    }
+
+    void tune(const AlgoParameters& parameters, Logger& log)
+    {
+      numeric::ParallelScheduler __ps(parameters.Topt.type,parameters.Topt.num);
+      ExecTimeMeter __etm(log, "matmul::tune");
+      switch(parameters.Popt.type)
+      {
+        case numeric::P_Float:
+          return tune_block<float>(parameters.Topt.type, log);
+        case numeric::P_Double:
+          return tune_block<double>(parameters.Topt.type, log);
+        default:
+          throw Calc::ParameterError("Tuning is supported for float and double precision only");
+      }
+    }
+
     //dispatcher
     void perform(const AlgoParameters& parameters, Logger& log)
     {
       numeric::ParallelScheduler __ps(parameters.Topt.type,parameters.Topt.num);
       ExecTimeMeter __etm(log, "matmul::perform");
 //      PERF_METER(log, "matmul::perform");
+      if(parameters.Aopt.type == A_NumCppBlock || parameters.Aopt.type == A_NumCppStrassen ||
+         parameters.Aopt.type == A_NumCppRecursive || parameters.Aopt.type == A_NumCppRecursiveTiled)
+      {
+        if(parameters.Popt.type == numeric::P_Float)
+          log_block_config<float>(log);
+        else if(parameters.Popt.type == numeric::P_Double)
+          log_block_config<double>(log);
+      }
       switch(parameters.Aopt.type)
       {
         case A_NumC:
@@ -464,8 +609,11 @@ namespace Calc
         case A_NumCppBlock:
           return numeric_cpp_block()(parameters.Popt.type, parameters);
         case A_NumCppStrassen:
-//          return numeric_cpp_strassen()(parameters.Popt.type, parameters);
-          throw Calc::ParameterError("Algorithm is not implemented");
+          return numeric_cpp_strassen()(parameters.Popt.type, parameters);
+        case A_NumCppRecursive:
+          return numeric_cpp_recursive()(parameters.Popt.type, parameters);
+        case A_NumCppRecursiveTiled:
+          return numeric_cpp_recursive_tiled()(parameters.Popt.type, parameters);
 
         case A_NumFortran:
 //          return numeric_fortran()(parameters.Popt.type, parameters);
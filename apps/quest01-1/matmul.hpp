@@ -18,6 +18,9 @@ namespace Calc {
     //dispatcher
     void perform(const AlgoParameters& parameters, Logger& log);
 
+    //search for best block sizes and micro kernel for block algorithm, results are saved to tuning profile
+    void tune(const AlgoParameters& parameters, Logger& log);
+
     //default c version for square matrices in row major order
     struct numeric_c;
     //simple c version for square matrices in row major order
@@ -41,6 +44,10 @@ namespace Calc {
     struct numeric_cpp_block;
     //strassen c++ version for matrices in row major order
     struct numeric_cpp_strassen;
+    //cache oblivious recursive c++ version for matrices in row major order
+    struct numeric_cpp_recursive;
+    //cache oblivious recursive c++ version for matrices in tiled storage
+    struct numeric_cpp_recursive_tiled;
 
     //default fortran version for square matrices in column major order
     struct numeric_fortran;
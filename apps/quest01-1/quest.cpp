@@ -37,6 +37,7 @@ namespace Calc {
     help.append(")\n");
     help.append(algoHelp);
     help.append("\n");
+    help.append("  --" TUNE_OPT "                             tune block algorithm for this cpu and save tuning profile\n");
 #endif
     return help;
   }
@@ -111,6 +112,7 @@ namespace Calc {
 #ifdef HAVE_BOOST
     algoOpt.add_options()
       (ALGO_OPT ",a",   bpo::value<string>()->default_value(_algo_opt_names[0].opt), algoHelp.c_str())
+      (TUNE_OPT,        "tune block algorithm for this cpu and save tuning profile")
       ;
 #endif
   }
@@ -123,6 +125,8 @@ namespace Calc {
     bool check_algo_opt = false;
     for(int i = 1; i < argc; i++)
     {
+      if(std::strcmp(argv[i],"--" TUNE_OPT) == 0)
+        m_algo.tune = true;
       if(std::strncmp(argv[i],"--algorithm",11) == 0)
       {
         if(!algo_opt.empty())
@@ -244,6 +248,9 @@ namespace Calc {
 #endif
     }
     m_algo.type = algo;
+#ifdef HAVE_BOOST
+    m_algo.tune = ( argMap.count(TUNE_OPT) > 0 );
+#endif
     return true;
   }
 
@@ -368,6 +375,12 @@ namespace Calc {
 
   void QuestApp::run()
   {
+    if(m_algo.tune)
+    {
+      log().debug("tuning block matrix multiplication...");
+      matmul::tune(*m_pAlgoParameters, log());
+      return;
+    }
     //PRERUN:
     log().debug(Summary());
     //prepare matrix reading flags per algo
@@ -387,6 +400,10 @@ namespace Calc {
       case A_ExtCppArmadillo :
       case A_ExtCBLAS :
         m_pAlgoParameters->storage = numeric::TMatrixStorage::ColumnMajor;
+        break;
+      case A_NumCppRecursiveTiled :
+        m_pAlgoParameters->storage = numeric::TMatrixStorage::Tiled;
+        break;
       default:
         break;
     }
@@ -13,6 +13,8 @@
 
 namespace Calc {
 
+#define TUNE_OPT "tune"
+
 enum TAlgo {
   A_NumCpp=0,
   A_NumC,
@@ -29,6 +31,8 @@ enum TAlgo {
   A_NumCppStrassen,
   A_NumCStrassen,
   A_NumFortranStrassen,
+  A_NumCppRecursive,
+  A_NumCppRecursiveTiled,
   A_NumFortranInternal,
   A_ExtCppBoost,
   A_ExtCppEigen,
@@ -55,6 +59,8 @@ static const OptName<TAlgo> _algo_opt_names[] = {
   { "numeric-cpp-strassen", "num-cpp-sn", A_NumCppStrassen },
   { "numeric-c-strassen", "num-c-sn", A_NumCStrassen },
   { "numeric-fortran-strassen", "num-f-sn", A_NumFortranStrassen },
+  { "numeric-cpp-recursive", "num-cpp-r", A_NumCppRecursive },
+  { "numeric-cpp-recursive-tiled", "num-cpp-rt", A_NumCppRecursiveTiled },
   { "numeric-fortran-internal", "num-f-int", A_NumFortranInternal },
   //TODO: clean up macro hell 
 #ifdef HAVE_BOOST_UBLAS
@@ -112,9 +118,11 @@ struct OutputOptions {
 
 struct AlgoOptions {
   TAlgo type;
+  bool tune;
 
   AlgoOptions():
     type(A_Undefined)
+    ,tune(false)
   {}
 };
 
@@ -39,7 +39,23 @@ namespace Calc
     {
       template<typename T> inline void perform(const AlgoParameters& p)
       {
-        //TODO: N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
+        //N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
+        const CDSBandedMatrix<T>* const a = dynamic_cast<CDSBandedMatrix<T>*>(p.a.get());
+        const CDSBandedMatrix<T>* const b = dynamic_cast<CDSBandedMatrix<T>*>(p.b.get());
+        CDSBandedMatrix<T>* const c = dynamic_cast<CDSBandedMatrix<T>*>(p.c.get());
+        if(a == nullptr || b == nullptr || c == nullptr)
+          throw Calc::ParameterError("numeric_c_mrk algo internal error");
+        //plain arrays of diagonals are handed over to diagonal-wise kernels of numeric library
+        if(!std::is_class<T>::value)
+        {
+          numeric::dgbmm_mrk<T>(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+            p.a->getDataPtr<T>(), p.b->getDataPtr<T>(), p.c->getDataPtr<T>(),
+            p.a->getRowsNum(), p.a->getColumnsNum(), a->getUpperBand(), a->getLowerBand(),
+            p.b->getRowsNum(), p.b->getColumnsNum(), b->getUpperBand(), b->getLowerBand(),
+            p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
       }
     };
 
@@ -93,7 +109,23 @@ namespace Calc
     {
       template<typename T> inline void perform(const AlgoParameters& p)
       {
-        //TODO: N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
+        //N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
+        const CDSBandedMatrix<T>* const a = dynamic_cast<CDSBandedMatrix<T>*>(p.a.get());
+        const CDSBandedMatrix<T>* const b = dynamic_cast<CDSBandedMatrix<T>*>(p.b.get());
+        CDSBandedMatrix<T>* const c = dynamic_cast<CDSBandedMatrix<T>*>(p.c.get());
+        if(a == nullptr || b == nullptr || c == nullptr)
+          throw Calc::ParameterError("numeric_cpp_mrk algo internal error");
+        //packed diagonals live in raw aligned buffers
+        if(!std::is_class<T>::value)
+        {
+          numeric::dgbmm_mrk<T>(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+            p.a->getDataPtr<T>(), p.b->getDataPtr<T>(), p.c->getDataPtr<T>(),
+            p.a->getRowsNum(), p.a->getColumnsNum(), a->getUpperBand(), a->getLowerBand(),
+            p.b->getRowsNum(), p.b->getColumnsNum(), b->getUpperBand(), b->getLowerBand(),
+            p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
       }
     };
 
@@ -204,26 +236,27 @@ namespace Calc
     {
       template<typename T> inline void perform(const AlgoParameters& p)
       {
-        //warming up
-        if(p.Topt.type != numeric::T_Serial)
-          throw Calc::ParameterError("Algotithm is not implemented");
-//        const size_t rows = p.a->getRowsNum();
-//        const size_t columns = p.b->getColumnsNum();
-//        const size_t stride = p.a->getColumnsNum();
+        //N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
         const ValArrayCDSBandedMatrix<T>* const a = dynamic_cast<ValArrayCDSBandedMatrix<T>*>(p.a.get());
         const ValArrayCDSBandedMatrix<T>* const b = dynamic_cast<ValArrayCDSBandedMatrix<T>*>(p.b.get());
         ValArrayCDSBandedMatrix<T>* const c = dynamic_cast<ValArrayCDSBandedMatrix<T>*>(p.c.get());
         if(a == nullptr || b == nullptr || c == nullptr)
           throw Calc::ParameterError("Valarray algo internal error");
-        const std::valarray<T>& A = a->getValArray();
-        const std::valarray<T>& B = b->getValArray();
-        std::valarray<T>& C = c->getValArray();
         if((c->getUpperBand() != (a->getUpperBand()+b->getUpperBand())) ||
            (c->getLowerBand() != (a->getLowerBand()+b->getLowerBand())))
           throw Calc::ParameterError("Matrix sizes mismatch");
 
-        //actual run
-        //TODO: N. Madsen, G. Rodrigue und J.Karush [1976]. Matrix multiplication by diagonals on a vector/parallel processor, Inf. Proc. Lett., vol.5
+        //actual run, diagonals are read from and written to contiguous storage of valarrays
+        if(!std::is_class<T>::value)
+        {
+          numeric::dgbmm_mrk<T>(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+            &a->getValArray()[0], &b->getValArray()[0], &c->getValArray()[0],
+            p.a->getRowsNum(), p.a->getColumnsNum(), a->getUpperBand(), a->getLowerBand(),
+            p.b->getRowsNum(), p.b->getColumnsNum(), b->getUpperBand(), b->getLowerBand(),
+            p.Topt.type);
+        } else {
+          throw Calc::ParameterError("Algotithm is not implemented");
+        }
       }
     };
 
@@ -278,6 +311,8 @@ namespace Calc
         case A_NumCSimpleTranspose:
 //          return numeric_c_simple_transpose()(parameters.Popt.type, parameters);
           throw Calc::ParameterError("Algorithm is not implemented");
+        case A_NumCMRK:
+          return numeric_c_mrk()(parameters.Popt.type, parameters);
 
         case A_NumCpp:
 //          return numeric_cpp()(parameters.Popt.type, parameters);
@@ -286,9 +321,9 @@ namespace Calc
         case A_NumCppValarray:
           return numeric_cpp_valarray()(parameters.Popt.type, parameters);
         case A_NumCppMRK:
-//          return numeric_cpp_mrk()(parameters.Popt.type, parameters);
+          return numeric_cpp_mrk()(parameters.Popt.type, parameters);
         case A_NumCppValarrayMRK:
-//          return numeric_cpp_valarray_mrk()(parameters.Popt.type, parameters);
+          return numeric_cpp_valarray_mrk()(parameters.Popt.type, parameters);
         case A_NumCppSimpleTranspose:
 //          return numeric_cpp_simple_transpose()(parameters.Popt.type, parameters);
         case A_NumCppValarrayTranspose:
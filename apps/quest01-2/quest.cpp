@@ -249,14 +249,20 @@ namespace Calc {
       canMultiply = ( a->getColumnsNum() == b->getColumnsNum() );
       nrows_C = a->getRowsNum();
       ncolumns_C = b->getRowsNum();
+      upper_band_C = a->getUpperBand() + b->getLowerBand();
+      lower_band_C = a->getLowerBand() + b->getUpperBand();
     } else if(transposeA) {
       canMultiply = ( a->getRowsNum() == b->getRowsNum() );
       nrows_C = a->getColumnsNum();
       ncolumns_C = b->getColumnsNum();
+      upper_band_C = a->getLowerBand() + b->getUpperBand();
+      lower_band_C = a->getUpperBand() + b->getLowerBand();
     } else {
       canMultiply = ( a->getColumnsNum() == b->getRowsNum() );
       nrows_C = a->getRowsNum();
       ncolumns_C = b->getColumnsNum();
+      upper_band_C = a->getUpperBand() + b->getUpperBand();
+      lower_band_C = a->getLowerBand() + b->getLowerBand();
     }
     return canMultiply;
   }
@@ -265,7 +271,7 @@ namespace Calc {
     : CliApp(dynamic_cast<const CliAppOptions&>(opt))
     , m_input(opt.getInOpts()),m_output(opt.getOutOpts()),m_algo(opt.getAlgoOpts())
     , m_pAlgoParameters(new matmul::AlgoParameters({m_threading,m_precision,m_algo,nullptr,nullptr,nullptr
-          ,0,0,false,false,numeric::TMatrixStorage::RowMajor}))
+          ,0,0,false,false,numeric::TMatrixStorage::RowMajor,0,0}))
     , m_pfA(new InFileText(m_input.filename_A,m_input.filetype,true))
     , m_pfB(new InFileText(m_input.filename_B,m_input.filetype,true))
     , m_pfC(new OutFileText(m_output.filename,m_output.filetype,false))
@@ -276,7 +282,7 @@ namespace Calc {
     : CliApp(dynamic_cast<const CliAppOptions&>(opt), pc)
     , m_input(opt.getInOpts()),m_output(opt.getOutOpts()),m_algo(opt.getAlgoOpts())
     , m_pAlgoParameters(new matmul::AlgoParameters({m_threading,m_precision,m_algo,nullptr,nullptr,nullptr
-          ,0,0,false,false,numeric::TMatrixStorage::RowMajor}))
+          ,0,0,false,false,numeric::TMatrixStorage::RowMajor,0,0}))
     , m_pfA(new InFileText(m_input.filename_A,m_input.filetype,true))
     , m_pfB(new InFileText(m_input.filename_B,m_input.filetype,true))
     , m_pfC(new OutFileText(m_output.filename,m_output.filetype,false))
@@ -300,7 +306,7 @@ namespace Calc {
     m_output.filetype = _output_opt_names[0].type; m_output.filename = "result";
     m_algo.type = A_NumCppSimple;
     m_pAlgoParameters.reset(new matmul::AlgoParameters({m_threading,m_precision,m_algo,nullptr,nullptr,nullptr
-          ,0,0,false,false,numeric::TMatrixStorage::RowMajor}));
+          ,0,0,false,false,numeric::TMatrixStorage::RowMajor,0,0}));
     m_pfA.reset(new InFileText(m_input.filename_A,m_input.filetype,true));
     m_pfB.reset(new InFileText(m_input.filename_B,m_input.filetype,true));
     m_pfC.reset(new OutFileText(m_output.filename,m_output.filetype,false));
@@ -314,7 +320,7 @@ namespace Calc {
     {
       if( _algo_opt_names[i].type == m_pAlgoParameters->Aopt.type )
       {
-        s.append("Running tridiagonal banded matrix multiplication algorithm ").append(_algo_opt_names[i].name);
+        s.append("Running banded matrix multiplication algorithm ").append(_algo_opt_names[i].name);
         break;
       }
     }
@@ -385,6 +391,7 @@ namespace Calc {
     {
       case A_NumCppValarray :
       case A_NumCppValarrayTranspose :
+      case A_NumCppValarrayMRK :
         mat_type = TMatrixType::ValArray;
         break;
       default:
@@ -414,12 +421,10 @@ namespace Calc {
     //create output matrix
     log().fdebug("creating output matrix C ( %zu x %zu ), (upper, lower) = ( %zu, %zu )...",
         m_pAlgoParameters->nrows_C, m_pAlgoParameters->ncolumns_C,
-        m_pAlgoParameters->a->getUpperBand() + m_pAlgoParameters->b->getUpperBand(),
-        m_pAlgoParameters->a->getLowerBand() + m_pAlgoParameters->b->getLowerBand());
+        m_pAlgoParameters->upper_band_C, m_pAlgoParameters->lower_band_C);
     m_pAlgoParameters->c.reset(NewMatrix(m_precision.type,
           m_pAlgoParameters->nrows_C, m_pAlgoParameters->ncolumns_C, true, m_pAlgoParameters->storage, mat_type, mat_flavour,
-          m_pAlgoParameters->a->getUpperBand() + m_pAlgoParameters->b->getUpperBand(),
-          m_pAlgoParameters->a->getLowerBand() + m_pAlgoParameters->b->getLowerBand()));
+          m_pAlgoParameters->upper_band_C, m_pAlgoParameters->lower_band_C));
     //read input data
     log().debug("reading input matrices...");
     readInput();
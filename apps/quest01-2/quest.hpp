@@ -106,6 +106,8 @@ namespace matmul{
     bool transposeA;
     bool transposeB;
     numeric::TMatrixStorage storage;
+    size_t upper_band_C;
+    size_t lower_band_C;
     bool initCsize();
   };
 }
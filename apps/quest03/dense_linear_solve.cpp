@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <memory>
 
 namespace Calc
 {
@@ -56,6 +57,84 @@ namespace Calc
       }
     };
 
+    //residuals of mixed precision solver are accumulated in the widest precision available
+#ifdef HAVE_QUADMATH
+    typedef numeric::quad mixed_lu_residual_type;
+#else
+    typedef long double mixed_lu_residual_type;
+#endif
+
+    //LU and Cholesky factors which should be saved are kept in factor objects
+    template<typename Factor> void solve_and_save_factor(const Factor& factor, const AlgoParameters& p, Logger& log)
+    {
+      factor.solve(p.x, p.b_buf.get());
+      log.debug("writing factor of the matrix...");
+      OutFileText f(p.Aopt.factor_out, FT_MatrixText, false);
+      factor.writeToFile(f);
+    }
+
+    void perform_and_save_factor(const AlgoParameters& p, Logger& log)
+    {
+      const size_t _sz = p.system_size;
+      const double* const _A_buf = p.A_buf.get();
+      switch(p.Aopt.type)
+      {
+        case A_NumCppBlockedLU:
+        case A_NumCppTiledLU:
+          {
+            LUFactor<double> lu;
+            if(!lu.factor(_A_buf,_sz,_sz,p.Topt.type,p.Aopt.type == A_NumCppTiledLU))
+            {
+              log.error("zero pivot element found, the matrix of the system is singular");
+              throw Calc::ParameterError("Matrix of the system is singular");
+            }
+            return solve_and_save_factor(lu,p,log);
+          }
+        case A_NumCppTiledCholesky:
+        case A_NumCppBlockedCholesky:
+          {
+            CholeskyFactor<double> cholesky;
+            size_t failed_pivot = 0;
+            if(!cholesky.factor(_A_buf,_sz,_sz,p.Topt.type,p.Aopt.type == A_NumCppTiledCholesky,&failed_pivot))
+            {
+              Calc::__cholesky_failed(log,failed_pivot);
+              throw Calc::ParameterError("Matrix of the system is not symmetric positive definite");
+            }
+            return solve_and_save_factor(cholesky,p,log);
+          }
+        default:
+          throw Calc::ParameterError("Only LU and Cholesky factors can be saved");
+      }
+    }
+
+    template<typename Factor> void read_factor_and_solve(Matrix<double>& rhs, const AlgoParameters& p, Logger& log)
+    {
+      Factor factor;
+      log.debug("reading factor of the matrix...");
+      InFileText f(p.Aopt.factor_in, FT_MatrixText, true);
+      factor.readFromFile(f);
+      if(factor.getSize() != rhs.getRowsNum())
+        throw Calc::ParameterError("Size of saved factor doesn't match number of equations");
+      factor.solve(rhs, p.Topt.type);
+    }
+
+    void perform_factored(const AlgoParameters& p, Matrix<double>& rhs, Logger& log)
+    {
+      numeric::ParallelScheduler __ps(p.Topt.type,p.Topt.num);
+      ExecTimeMeter __etm(log, "dense_linear_solve::perform_factored");
+      switch(p.Aopt.type)
+      {
+        case A_NumCppBlockedLU:
+        case A_NumCppTiledLU:
+          return read_factor_and_solve< LUFactor<double> >(rhs,p,log);
+        case A_NumCppTiledCholesky:
+        case A_NumCppBlockedCholesky:
+          return read_factor_and_solve< CholeskyFactor<double> >(rhs,p,log);
+        default:
+          throw Calc::ParameterError("Only LU and Cholesky factors can be read");
+      }
+    }
+
     //dispatcher
     void perform(const AlgoParameters& p, Logger& log)
     {
@@ -67,6 +146,8 @@ namespace Calc
       double* const _b_buf = p.b_buf.get();
       double* const _x = p.x;
       double** _A_rows = p.A_rows;
+      if(!p.Aopt.factor_out.empty())
+        return perform_and_save_factor(p, log);
       switch(p.Aopt.type)
       {
         case A_NumCppGauss:
@@ -79,6 +160,39 @@ namespace Calc
 //          return numeric_cpp_gauss_full_pivoting()(p.Popt.type, p);
           return Calc::gauss_full_pivoting_impl<double>(_sz,_A_buf,_b_buf,_A_rows,_x,
               reinterpret_cast<size_t * const>(new size_t[_sz]),log);
+        case A_NumCppBlockedLU:
+          {
+            std::unique_ptr<size_t[]> _pivots(new size_t[_sz]);
+            if(!Calc::blocked_lu_impl<double>(_sz,_A_buf,_b_buf,_x,_pivots.get(),log,p.Topt.type))
+              throw Calc::ParameterError("Matrix of the system is singular");
+            return;
+          }
+        case A_NumCppTiledLU:
+          {
+            std::unique_ptr<size_t[]> _pivots(new size_t[_sz]);
+            if(!Calc::tiled_lu_impl<double>(_sz,_A_buf,_b_buf,_x,_pivots.get(),log,p.Topt.type))
+              throw Calc::ParameterError("Matrix of the system is singular");
+            return;
+          }
+        case A_NumCppTiledCholesky:
+          if(!Calc::tiled_cholesky_impl<double>(_sz,_A_buf,_b_buf,_x,log,p.Topt.type))
+            throw Calc::ParameterError("Matrix of the system is not symmetric positive definite");
+          return;
+        case A_NumCppBlockedCholesky:
+          if(!Calc::blocked_cholesky_impl<double>(_sz,_A_buf,_b_buf,_x,log,p.Topt.type))
+            throw Calc::ParameterError("Matrix of the system is not symmetric positive definite");
+          return;
+        case A_NumCppLDLT:
+          {
+            std::unique_ptr<std::ptrdiff_t[]> _pivots(new std::ptrdiff_t[_sz]);
+            if(!Calc::ldlt_impl<double>(_sz,_A_buf,_b_buf,_x,_pivots.get(),log,p.Topt.type))
+              throw Calc::ParameterError("Matrix of the system is singular");
+            return;
+          }
+        case A_NumCppMixedLU:
+          if(!Calc::mixed_lu_impl<float,double,mixed_lu_residual_type>(_sz,_A_buf,_b_buf,_x,log,p.Topt.type))
+            throw Calc::ParameterError("Matrix of the system is singular");
+          return;
         case A_Undefined:
         default:
           throw Calc::ParameterError("Algorithm is not implemented");
@@ -9,6 +9,7 @@
 #include "numeric/expand_traits.hpp"
 
 #include "calcapp/exception.hpp"
+#include "calcapp/math/dense_factor.hpp"
 
 #include "quest.hpp"
 
@@ -19,6 +20,9 @@ namespace Calc {
     //dispatcher
     void perform(const AlgoParameters& parameters, Logger& log);
 
+    //solve systems for given right hand sides using factor of the matrix read from file, solutions overwrite rhs
+    void perform_factored(const AlgoParameters& parameters, Matrix<double>& rhs, Logger& log);
+
     //dumb c++ version of gauss elimination without pivoting
     struct numeric_cpp_gauss;
 
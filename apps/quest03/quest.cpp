@@ -39,6 +39,9 @@ namespace Calc {
     help.append(")\n");
     help.append(algoHelp);
     help.append("\n");
+    help.append("  --" FACTOR_OUT_OPT "=arg                   save factor of the matrix to file(without an extension)\n");
+    help.append("  --" FACTOR_IN_OPT "=arg                    read factor of the matrix saved before from file(without an extension),\n"
+                "                                        input file then holds right hand sides only, one per column\n");
 #endif
     return help;
   }
@@ -107,6 +110,10 @@ namespace Calc {
 #ifdef HAVE_BOOST
     algoOpt.add_options()
       (ALGO_OPT ",a",   bpo::value<string>(), algoHelp.c_str())
+      (FACTOR_OUT_OPT,  bpo::value<string>(), "save factor of the matrix to file(without an extension), "
+                                              "LU and Cholesky algorithms only")
+      (FACTOR_IN_OPT,   bpo::value<string>(), "read factor of the matrix saved before from file(without an extension), "
+                                              "input file then holds right hand sides only, one per column")
       ;
 #endif
   }
@@ -119,6 +126,10 @@ namespace Calc {
     bool check_algo_opt = false;
     for(int i = 1; i < argc; i++)
     {
+      if(std::strncmp(argv[i],"--" FACTOR_OUT_OPT "=",sizeof(FACTOR_OUT_OPT)+2) == 0)
+        m_algo.factor_out = string(argv[i]+sizeof(FACTOR_OUT_OPT)+2);
+      if(std::strncmp(argv[i],"--" FACTOR_IN_OPT "=",sizeof(FACTOR_IN_OPT)+2) == 0)
+        m_algo.factor_in = string(argv[i]+sizeof(FACTOR_IN_OPT)+2);
       if(std::strncmp(argv[i],"--algorithm",11) == 0)
       {
         if(!algo_opt.empty())
@@ -157,6 +168,14 @@ namespace Calc {
       }
     }
 #endif
+    if(!m_algo.factor_out.empty() || !m_algo.factor_in.empty())
+    {
+      if(m_algo.type != A_NumCppBlockedLU && m_algo.type != A_NumCppTiledLU &&
+         m_algo.type != A_NumCppTiledCholesky && m_algo.type != A_NumCppBlockedCholesky)
+        throw OptionsParsingError("options '--" FACTOR_OUT_OPT "' and '--" FACTOR_IN_OPT "' are supported by LU and Cholesky algorithms only");
+      if(!m_algo.factor_out.empty() && !m_algo.factor_in.empty())
+        throw OptionsParsingError("options '--" FACTOR_OUT_OPT "' and '--" FACTOR_IN_OPT "' cannot be used together");
+    }
     if(m_precision.type != numeric::P_Double)
     {
       std::cerr << "ignoring specified precision, only double one supported at the moment" << std::endl;
@@ -258,6 +277,12 @@ namespace Calc {
 #endif
     }
     m_algo.type = algo;
+#ifdef HAVE_BOOST
+    if(argMap.count(FACTOR_OUT_OPT) > 0)
+      m_algo.factor_out = argMap[FACTOR_OUT_OPT].as<string>();
+    if(argMap.count(FACTOR_IN_OPT) > 0)
+      m_algo.factor_in = argMap[FACTOR_IN_OPT].as<string>();
+#endif
     return true;
   }
 
@@ -385,6 +410,21 @@ namespace Calc {
   {
     //PRERUN:
     log().debug(Summary());
+    if(!m_algo.factor_in.empty())
+    {
+      //matrix was factored in some previous run, so only right hand sides are read
+      log().debug("reading right hand sides...");
+      Matrix<double> rhs(numeric::TMatrixStorage::RowMajor);
+      rhs.init(*m_pfIn);
+      log().fdebug("found %zu right hand sides of system of %zu linear equations", rhs.getColumnsNum(), rhs.getRowsNum());
+      log().debug(SysUtil::getMemStats());
+      log().debug("running main task...");
+      dense_linear_solve::perform_factored(*m_pAlgoParameters, rhs, log());
+      log().debug("writing solution vectors...");
+      rhs.writeToFile(*m_pfOut);
+      log().debug("have a nice day.");
+      return;
+    }
     //init system
     log().debug("reading augumented matrix...");
     m_pfIn->readNextLine_scan(1,"# %zu",&m_pAlgoParameters->system_size);
@@ -12,12 +12,21 @@
 #include "calcapp/infile.hpp"
 #include "calcapp/outfile.hpp"
 
+#define FACTOR_OUT_OPT "factor-out"
+#define FACTOR_IN_OPT "factor-in"
+
 namespace Calc {
 
 enum TAlgo {
   A_NumCppGauss=0,
   A_NumCppJordan,
   A_NumCppFullPivoting,
+  A_NumCppBlockedLU,
+  A_NumCppTiledLU,
+  A_NumCppTiledCholesky,
+  A_NumCppBlockedCholesky,
+  A_NumCppLDLT,
+  A_NumCppMixedLU,
   A_Undefined
 };
 
@@ -25,6 +34,12 @@ static const OptName<TAlgo> _algo_opt_names[] = {
   { "dumb libnumeric c++ variant of Gauss elimination without pivoting", "num-cpp-gauss-s", A_NumCppGauss },
   { "dumb libnumeric c++ variant of Gauss-Jordan elimination without pivoting", "num-cpp-jordan-s", A_NumCppJordan },
   { "dumb libnumeric c++ variant of Gauss elimination with full pivoting", "num-cpp-gauss-fp-s", A_NumCppFullPivoting },
+  { "libnumeric c++ variant of blocked LU factorization with partial pivoting", "num-cpp-lu-b", A_NumCppBlockedLU },
+  { "libnumeric c++ variant of tiled LU factorization with partial pivoting driven by task graph", "num-cpp-lu-t", A_NumCppTiledLU },
+  { "libnumeric c++ variant of tiled Cholesky factorization driven by task graph", "num-cpp-cholesky-t", A_NumCppTiledCholesky },
+  { "libnumeric c++ variant of blocked Cholesky factorization, lower triangle only", "num-cpp-cholesky-b", A_NumCppBlockedCholesky },
+  { "libnumeric c++ variant of Bunch-Kaufman LDL' factorization for symmetric indefinite systems, lower triangle only", "num-cpp-ldlt", A_NumCppLDLT },
+  { "libnumeric c++ variant of single precision LU factorization with iterative refinement to double precision", "num-cpp-lu-mixed", A_NumCppMixedLU },
   { nullptr, nullptr, A_Undefined }
 };
 
@@ -60,9 +75,14 @@ struct OutputOptions {
 
 struct AlgoOptions {
   TAlgo type;
+  //names of files(without an extension) to save factor of the matrix to or to read it from
+  std::string factor_out;
+  std::string factor_in;
 
   AlgoOptions():
     type(A_Undefined)
+    ,factor_out("")
+    ,factor_in("")
   {}
 };
 
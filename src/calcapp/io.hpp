@@ -25,6 +25,10 @@ enum TFileType : int {
     FT_InterpolationTableText,
     FT_ApproximationTableText,
     FT_FunctionTableText,
+    //sparse matrix collections
+    FT_MatrixMarket,
+    FT_HarwellBoeing,
+    FT_RutherfordBoeing,
     FT_Count
 };
 
@@ -37,6 +41,9 @@ static const char TFileExt[FT_Count][FILE_EXTENSION_WIDTH] =
     ,".dat"
     ,".dat"
     ,".dat"
+    ,".mtx"
+    ,".hb"
+    ,".rb"
 };
 
 #if CALC_DEFAULT_LINE_BUF_SIZE > 1024
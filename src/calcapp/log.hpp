@@ -74,6 +74,10 @@ public:
   inline void warning(const char * msg)              { log(L_WARNING, msg); }
   inline void warning(const std::string& msg)        { log(L_WARNING, msg); }
 
+  inline void fnote(const char * format, ...)       { va_list va; va_start(va, format); vflog(L_NOTE, format, va); va_end(va); }
+  inline void note(const char * msg)                 { log(L_NOTE, msg); }
+  inline void note(const std::string& msg)           { log(L_NOTE, msg); }
+
   inline void fdebug(const char * format, ...)      { va_list ap; va_start(ap, format); vflog(L_DEBUG, format, ap); va_end(ap); }
   inline void debug(const char * msg)                { log(L_DEBUG, msg);  }
   inline void debug(const std::string& msg)          { log(L_DEBUG, msg);  }
@@ -183,7 +183,7 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::preallocateTempo
 {
   void* buf = nullptr;
   m_lhs = reinterpret_cast<T*>(
-      numeric::aligned_malloc(sizeof(T)*(5*m_points_count), numeric::getCacheLineAlignment<T>(), &buf)
+      numeric::aligned_malloc(sizeof(T)*(3*m_points_count), numeric::getCacheLineAlignment<T>(), &buf)
       );
   m_lhs_buf.reset(buf);
   buf = nullptr;
@@ -193,7 +193,7 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::preallocateTempo
   m_rhs_buf.reset(buf);
   buf = nullptr;
   m_R = reinterpret_cast<T*>(
-      numeric::aligned_malloc(sizeof(T)*(3*m_points_count), numeric::getCacheLineAlignment<T>(), &buf)
+      numeric::aligned_malloc(sizeof(T)*(2*m_points_count), numeric::getCacheLineAlignment<T>(), &buf)
       );
   m_R_buf.reset(buf);
   buf = nullptr;
@@ -241,15 +241,15 @@ template<typename T> __FORCEINLINE inline
     q1 = T(1)/r1;
     q2 = T(1)/r3;
     q3 = T(1)/weights[i];
-    R[3*i] = r1;
-    R[3*i + 1] = r2*2;
-    R[3*i + 2] = r3;
+    //R is symmetric, so R(i,i-1) = r1 is kept in row i-1 only
+    R[2*i] = r2*2;
+    R[2*i + 1] = r3;
     Q[3*i] = q1*6;
     Q[3*i + 1] = -(q1 + q2)*6;
     Q[3*i + 2] = q2*6;
     WQ[3*i] = q1*q3*smoothing_k;
     WQ[3*i + 1] = -(q1 + q2)*q3*smoothing_k;
-    WQ[3*i + 2] = q1*q3*smoothing_k;
+    WQ[3*i + 2] = q2*q3*smoothing_k;
 }
 
 //compute approximant
@@ -305,10 +305,9 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::prepare_matrices
   }
   //fill last and first rows
   T tmp = m_points[m_points_count - 1] - m_points[m_points_count - 2];
-  m_R[3*m_points_count - 4] = T(0);
-  m_R[3*m_points_count - 3] = T(0);
-  m_R[3*m_points_count - 2] = tmp*2;
-  m_R[3*m_points_count - 1] = T(0);
+  m_R[2*m_points_count - 3] = T(0);
+  m_R[2*m_points_count - 2] = tmp*2;
+  m_R[2*m_points_count - 1] = T(0);
 //  m_Q[3*m_points_count - 4] = m_Q[3*m_points_count - 4];
   m_Q[3*m_points_count - 3] = T(0);
   m_Q[3*m_points_count - 2] = T(0);
@@ -318,10 +317,8 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::prepare_matrices
   m_WQ[3*m_points_count - 2] = T(0);
   m_WQ[3*m_points_count - 1] = T(0);
   tmp = m_points[1] - m_points[0];
-  m_R[0] = T(0);
-  m_R[1] = tmp*2;
-  m_R[2] = T(0);
-  m_R[3] = T(0);
+  m_R[0] = tmp*2;
+  m_R[1] = T(0);
   m_Q[0] = T(0);
   m_Q[1] = T(0);
   m_Q[2] = T(0);
@@ -335,10 +332,13 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::prepare_matrices
 template<typename T> void ApproximantCubicSmoothingSpline1d<T>::assemble_equations(numeric::TThreading threading_model)
 {
   prepare_matrices(threading_model);
-  //lhs R+6Q'*(1-p)/pWQ
-  numeric::dgbmm(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
+  //products are accumulated
+  memset(reinterpret_cast<void*>(m_lhs),0,sizeof(T)*3*m_points_count);
+  memset(reinterpret_cast<void*>(m_rhs),0,sizeof(T)*m_points_count);
+  //lhs R+6Q'*(1-p)/pWQ is symmetric, so only its diagonal and upper bands are computed
+  numeric::dsbmm(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No, numeric::TMatrixTranspose::No,
       m_Q, m_WQ, m_lhs, m_points_count, 1, threading_model);
-  numeric::banded_add(numeric::TMatrixStorage::RowMajor, m_lhs, m_R, m_points_count, 2, 1, threading_model);
+  numeric::symmetric_banded_add(numeric::TMatrixStorage::RowMajor, m_lhs, m_R, m_points_count, 2, 1, threading_model);
   //rhs 6Q'*y
   numeric::dgbmv(numeric::TMatrixStorage::RowMajor, numeric::TMatrixTranspose::No,
       m_Q, m_values, m_rhs, m_points_count, 1, T(1), threading_model);
@@ -347,7 +347,8 @@ template<typename T> void ApproximantCubicSmoothingSpline1d<T>::assemble_equatio
 template<typename T> void ApproximantCubicSmoothingSpline1d<T>::solve_equations(numeric::TThreading threading_model)
 {
   //solve for S2
-  numeric::thomas_solve(m_lhs, m_S2, m_rhs, m_points_count, 2, /* reuse_storage = */ true);
+  if(!numeric::symmetric_banded_solve(m_lhs, m_S2, m_rhs, m_points_count, 2, /* reuse_storage = */ true, threading_model))
+    throw ParameterError("Matrix of smoothing spline equations is singular, check weights and points");
   //S0 = y
   memcpy(reinterpret_cast<void*>(m_S0), reinterpret_cast<const void*>(m_values), m_points_count*sizeof(T));
   //S0 += -(1-p)/pWQ*S2
@@ -0,0 +1,142 @@
+#pragma once
+#ifndef _DENSE_FACTOR_HPP
+#define _DENSE_FACTOR_HPP
+#include "config.h"
+
+#include <memory>
+#include <vector>
+#include <limits>
+
+#include "numeric/blas.hpp"
+#include "numeric/lapack.hpp"
+
+#include "calcapp/infile.hpp"
+#include "calcapp/outfile.hpp"
+#include "calcapp/exception.hpp"
+#include "calcapp/math/matrix.hpp"
+
+//factor objects for factor-once/solve-many usage: dense matrix is factored once, then factor is used to solve
+//systems for any number of right hand sides(one by one or as a block by trsm based kernels) and can be written
+//to text file and read back to skip factorization in later runs.
+//factor file starts with tag line("# lu n" or "# cholesky n"), LU factor is followed by line of pivots,
+//then comes factored matrix in .dat format
+
+using std::size_t;
+
+namespace Calc
+{
+
+template<typename T> class DenseFactor
+{
+protected:
+  DenseFactor() {}
+  virtual ~DenseFactor() {}
+
+protected:
+  std::unique_ptr< Matrix<T> > m_factor;
+
+public:
+  inline bool isFactored() const { return m_factor != nullptr; }
+  inline size_t getSize() const { return ( isFactored() ? m_factor->getRowsNum() : 0 ); }
+  inline const Matrix<T>& getFactor() const { return *m_factor; }
+
+  //solve system for single right hand side, x and rhs may be the same array
+  virtual void solve(T* const x, const T* const rhs) const = 0;
+  //solve systems for nrhs right hand sides at once, b is getSize() x nrhs row major matrix with leading dimension ldb,
+  //every column of it is replaced by the solution
+  virtual void solve(T* const b, const size_t ldb, const size_t nrhs,
+      const numeric::TThreading threading_model = numeric::T_Serial) const = 0;
+  inline void solve(Matrix<T>& b, const numeric::TThreading threading_model = numeric::T_Serial) const
+  {
+    if(!b.isRowMajor() || b.getRowsNum() != getSize())
+      throw ParameterError("Right hand sides should be row major matrix with the same number of rows as factored one");
+    solve(b.getDataPtr(), b.m_stride, b.getColumnsNum(), threading_model);
+  }
+
+  //data IO
+  virtual void readFromFile(InFileText& f) = 0;
+  virtual void writeToFile(OutFileText& f, const int print_precision = std::numeric_limits<T>::max_digits10) const = 0;
+
+protected:
+  //copy sz x sz row major matrix with leading dimension lda into factor storage
+  void CopyMatrix(const T* const a, const size_t lda, const size_t sz);
+  //tag line of factor file
+  static size_t ParseTagDat(InFileText& f, const char * tag);
+  static void WriteTagDat(OutFileText& f, const char * tag, const size_t sz);
+  void ReadMatrixDat(InFileText& f, const size_t sz);
+  void WriteMatrixDat(OutFileText& f, const int print_precision) const;
+
+private:
+  // no copying and copy assignment allowed
+  DenseFactor(const DenseFactor&) = delete;
+  DenseFactor(const DenseFactor&&) = delete;
+  DenseFactor& operator= (const DenseFactor&) = delete;
+};
+
+//LU factorization with partial pivoting, see numeric::dense_lu_factor
+template<typename T> class LUFactor final : public DenseFactor<T>
+{
+private:
+  using DenseFactor<T>::m_factor;
+  std::vector<size_t> m_pivots;
+
+public:
+  LUFactor() : DenseFactor<T>() {}
+  ~LUFactor() {}
+
+  using DenseFactor<T>::isFactored;
+  using DenseFactor<T>::getSize;
+  using DenseFactor<T>::solve;
+
+  //factor copy of sz x sz row major matrix a with leading dimension lda by blocked or tiled LU factorization.
+  //returns false if the matrix is singular, factor is dropped in this case
+  bool factor(const T* const a, const size_t lda, const size_t sz,
+      const numeric::TThreading threading_model = numeric::T_Serial, const bool tiled = false);
+  inline const std::vector<size_t>& getPivots() const { return m_pivots; }
+
+  void solve(T* const x, const T* const rhs) const override;
+  void solve(T* const b, const size_t ldb, const size_t nrhs,
+      const numeric::TThreading threading_model = numeric::T_Serial) const override;
+
+  //data IO
+  void readFromFile(InFileText& f) override;
+  void writeToFile(OutFileText& f, const int print_precision = std::numeric_limits<T>::max_digits10) const override;
+};
+
+//Cholesky factorization of symmetric positive definite matrix, see numeric::dense_cholesky_factor.
+//only lower triangle of the factor is meaningful
+template<typename T> class CholeskyFactor final : public DenseFactor<T>
+{
+private:
+  using DenseFactor<T>::m_factor;
+
+public:
+  CholeskyFactor() : DenseFactor<T>() {}
+  ~CholeskyFactor() {}
+
+  using DenseFactor<T>::isFactored;
+  using DenseFactor<T>::getSize;
+  using DenseFactor<T>::solve;
+
+  //factor copy of sz x sz row major matrix a with leading dimension lda by blocked or tiled Cholesky factorization,
+  //only its lower triangle is referenced. returns false if the matrix is not positive definite, factor is dropped in this case
+  //and index of non-positive pivot is stored to failed_pivot unless it is null
+  bool factor(const T* const a, const size_t lda, const size_t sz,
+      const numeric::TThreading threading_model = numeric::T_Serial, const bool tiled = false,
+      size_t* const failed_pivot = nullptr);
+
+  void solve(T* const x, const T* const rhs) const override;
+  void solve(T* const b, const size_t ldb, const size_t nrhs,
+      const numeric::TThreading threading_model = numeric::T_Serial) const override;
+
+  //data IO
+  void readFromFile(InFileText& f) override;
+  void writeToFile(OutFileText& f, const int print_precision = std::numeric_limits<T>::max_digits10) const override;
+};
+
+}
+
+//implementation
+#include "calcapp/math/dense_factor_impl.hpp"
+
+#endif /* _DENSE_FACTOR_HPP */
@@ -0,0 +1,178 @@
+#include "calcapp/math/dense_factor.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace Calc
+{
+
+template<typename T> void DenseFactor<T>::CopyMatrix(const T* const a, const size_t lda, const size_t sz)
+{
+  m_factor.reset(new Matrix<T>(sz, sz, numeric::TMatrixStorage::RowMajor));
+  m_factor->init(false, true);
+  T* const data = m_factor->getDataPtr();
+  const size_t stride = m_factor->m_stride;
+  for (size_t i = 0; i < sz; ++i)
+    std::copy(a + i*lda, a + i*lda + sz, data + i*stride);
+}
+
+template<typename T> size_t DenseFactor<T>::ParseTagDat(InFileText& f, const char * tag)
+{
+  f.readNextLine();
+  const std::string prefix = std::string("# ").append(tag).append(" ");
+  size_t sz = 0;
+  if( !f.currentLineStartsWith(prefix.c_str()) || std::sscanf(f.line() + prefix.size(), "%zu", &sz) != 1 )
+  {
+    const std::string err = std::string("Expected factor file tag line '").append(prefix).append("<size>'");
+    throw FileFormatParsingError(err.c_str(),f.fileType(),f.fileName().c_str(),f.lineNum());
+  }
+  return sz;
+}
+
+template<typename T> void DenseFactor<T>::WriteTagDat(OutFileText& f, const char * tag, const size_t sz)
+{
+  f.printf("# %s %zu", tag, sz);
+  f.println();
+}
+
+template<typename T> void DenseFactor<T>::ReadMatrixDat(InFileText& f, const size_t sz)
+{
+  std::unique_ptr< Matrix<T> > m( new Matrix<T>(numeric::TMatrixStorage::RowMajor) );
+  m->init(f, true, false);
+  if( m->getRowsNum() != sz || m->getColumnsNum() != sz )
+    throw FileFormatValueBoundsError("Mismatched size of factored matrix in file",f.fileType(),f.fileName().c_str(),f.lineNum());
+  m_factor = std::move(m);
+}
+
+template<typename T> void DenseFactor<T>::WriteMatrixDat(OutFileText& f, const int print_precision) const
+{
+  m_factor->writeToFile(f, false, print_precision);
+}
+
+//LU factor
+template<typename T> bool LUFactor<T>::factor(const T* const a, const size_t lda, const size_t sz,
+    const numeric::TThreading threading_model, const bool tiled)
+{
+  DenseFactor<T>::CopyMatrix(a, lda, sz);
+  m_pivots.assign(sz, 0);
+  const bool ok = ( tiled ?
+      numeric::tiled_lu_factor<T>(m_factor->getDataPtr(), m_factor->m_stride, m_pivots.data(), sz, 0, threading_model) :
+      numeric::dense_lu_factor<T>(m_factor->getDataPtr(), m_factor->m_stride, m_pivots.data(), sz, 0, threading_model) );
+  if(!ok)
+  {
+    m_factor.reset();
+    m_pivots.clear();
+  }
+  return ok;
+}
+
+template<typename T> void LUFactor<T>::solve(T* const x, const T* const rhs) const
+{
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+  numeric::dense_lu_solve<T>(m_factor->getDataPtr(), m_factor->m_stride, m_pivots.data(), x, rhs, getSize());
+}
+
+template<typename T> void LUFactor<T>::solve(T* const b, const size_t ldb, const size_t nrhs,
+    const numeric::TThreading threading_model) const
+{
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+  numeric::dense_lu_solve_multiple<T>(m_factor->getDataPtr(), m_factor->m_stride, m_pivots.data(),
+      b, ldb, getSize(), nrhs, threading_model);
+}
+
+template<typename T> void LUFactor<T>::readFromFile(InFileText& f)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  const size_t sz = DenseFactor<T>::ParseTagDat(f, "lu");
+  //pivots are read as signed values to catch negative ones
+  std::unique_ptr<long long[]> tmp( new long long[std::max(sz, size_t(1))] );
+  f.readNextLine_scanNumArray<long long>(int(sz), int(sz), tmp.get());
+  std::vector<size_t> pivots(sz);
+  for (size_t k = 0; k < sz; ++k)
+  {
+    //row k can be swapped only with one of rows below it
+    if( tmp[k] < 0 || size_t(tmp[k]) < k || size_t(tmp[k]) >= sz )
+      throw FileFormatValueBoundsError("Pivot index out of bounds",f.fileType(),f.fileName().c_str(),f.lineNum());
+    pivots[k] = size_t(tmp[k]);
+  }
+  DenseFactor<T>::ReadMatrixDat(f, sz);
+  m_pivots.swap(pivots);
+}
+
+template<typename T> void LUFactor<T>::writeToFile(OutFileText& f, const int print_precision) const
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+
+  DenseFactor<T>::WriteTagDat(f, "lu", getSize());
+  for (size_t k = 0; k < m_pivots.size(); ++k)
+    f.printf("%zu ", m_pivots[k]);
+  f.println();
+  DenseFactor<T>::WriteMatrixDat(f, print_precision);
+}
+
+//Cholesky factor
+template<typename T> bool CholeskyFactor<T>::factor(const T* const a, const size_t lda, const size_t sz,
+    const numeric::TThreading threading_model, const bool tiled, size_t* const failed_pivot)
+{
+  DenseFactor<T>::CopyMatrix(a, lda, sz);
+  const bool ok = ( tiled ?
+      numeric::tiled_cholesky_factor<T>(m_factor->getDataPtr(), m_factor->m_stride, sz, 0, threading_model, failed_pivot) :
+      numeric::dense_cholesky_factor<T>(m_factor->getDataPtr(), m_factor->m_stride, sz, 0, threading_model, failed_pivot) );
+  if(!ok)
+  {
+    m_factor.reset();
+    return false;
+  }
+  //upper triangle is left as it was in the matrix, zero it to keep factor file clean
+  T* const data = m_factor->getDataPtr();
+  const size_t stride = m_factor->m_stride;
+  for (size_t i = 0; i < sz; ++i)
+    std::fill(data + i*stride + i + 1, data + i*stride + sz, T(0));
+  return true;
+}
+
+template<typename T> void CholeskyFactor<T>::solve(T* const x, const T* const rhs) const
+{
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+  numeric::dense_cholesky_solve<T>(m_factor->getDataPtr(), m_factor->m_stride, x, rhs, getSize());
+}
+
+template<typename T> void CholeskyFactor<T>::solve(T* const b, const size_t ldb, const size_t nrhs,
+    const numeric::TThreading threading_model) const
+{
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+  numeric::dense_cholesky_solve_multiple<T>(m_factor->getDataPtr(), m_factor->m_stride,
+      b, ldb, getSize(), nrhs, threading_model);
+}
+
+template<typename T> void CholeskyFactor<T>::readFromFile(InFileText& f)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  const size_t sz = DenseFactor<T>::ParseTagDat(f, "cholesky");
+  DenseFactor<T>::ReadMatrixDat(f, sz);
+}
+
+template<typename T> void CholeskyFactor<T>::writeToFile(OutFileText& f, const int print_precision) const
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+  if(!isFactored())
+    throw ParameterError("Matrix is not factored yet");
+
+  DenseFactor<T>::WriteTagDat(f, "cholesky", getSize());
+  DenseFactor<T>::WriteMatrixDat(f, print_precision);
+}
+
+}
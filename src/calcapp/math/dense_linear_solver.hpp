@@ -171,6 +171,136 @@ namespace Calc
       }
     }
 
+    //warn about small pivots of LU factorization computed in place of A and solve the system
+    template<typename T> void __lu_factored_solve(const size_t sz,
+        const T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        const size_t * const __RESTRICT pivots,
+        Logger& log)
+    {
+      const T small_value = T(1.e-5); //TODO: type-independent value
+      const size_t stride = sz;
+      size_t k_min = 0;
+      for(size_t k = 1; k < sz; k++)
+        if(std::abs(A[k*stride + k]) < std::abs(A[k_min*stride + k_min]))
+          k_min = k;
+      if(sz > 0 && std::abs(A[k_min*stride + k_min]) < small_value)
+        log.fwarning("Despite partial pivoting, pivot element U(%zu,%zu) is rather small, %g",
+            k_min,k_min,numeric::toDouble(std::abs(A[k_min*stride + k_min])));
+      numeric::dense_lu_solve<T>(A,stride,pivots,x,b,sz);
+    }
+
+    //blocked right-looking LU factorization with partial pivoting, A is replaced by its factors in place,
+    //see numeric::dense_lu_factor. returns false if the matrix is singular
+    template<typename T> bool blocked_lu_impl(const size_t sz,
+        T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        size_t * const __RESTRICT pivots,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      if(!numeric::dense_lu_factor<T>(A,sz,pivots,sz,0,threading_model))
+      {
+        log.error("zero pivot element found, the matrix of the system is singular");
+        return false;
+      }
+      __lu_factored_solve<T>(sz,A,b,x,pivots,log);
+      return true;
+    }
+
+    //tiled LU factorization with partial pivoting driven by task dependency graph, A is replaced by its factors in place,
+    //see numeric::tiled_lu_factor. returns false if the matrix is singular
+    template<typename T> bool tiled_lu_impl(const size_t sz,
+        T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        size_t * const __RESTRICT pivots,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      if(!numeric::tiled_lu_factor<T>(A,sz,pivots,sz,0,threading_model))
+      {
+        log.error("zero pivot element found, the matrix of the system is singular");
+        return false;
+      }
+      __lu_factored_solve<T>(sz,A,b,x,pivots,log);
+      return true;
+    }
+
+    inline void __cholesky_failed(Logger& log, const size_t failed_pivot)
+    {
+      log.ferror("non-positive pivot element found at L(%zu,%zu), the matrix of the system is not symmetric positive definite",
+          failed_pivot,failed_pivot);
+    }
+
+    //blocked Cholesky factorization, lower triangle of A is replaced by its factor in place, upper one is never referenced,
+    //see numeric::dense_cholesky_factor. stops at the first non-positive pivot and returns false
+    template<typename T> bool blocked_cholesky_impl(const size_t sz,
+        T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      size_t failed_pivot = 0;
+      if(!numeric::dense_cholesky_factor<T>(A,sz,sz,0,threading_model,&failed_pivot))
+      {
+        __cholesky_failed(log,failed_pivot);
+        return false;
+      }
+      numeric::dense_cholesky_solve<T>(A,sz,x,b,sz);
+      return true;
+    }
+
+    //tiled Cholesky factorization driven by task dependency graph, lower triangle of A is replaced by its factor in place,
+    //see numeric::tiled_cholesky_factor. returns false if the matrix is not positive definite
+    template<typename T> bool tiled_cholesky_impl(const size_t sz,
+        T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      size_t failed_pivot = 0;
+      if(!numeric::tiled_cholesky_factor<T>(A,sz,sz,0,threading_model,&failed_pivot))
+      {
+        __cholesky_failed(log,failed_pivot);
+        return false;
+      }
+      numeric::dense_cholesky_solve<T>(A,sz,x,b,sz);
+      return true;
+    }
+
+    //Bunch-Kaufman LDL' factorization of symmetric indefinite matrix, lower triangle of A is replaced by its factor in place,
+    //upper one is never referenced, see numeric::dense_ldlt_factor. returns false if the matrix is singular
+    template<typename T> bool ldlt_impl(const size_t sz,
+        T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        std::ptrdiff_t * const __RESTRICT pivots,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      size_t failed_pivot = 0;
+      if(!numeric::dense_ldlt_factor<T>(A,sz,pivots,sz,threading_model,&failed_pivot))
+      {
+        log.ferror("zero pivot element found in column %zu, the matrix of the system is singular",failed_pivot);
+        return false;
+      }
+      numeric::dense_ldlt_solve<T>(A,sz,pivots,x,b,sz);
+      return true;
+    }
+
+    //LU factorization in low precision TLow refined to precision T with residuals accumulated in precision TResidual,
+    //A is left intact, see numeric::refined_lu_solve. returns false if the matrix is singular
+    template<typename TLow, typename T, typename TResidual = T> bool mixed_lu_impl(const size_t sz,
+        const T* const __RESTRICT A, const T* const __RESTRICT b, T* const __RESTRICT x,
+        Logger& log,
+        const numeric::TThreading threading_model = numeric::T_Serial)
+    {
+      int iterations = 0;
+      if(!numeric::refined_lu_solve<TLow,T,TResidual>(A,sz,x,b,sz,30,threading_model,&iterations))
+      {
+        log.error("zero pivot element found, the matrix of the system is singular");
+        return false;
+      }
+      if(iterations < 0)
+        log.warning("iterative refinement hasn't converged, the system was solved by full precision LU factorization");
+      else
+        log.fdebug("iterative refinement converged in %d steps",iterations);
+      return true;
+    }
+
     //handmade iterative solvers from gauss-seidel family
 
     template<typename T> bool jacobi_impl(const size_t sz,
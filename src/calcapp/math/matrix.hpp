@@ -9,8 +9,10 @@
 #include <cstring>
 #include <algorithm>
 #include <valarray>
+#include <vector>
 
 #include "numeric/blas.hpp"
+#include "numeric/lapack.hpp"
 #include "numeric/cache.hpp"
 #include "numeric/real.hpp"
 
@@ -18,6 +20,7 @@
 #include "calcapp/outfile.hpp"
 #include "calcapp/exception.hpp"
 #include "calcapp/log.hpp"
+#include "calcapp/math/matrix_collections.hpp"
 
 #ifdef HAVE_BOOST_UBLAS
 # include <boost/numeric/ublas/matrix.hpp>
@@ -50,6 +53,7 @@ enum class TMatrixType {
 enum class TMatrixFlavour {
   Dense,
   Banded,
+  SymmetricBanded,
   Hessenberg,
   Triangular,
   Sparse
@@ -77,6 +81,7 @@ public:
   virtual ~MatrixBase() {}
 
   inline bool isRowMajor() const { return (m_storage == numeric::TMatrixStorage::RowMajor); }
+  inline bool isTiled() const { return (m_storage == numeric::TMatrixStorage::Tiled); }
   inline size_t getSize() const { return m_nrows*m_ncolumns; }
   inline size_t getRowsNum() const { return m_nrows; }
   inline size_t getColumnsNum() const { return m_ncolumns; }
@@ -118,7 +123,7 @@ protected:
     const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
       : MatrixBase(nrows, ncolumns, storage)
       , m_data(nullptr)
-      , m_stride( isRowMajor() ? ncolumns : nrows )
+      , m_stride( isRowMajor() ? ncolumns : ( isTiled() ? numeric::tiled_tile_size() : nrows ) )
   {}
 
 protected:
@@ -134,10 +139,13 @@ public:
   virtual ~ArrayBasedDenseMatrix() {}
 
   inline TMatrixFlavour getFlavour() const override { return TMatrixFlavour::Dense; }
-  inline size_t getStoredSize() const override { return getSize(); }
+  inline size_t getStoredSize() const override { return ( isTiled() ? numeric::tiled_stored_size(m_nrows,m_ncolumns) : getSize() ); }
 
   // data access
-  inline size_t index(size_t i, size_t j) const override { return ( isRowMajor() ? i*m_ncolumns+j : j*m_nrows+i ); }
+  inline size_t index(size_t i, size_t j) const override
+  {
+    return ( isRowMajor() ? i*m_ncolumns+j : ( isTiled() ? numeric::tiled_index(m_nrows,m_ncolumns,i,j) : j*m_nrows+i ) );
+  }
   inline T* getDataPtr() const { return m_data; }
   inline T& get(size_t i,size_t j)  { return m_data[index(i,j)];  }
   inline const T get(size_t i, size_t j) const  { return m_data[index(i,j)];  }
@@ -158,6 +166,11 @@ public:
 protected:
   static void ParseHeaderDat(InFileText& f, size_t& rows, size_t& columns);
   void WriteHeaderDat(OutFileText& f, const size_t rows, const size_t columns);
+  //tiled storage is read and written row by row through temporary buffer
+  void ReadTiledDat(InFileText& f, const size_t f_nrows, const size_t f_ncolumns, const bool transpose);
+  void WriteTiledDat(OutFileText& f, const size_t f_nrows, const size_t f_ncolumns, const bool transpose, const int print_precision);
+  //matrices from MatrixMarket and Harwell-Boeing collections are scattered into zero initialized storage
+  void ReadCollection(InFileText& f, const CollectionMatrixHeader& h, const bool transpose);
 };
 
 template<typename T> class Matrix final : public ArrayBasedDenseMatrix<T>
@@ -479,6 +492,8 @@ protected:
   void WriteHeaderDat(OutFileText& f, const size_t rows, const size_t columns, const size_t upper_band, const size_t lower_band);
 };
 
+template<typename T> class CSRMatrix;
+
 template<typename T> class CDSBandedMatrix final : public ArrayBasedCDSBandedMatrix<T>
 {
 private:
@@ -498,6 +513,10 @@ public:
 
   inline TMatrixType getBackendType() const override { return TMatrixType::Array; }
 
+  //convert from square sparse matrix with rows and columns reordered by reverse Cuthill-McKee to minimize bandwidth,
+  //permutation[i] is the row(and column) of csr moved to position i. without reordering permutation is identity
+  void assignCSR(const CSRMatrix<T>& csr, std::vector<size_t>& permutation, const bool reorder = true);
+
 protected:
   void ensureAllocated() override;
 
@@ -540,12 +559,227 @@ private:
   ValArrayCDSBandedMatrix& operator= (const ValArrayCDSBandedMatrix&) = delete;
 };
 
+//symmetric banded matrix in symmetric CDS format: row i keeps elements (i,i+p), p in [0,band], i.e. diagonal and upper
+//bands only, so it takes (band+1)*size elements instead of (2*band+1)*size. the same array is column major storage of
+//lower bands, so storage order doesn't change layout. files are in the same format as for other banded matrices
+template<typename T> class SymmetricCDSBandedMatrix final : public ArrayBasedCDSBandedMatrix<T>
+{
+private:
+  // smart pointer is used to correctly deallocate memory obtained from aligned_alloc
+  numeric::unique_aligned_buf_ptr m_buf;
+
+public:
+  using MatrixBase::m_nrows;
+  using MatrixBase::m_ncolumns;
+  using ArrayBasedCDSBandedMatrix<T>::m_upper_band;
+  using ArrayBasedCDSBandedMatrix<T>::m_lower_band;
+
+public:
+  SymmetricCDSBandedMatrix(const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
+    : ArrayBasedCDSBandedMatrix<T>(storage)
+  {}
+  SymmetricCDSBandedMatrix(const size_t sz, const size_t band,
+    const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
+      : ArrayBasedCDSBandedMatrix<T>(sz, sz, band, band, storage)
+  {}
+  ~SymmetricCDSBandedMatrix();
+
+  void init(InFileText& f, const bool readData = true, const bool transpose = false) override;
+
+  inline TMatrixType getBackendType() const override { return TMatrixType::Array; }
+  inline TMatrixFlavour getFlavour() const override { return TMatrixFlavour::SymmetricBanded; }
+  inline size_t getStoredSize() const override { return (m_upper_band+1)*m_nrows; }
+  inline size_t getBand() const { return m_upper_band; }
+
+  // data access, (i,j) and (j,i) share the same element
+  inline size_t index(size_t i, size_t j) const override
+  {
+    return ( j < i ? j*(m_upper_band+1)+i-j : i*(m_upper_band+1)+j-i );
+  }
+
+  //data IO, symmetric matrix is its own transpose
+  void readFromFile(InFileText& f, const bool transpose = false) override;
+  void writeToFile(OutFileText& f, const bool transpose = false, const int print_precision = 6) override;
+
+protected:
+  void ensureAllocated() override;
+  //rows are read in CDS format, lower bands are checked against already read upper ones
+  void ReadRowsDat(InFileText& f);
+
+private:
+  // no copying and copy assignment allowed
+  SymmetricCDSBandedMatrix(const SymmetricCDSBandedMatrix&) = delete;
+  SymmetricCDSBandedMatrix(const SymmetricCDSBandedMatrix&&) = delete;
+  SymmetricCDSBandedMatrix& operator= (const SymmetricCDSBandedMatrix&) = delete;
+};
+
+//sparse matrix in compressed sparse row format, values are kept in data buffer of dense matrix,
+//row i has nonzeros getDataPtr()[row_ptr[i]..row_ptr[i+1]) in columns column_indices[row_ptr[i]..row_ptr[i+1])
+//with column indices sorted within every row
+template<typename T> class CSRMatrix final : public ArrayBasedDenseMatrix<T>
+{
+private:
+  // smart pointers are used to correctly deallocate memory obtained from aligned_alloc
+  numeric::unique_aligned_buf_ptr m_buf;
+  numeric::unique_aligned_buf_ptr m_row_ptr_buf;
+  numeric::unique_aligned_buf_ptr m_column_indices_buf;
+  size_t* m_row_ptr;
+  size_t* m_column_indices;
+  //number of elements data and column indices buffers have room for
+  size_t m_capacity;
+  //number of stored elements, m_row_ptr[m_nrows] once structure is filled in
+  size_t m_nnz;
+
+public:
+  using MatrixBase::m_nrows;
+  using MatrixBase::m_ncolumns;
+  using ArrayBasedDenseMatrix<T>::getDataPtr;
+
+public:
+  CSRMatrix(const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
+    : ArrayBasedDenseMatrix<T>(storage)
+    , m_row_ptr(nullptr)
+    , m_column_indices(nullptr)
+    , m_capacity(0)
+    , m_nnz(0)
+  {}
+  //empty matrix with room for nnz elements, which is used by assignTriplets and file reading if it's enough
+  CSRMatrix(const size_t nrows, const size_t ncolumns, const size_t nnz,
+    const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
+      : ArrayBasedDenseMatrix<T>(nrows, ncolumns, storage)
+      , m_row_ptr(nullptr)
+      , m_column_indices(nullptr)
+      , m_capacity(nnz)
+      , m_nnz(0)
+  {}
+  ~CSRMatrix();
+
+  //values and structure are reset together, so reset matrix has no stored elements
+  void init(const bool reset = true, const bool initObjects = true) override;
+  void init(InFileText& f, const bool readData = true, const bool transpose = false) override;
+
+  inline TMatrixType getBackendType() const override { return TMatrixType::Array; }
+  inline TMatrixFlavour getFlavour() const override { return TMatrixFlavour::Sparse; }
+  inline size_t getStoredSize() const override { return m_nnz; }
+  inline size_t getNonZerosNum() const { return m_nnz; }
+  inline size_t* getRowPtr() const { return m_row_ptr; }
+  inline size_t* getColumnIndices() const { return m_column_indices; }
+
+  // data access, only stored elements can be accessed
+  size_t index(size_t i, size_t j) const override;
+
+  //replace contents with elements given in arbitrary order, duplicates are summed up
+  void assignTriplets(const size_t nrows, const size_t ncolumns,
+    const std::vector<size_t>& rows, const std::vector<size_t>& columns, const std::vector<T>& values);
+
+  //data IO, sparse matrix is written to dense .dat format and read from either it or
+  //MatrixMarket and Harwell-Boeing collection formats
+  void readFromFile(InFileText& f, const bool transpose = false) override;
+  void writeToFile(OutFileText& f, const bool transpose = false, const int print_precision = 6) override;
+
+protected:
+  void ensureAllocated() override;
+
+private:
+  void destroyObjects();
+  void readDat(InFileText& f, const size_t f_nrows, const size_t f_ncolumns, const bool transpose);
+  void readCollection(InFileText& f, const CollectionMatrixHeader& h, const bool transpose);
+  void readMatrixMarket(InFileText& f, const CollectionMatrixHeader& h, const bool transpose);
+  void readHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, const bool transpose);
+  //drop old contents and make room for nnz elements, data and column indices buffers are kept if they are large enough
+  void reallocate(const size_t nrows, const size_t ncolumns, const size_t nnz);
+  //sort column indices within rows and sum up duplicates
+  void normalizeRows();
+  // no copying and copy assignment allowed
+  CSRMatrix(const CSRMatrix&) = delete;
+  CSRMatrix(const CSRMatrix&&) = delete;
+  CSRMatrix& operator= (const CSRMatrix&) = delete;
+};
+
+//sparse matrix in SELL-C-sigma(sliced ELLPACK) format, see M. Kreutzer et al, "A unified sparse matrix data format
+//for efficient general sparse matrix-vector multiplication on modern processors with wide SIMD units", 2014.
+//rows are sorted by length within windows of sigma rows, every chunk of C sorted rows is padded to its longest row
+//and stored column by column, so chunk height matched to SIMD width makes product vectorizable for irregular rows
+template<typename T> class SELLMatrix final : public ArrayBasedDenseMatrix<T>
+{
+private:
+  // smart pointers are used to correctly deallocate memory obtained from aligned_alloc
+  numeric::unique_aligned_buf_ptr m_buf;
+  numeric::unique_aligned_buf_ptr m_chunk_ptr_buf;
+  numeric::unique_aligned_buf_ptr m_column_indices_buf;
+  numeric::unique_aligned_buf_ptr m_permutation_buf;
+  numeric::unique_aligned_buf_ptr m_row_lengths_buf;
+  size_t* m_chunk_ptr;
+  size_t* m_column_indices;
+  size_t* m_permutation;
+  //number of stored elements of every sorted row, the rest of its slice is padding
+  size_t* m_row_lengths;
+  size_t m_chunk_height;
+  size_t m_sigma;
+  //number of stored elements, padding included
+  size_t m_stored;
+
+public:
+  using MatrixBase::m_nrows;
+  using MatrixBase::m_ncolumns;
+  using ArrayBasedDenseMatrix<T>::getDataPtr;
+
+public:
+  SELLMatrix(const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor )
+    : ArrayBasedDenseMatrix<T>(storage)
+    , m_chunk_ptr(nullptr)
+    , m_column_indices(nullptr)
+    , m_permutation(nullptr)
+    , m_row_lengths(nullptr)
+    , m_chunk_height(numeric::sell_chunk_height<T>())
+    , m_sigma(0)
+    , m_stored(0)
+  {}
+  ~SELLMatrix();
+
+  void init(const bool reset = true, const bool initObjects = true) override;
+  void init(InFileText& f, const bool readData = true, const bool transpose = false) override;
+
+  inline TMatrixType getBackendType() const override { return TMatrixType::Array; }
+  inline TMatrixFlavour getFlavour() const override { return TMatrixFlavour::Sparse; }
+  inline size_t getStoredSize() const override { return m_stored; }
+  inline size_t getChunkHeight() const { return m_chunk_height; }
+  inline size_t getSigma() const { return m_sigma; }
+  inline size_t getChunksNum() const { return (m_nrows + m_chunk_height - 1) / m_chunk_height; }
+  inline size_t* getChunkPtr() const { return m_chunk_ptr; }
+  inline size_t* getColumnIndices() const { return m_column_indices; }
+  inline size_t* getPermutation() const { return m_permutation; }
+  inline size_t* getRowLengths() const { return m_row_lengths; }
+
+  // data access, only stored elements can be accessed
+  size_t index(size_t i, size_t j) const override;
+
+  //convert from CSR, chunk height 0 means the one of the fastest SpMV kernel, sigma 0 means 32 chunks
+  void assignCSR(const CSRMatrix<T>& csr, const size_t chunk_height = 0, const size_t sigma = 0);
+
+  //data IO through CSR
+  void readFromFile(InFileText& f, const bool transpose = false) override;
+  void writeToFile(OutFileText& f, const bool transpose = false, const int print_precision = 6) override;
+
+protected:
+  void ensureAllocated() override;
+
+private:
+  void destroyObjects();
+  // no copying and copy assignment allowed
+  SELLMatrix(const SELLMatrix&) = delete;
+  SELLMatrix(const SELLMatrix&&) = delete;
+  SELLMatrix& operator= (const SELLMatrix&) = delete;
+};
+
 
 //helper functions to create matrices with corresponting type
 inline MatrixBase* NewMatrix(const numeric::TPrecision p, const size_t nrows, const size_t ncolumns,
   const bool reset = true, const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor,
   const TMatrixType type = TMatrixType::Array, const TMatrixFlavour flavour = TMatrixFlavour::Dense,
   const size_t upper_band = 0, const size_t lower_band = 0);
+//empty sparse matrix with room for nnz nonzeros
+inline MatrixBase* NewSparseMatrix(const numeric::TPrecision p, const size_t nrows, const size_t ncolumns, const size_t nnz);
 inline MatrixBase* NewMatrix(const numeric::TPrecision p, InFileText* pf, const bool readData = true,
   const bool transpose = false, const numeric::TMatrixStorage storage = numeric::TMatrixStorage::RowMajor,
   const TMatrixType type = TMatrixType::Array, const TMatrixFlavour flavour = TMatrixFlavour::Dense);
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef _MATRIX_COLLECTIONS_HPP
+#define _MATRIX_COLLECTIONS_HPP
+#include "config.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include "calcapp/infile.hpp"
+#include "calcapp/io.hpp"
+#include "calcapp/exception.hpp"
+
+//readers for matrices from well-known collections:
+//MatrixMarket(.mtx, see http://math.nist.gov/MatrixMarket/formats.html) and
+//Harwell-Boeing/Rutherford-Boeing(.hb/.rb, see I. Duff et al, "The Rutherford-Boeing sparse matrix collection", 1997).
+//files are parsed in a single streaming pass, entries are handed over to callbacks with zero based indices
+
+namespace Calc
+{
+
+enum class TCollectionField {
+  Real,
+  Integer,
+  Complex,
+  Pattern
+};
+
+enum class TCollectionSymmetry {
+  General,
+  Symmetric,
+  SkewSymmetric,
+  Hermitian
+};
+
+//fixed width fields of fortran edit descriptors like (16I5) or (1P,4E20.12)
+struct FortranFormat {
+  size_t m_per_line;
+  size_t m_width;
+};
+
+struct CollectionMatrixHeader {
+  size_t m_nrows;
+  size_t m_ncolumns;
+  //number of entries stored in file
+  size_t m_entries;
+  //matrixmarket array format is dense column major, everything else is sparse
+  bool m_coordinate;
+  TCollectionField m_field;
+  TCollectionSymmetry m_symmetry;
+  //harwell-boeing only
+  FortranFormat m_ptr_fmt;
+  FortranFormat m_ind_fmt;
+  FortranFormat m_val_fmt;
+
+  //upper bound of number of entries with symmetric counterparts expanded
+  inline size_t maxEntries() const { return ( m_symmetry == TCollectionSymmetry::General ? m_entries : 2*m_entries ); }
+};
+
+inline bool isMatrixCollectionFileType(const TFileType t)
+{
+  return ( t == FT_MatrixMarket || t == FT_HarwellBoeing || t == FT_RutherfordBoeing );
+}
+
+//header parsing, file should be just opened
+inline void ParseHeaderMatrixMarket(InFileText& f, CollectionMatrixHeader& h);
+inline void ParseHeaderHarwellBoeing(InFileText& f, CollectionMatrixHeader& h);
+inline void ParseHeaderCollection(InFileText& f, CollectionMatrixHeader& h);
+
+//streams entries in file order to emit(i, j, value), symmetric counterparts are emitted right after the stored entry
+template<typename T, class Emit> void ReadEntriesMatrixMarket(InFileText& f, const CollectionMatrixHeader& h, Emit emit);
+
+//harwell-boeing stores matrix column by column: column pointers, then row indices, then values.
+//column_ptr should have room for m_ncolumns+1 elements, row_indices for m_entries
+inline void ReadStructureHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h,
+  size_t* const column_ptr, size_t* const row_indices);
+//streams values to store(k, value), k is position of entry in row_indices, pattern matrices get ones
+template<typename T, class Store> void ReadValuesHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, Store store);
+//streams both structure and values to emit(i, j, value) like ReadEntriesMatrixMarket does
+template<typename T, class Emit> void ReadEntriesHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, Emit emit);
+
+}
+
+//implementation
+#include "calcapp/math/matrix_collections_impl.hpp"
+
+#endif /* _MATRIX_COLLECTIONS_HPP */
@@ -0,0 +1,358 @@
+#include "calcapp/math/matrix_collections.hpp"
+
+#include <algorithm>
+
+namespace Calc
+{
+
+//next non blank line with matrix data
+inline void __collection_next_line(InFileText& f)
+{
+  do {
+    if(f.eof())
+      throw PreliminaryEofError("Reached EOF reading matrix entries", f.fileType(), f.fileName().c_str(), f.lineNum());
+    f.readNextLine();
+  } while(f.line()[0] == 0);
+}
+
+//one based index in [1, bound] converted to zero based one, str is moved past it
+inline size_t __collection_index(InFileText& f, const char*& str, const size_t bound)
+{
+  char* end = nullptr;
+  const unsigned long long v = strtoull(str, &end, 10);
+  if(end == str)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected integer index");
+  if(v == 0 || v > bound)
+    throw FileFormatValueBoundsError("Index is out of matrix bounds", f.fileType(), f.fileName().c_str(), f.lineNum());
+  str = end;
+  return size_t(v - 1);
+}
+
+template<typename T> inline T __collection_value(InFileText& f, const char* str)
+{
+  T v = T();
+  if(IOUtil::scanArray<T>(str, 1, &v) != 1)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected numeric value");
+  return v;
+}
+
+template<typename T, class Emit> inline void __collection_emit(const CollectionMatrixHeader& h,
+  const size_t i, const size_t j, const T& v, Emit& emit)
+{
+  emit(i, j, v);
+  if(i != j)
+  {
+    if(h.m_symmetry == TCollectionSymmetry::Symmetric)
+      emit(j, i, v);
+    else if(h.m_symmetry == TCollectionSymmetry::SkewSymmetric)
+      emit(j, i, T(-v));
+  }
+}
+
+inline void __collection_unsupported(InFileText& f, const char * msg)
+{
+  throw FileFormatUnsupportedError(msg, f.fileType(), f.fileName().c_str(), f.lineNum());
+}
+
+inline void ParseHeaderMatrixMarket(InFileText& f, CollectionMatrixHeader& h)
+{
+  //%%MatrixMarket matrix <format> <field> <symmetry>
+  f.readNextLine();
+  char object[32] = {0},
+       format[32] = {0},
+       field[32] = {0},
+       symmetry[32] = {0};
+  if(sscanf(f.line(), "%%%%MatrixMarket %31s %31s %31s %31s", object, format, field, symmetry) != 4)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected %%MatrixMarket header line");
+  for(char* s : {object, format, field, symmetry})
+    for(; *s; ++s)
+      *s = char(tolower(*(unsigned char *)s));
+
+  if(strcmp(object, "matrix") != 0)
+    __collection_unsupported(f, "Only matrix objects are supported");
+
+  if(strcmp(format, "coordinate") == 0)
+    h.m_coordinate = true;
+  else if(strcmp(format, "array") == 0)
+    h.m_coordinate = false;
+  else
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected coordinate or array format");
+
+  if(strcmp(field, "real") == 0 || strcmp(field, "double") == 0)
+    h.m_field = TCollectionField::Real;
+  else if(strcmp(field, "integer") == 0)
+    h.m_field = TCollectionField::Integer;
+  else if(strcmp(field, "complex") == 0)
+    h.m_field = TCollectionField::Complex;
+  else if(strcmp(field, "pattern") == 0 && h.m_coordinate)
+    h.m_field = TCollectionField::Pattern;
+  else
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected real, integer, complex or pattern field");
+
+  if(strcmp(symmetry, "general") == 0)
+    h.m_symmetry = TCollectionSymmetry::General;
+  else if(strcmp(symmetry, "symmetric") == 0)
+    h.m_symmetry = TCollectionSymmetry::Symmetric;
+  else if(strcmp(symmetry, "skew-symmetric") == 0)
+    h.m_symmetry = TCollectionSymmetry::SkewSymmetric;
+  else if(strcmp(symmetry, "hermitian") == 0)
+    h.m_symmetry = TCollectionSymmetry::Hermitian;
+  else
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected general, symmetric, skew-symmetric or hermitian symmetry");
+
+  if(h.m_field == TCollectionField::Complex || h.m_symmetry == TCollectionSymmetry::Hermitian)
+    __collection_unsupported(f, "Complex matrices are not supported");
+
+  //skip comments
+  do {
+    __collection_next_line(f);
+  } while(f.line()[0] == '%');
+
+  if(h.m_coordinate)
+  {
+    if(sscanf(f.line(), "%zu %zu %zu", &h.m_nrows, &h.m_ncolumns, &h.m_entries) != 3)
+      f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected numbers of rows, columns and entries");
+  } else {
+    if(sscanf(f.line(), "%zu %zu", &h.m_nrows, &h.m_ncolumns) != 2)
+      f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected numbers of rows and columns");
+    //only lower triangle of symmetric matrices is stored, diagonal of skew-symmetric ones is omitted
+    if(h.m_symmetry == TCollectionSymmetry::Symmetric)
+      h.m_entries = h.m_nrows*(h.m_nrows+1)/2;
+    else if(h.m_symmetry == TCollectionSymmetry::SkewSymmetric)
+      h.m_entries = h.m_nrows*(h.m_nrows-1)/2;
+    else
+      h.m_entries = h.m_nrows*h.m_ncolumns;
+  }
+  if(h.m_symmetry != TCollectionSymmetry::General && h.m_nrows != h.m_ncolumns)
+    throw FileFormatValueBoundsError("Symmetric matrix should be square", f.fileType(), f.fileName().c_str(), f.lineNum());
+
+  h.m_ptr_fmt = h.m_ind_fmt = h.m_val_fmt = FortranFormat{0, 0};
+}
+
+inline bool __parse_fortran_format(const char* str, FortranFormat& fmt)
+{
+  std::string s(str);
+  std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+  size_t p = s.find('(');
+  p = ( p == std::string::npos ? 0 : p + 1 );
+  //skip scale factor, f.e. 1P in (1P,4E20.12)
+  const size_t pp = s.find('P', p);
+  if(pp != std::string::npos)
+  {
+    p = pp + 1;
+    if(p < s.size() && s[p] == ',')
+      ++p;
+  }
+  size_t repeat = 0;
+  for(; p < s.size() && isdigit((unsigned char)s[p]); ++p)
+    repeat = repeat*10 + (s[p] - '0');
+  if(p >= s.size() || strchr("IEDFG", s[p]) == nullptr)
+    return false;
+  ++p;
+  size_t width = 0;
+  for(; p < s.size() && isdigit((unsigned char)s[p]); ++p)
+    width = width*10 + (s[p] - '0');
+  if(width == 0)
+    return false;
+  fmt.m_per_line = std::max(repeat, size_t(1));
+  fmt.m_width = width;
+  return true;
+}
+
+inline void ParseHeaderHarwellBoeing(InFileText& f, CollectionMatrixHeader& h)
+{
+  //title and key
+  f.readNextLine();
+  //total number of lines and numbers of lines of pointers, indices, values and right hand sides(harwell-boeing only)
+  size_t lines[5] = {0, 0, 0, 0, 0};
+  f.readNextLine();
+  const int nlines = sscanf(f.line(), "%zu %zu %zu %zu %zu", &lines[0], &lines[1], &lines[2], &lines[3], &lines[4]);
+  if(nlines < 4)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected numbers of lines of matrix sections");
+
+  //matrix type, f.e. RUA(real unsymmetric assembled), and sizes
+  f.readNextLine();
+  if(strlen(f.line()) < 3)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected matrix type");
+  char type[3];
+  for(int i = 0; i < 3; ++i)
+    type[i] = char(toupper(((const unsigned char *)f.line())[i]));
+  size_t nelements = 0;
+  if(sscanf(f.line() + 3, "%zu %zu %zu %zu", &h.m_nrows, &h.m_ncolumns, &h.m_entries, &nelements) < 3)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected numbers of rows, columns and entries");
+  h.m_coordinate = true;
+
+  switch(type[0]) {
+    case 'R': h.m_field = TCollectionField::Real; break;
+    case 'I': h.m_field = TCollectionField::Integer; break;
+    case 'P': h.m_field = TCollectionField::Pattern; break;
+    case 'C': h.m_field = TCollectionField::Complex; break;
+    default:
+      f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected real, integer, complex or pattern matrix type");
+  }
+  switch(type[1]) {
+    case 'U':
+    case 'R': h.m_symmetry = TCollectionSymmetry::General; break;
+    case 'S': h.m_symmetry = TCollectionSymmetry::Symmetric; break;
+    case 'Z': h.m_symmetry = TCollectionSymmetry::SkewSymmetric; break;
+    case 'H': h.m_symmetry = TCollectionSymmetry::Hermitian; break;
+    default:
+      f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected unsymmetric, rectangular, symmetric, skew-symmetric or hermitian matrix type");
+  }
+  if(h.m_field == TCollectionField::Complex || h.m_symmetry == TCollectionSymmetry::Hermitian)
+    __collection_unsupported(f, "Complex matrices are not supported");
+  if(type[2] != 'A')
+    __collection_unsupported(f, "Only assembled matrices are supported");
+  if(h.m_symmetry != TCollectionSymmetry::General && h.m_nrows != h.m_ncolumns)
+    throw FileFormatValueBoundsError("Symmetric matrix should be square", f.fileType(), f.fileName().c_str(), f.lineNum());
+
+  //fortran formats of pointers, indices and values
+  f.readNextLine();
+  char formats[3][32] = {{0}, {0}, {0}};
+  const int nformats = sscanf(f.line(), "%31s %31s %31s", formats[0], formats[1], formats[2]);
+  if(nformats < 2 || !__parse_fortran_format(formats[0], h.m_ptr_fmt) || !__parse_fortran_format(formats[1], h.m_ind_fmt))
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected fortran formats of pointers and indices");
+  if(h.m_field != TCollectionField::Pattern && (nformats < 3 || !__parse_fortran_format(formats[2], h.m_val_fmt)))
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Expected fortran format of values");
+
+  //right hand sides descriptor, right hand sides themselves are not read
+  if(nlines == 5 && lines[4] > 0)
+    f.readNextLine();
+}
+
+inline void ParseHeaderCollection(InFileText& f, CollectionMatrixHeader& h)
+{
+  if(f.fileType() == FT_MatrixMarket)
+    ParseHeaderMatrixMarket(f, h);
+  else if(f.fileType() == FT_HarwellBoeing || f.fileType() == FT_RutherfordBoeing)
+    ParseHeaderHarwellBoeing(f, h);
+  else
+    __collection_unsupported(f, "File format unsupported");
+}
+
+template<typename T, class Emit> void ReadEntriesMatrixMarket(InFileText& f, const CollectionMatrixHeader& h, Emit emit)
+{
+  if(h.m_coordinate)
+  {
+    const T one = T(1);
+    for(size_t k = 0; k < h.m_entries; ++k) {
+      __collection_next_line(f);
+      const char* str = f.line();
+      const size_t i = __collection_index(f, str, h.m_nrows);
+      const size_t j = __collection_index(f, str, h.m_ncolumns);
+      if(h.m_field == TCollectionField::Pattern)
+        __collection_emit(h, i, j, one, emit);
+      else
+        __collection_emit(h, i, j, __collection_value<T>(f, str), emit);
+    }
+  } else {
+    //column major, only lower triangle of symmetric matrices is stored
+    for(size_t j = 0; j < h.m_ncolumns; ++j) {
+      const size_t first = ( h.m_symmetry == TCollectionSymmetry::General ? 0 :
+                           ( h.m_symmetry == TCollectionSymmetry::SkewSymmetric ? j + 1 : j ) );
+      for(size_t i = first; i < h.m_nrows; ++i) {
+        __collection_next_line(f);
+        __collection_emit(h, i, j, __collection_value<T>(f, f.line()), emit);
+      }
+    }
+  }
+}
+
+//hands over next count fixed width fields to store(k, field), every section starts on a new line
+template<class Store> void __read_fortran_fields(InFileText& f, const FortranFormat& fmt, const size_t count, Store store)
+{
+  static const size_t MAX_FIELD_WIDTH = 255;
+  char field[MAX_FIELD_WIDTH+1];
+  const size_t w = fmt.m_width;
+  if(w > MAX_FIELD_WIDTH)
+    f.throwFormatError(FERR_IO_FORMAT_ERROR, "Field width of fortran format is too large");
+  size_t k = 0;
+  while(k < count) {
+    __collection_next_line(f);
+    const char* line = f.line();
+    const size_t nfields = std::min(fmt.m_per_line, count - k);
+    //fields of conforming files are right justified within their width,
+    //but most writers separate them by blanks, so try to split by blanks first
+    size_t ntokens = 0;
+    for(const char* s = line; *s; ) {
+      while(*s && isspace(*(const unsigned char *)s)) ++s;
+      if(!*s)
+        break;
+      ++ntokens;
+      while(*s && !isspace(*(const unsigned char *)s)) ++s;
+    }
+    const char* s = line;
+    //leading blanks were trimmed off the line, so fixed width fields are aligned to its end
+    const size_t len = strlen(line);
+    if(ntokens != nfields && len > nfields*w)
+      f.throwFormatError(FERR_IO_FORMAT_ERROR, "Line does not match fortran format");
+    const size_t shift = nfields*w - std::min(len, nfields*w);
+    for(size_t q = 0; q < nfields; ++q) {
+      const char* begin;
+      const char* end;
+      if(ntokens == nfields)
+      {
+        while(isspace(*(const unsigned char *)s)) ++s;
+        begin = s;
+        while(*s && !isspace(*(const unsigned char *)s)) ++s;
+        end = s;
+      } else {
+        if((q+1)*w <= shift)
+          f.throwFormatError(FERR_IO_FORMAT_ERROR, "Blank field of fortran format");
+        begin = line + ( q*w > shift ? q*w - shift : 0 );
+        end = line + (q+1)*w - shift;
+      }
+      const size_t flen = std::min(size_t(end - begin), MAX_FIELD_WIDTH);
+      for(size_t c = 0; c < flen; ++c)
+        //fortran D exponent
+        field[c] = ( begin[c] == 'D' || begin[c] == 'd' ? 'E' : begin[c] );
+      field[flen] = 0;
+      store(k++, (const char *)field);
+    }
+  }
+}
+
+inline void ReadStructureHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h,
+  size_t* const column_ptr, size_t* const row_indices)
+{
+  const size_t max_ptr = h.m_entries + 1;
+  __read_fortran_fields(f, h.m_ptr_fmt, h.m_ncolumns + 1, [&](const size_t k, const char* field) {
+    column_ptr[k] = __collection_index(f, field, max_ptr);
+  });
+  if(column_ptr[0] != 0 || column_ptr[h.m_ncolumns] != h.m_entries)
+    throw FileFormatValueBoundsError("Column pointers mismatch number of entries", f.fileType(), f.fileName().c_str(), f.lineNum());
+  for(size_t j = 0; j < h.m_ncolumns; ++j)
+    if(column_ptr[j] > column_ptr[j+1])
+      throw FileFormatValueBoundsError("Column pointers should be nondecreasing", f.fileType(), f.fileName().c_str(), f.lineNum());
+  __read_fortran_fields(f, h.m_ind_fmt, h.m_entries, [&](const size_t k, const char* field) {
+    row_indices[k] = __collection_index(f, field, h.m_nrows);
+  });
+}
+
+template<typename T, class Store> void ReadValuesHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, Store store)
+{
+  if(h.m_field == TCollectionField::Pattern)
+  {
+    const T one = T(1);
+    for(size_t k = 0; k < h.m_entries; ++k)
+      store(k, one);
+    return;
+  }
+  __read_fortran_fields(f, h.m_val_fmt, h.m_entries, [&](const size_t k, const char* field) {
+    store(k, __collection_value<T>(f, field));
+  });
+}
+
+template<typename T, class Emit> void ReadEntriesHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, Emit emit)
+{
+  std::vector<size_t> column_ptr(h.m_ncolumns + 1);
+  std::vector<size_t> row_indices(std::max(h.m_entries, size_t(1)));
+  ReadStructureHarwellBoeing(f, h, column_ptr.data(), row_indices.data());
+  size_t j = 0;
+  ReadValuesHarwellBoeing<T>(f, h, [&](const size_t k, const T& v) {
+    while(column_ptr[j+1] <= k) ++j;
+    __collection_emit(h, row_indices[k], j, v, emit);
+  });
+}
+
+}
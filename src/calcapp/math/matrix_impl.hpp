@@ -17,7 +17,7 @@ template<typename T> void ArrayBasedDenseMatrix<T>::init(const bool reset, const
   constexpr bool holdsObjects = std::is_class<T>::value;
   if(holdsObjects && initObjects)
   {
-    for (size_t i = 0; i < getSize(); ++i) {
+    for (size_t i = 0; i < getStoredSize(); ++i) {
       new(getDataPtr()+i) T();
     }
   }
@@ -44,10 +44,61 @@ template<typename T> void ArrayBasedDenseMatrix<T>::WriteHeaderDat(OutFileText&
   f.println();
 }
 
+template<typename T> void ArrayBasedDenseMatrix<T>::ReadTiledDat(InFileText& f, const size_t f_nrows, const size_t f_ncolumns,
+  const bool transpose)
+{
+  //padding of tiles should be zero, so everything is initialized before reading
+  init(true, true);
+  std::unique_ptr<T[]> row( new T[f_ncolumns] );
+  for (size_t i = 0; i < f_nrows; ++i) {
+    f.readNextLine_scanNumArray<T>(f_ncolumns, f_ncolumns, row.get());
+    for (size_t j = 0; j < f_ncolumns; ++j)
+      get(transpose ? j : i, transpose ? i : j) = row[j];
+  }
+}
+
+template<typename T> void ArrayBasedDenseMatrix<T>::WriteTiledDat(OutFileText& f, const size_t f_nrows, const size_t f_ncolumns,
+  const bool transpose, const int print_precision)
+{
+  std::unique_ptr<T[]> row( new T[f_ncolumns] );
+  for (size_t i = 0; i < f_nrows; ++i) {
+    for (size_t j = 0; j < f_ncolumns; ++j)
+      row[j] = get(transpose ? j : i, transpose ? i : j);
+    f.println_printNumArray(f_ncolumns, row.get(), 1, print_precision);
+  }
+}
+
+template<typename T> void ArrayBasedDenseMatrix<T>::ReadCollection(InFileText& f, const CollectionMatrixHeader& h,
+  const bool transpose)
+{
+  //padding of tiles and entries missing from file are zeros
+  init(true, true);
+  auto scatter = [&](const size_t i, const size_t j, const T& v) {
+    //duplicates are summed up
+    get(transpose ? j : i, transpose ? i : j) += v;
+  };
+  if(f.fileType() == FT_MatrixMarket)
+    ReadEntriesMatrixMarket<T>(f, h, scatter);
+  else
+    ReadEntriesHarwellBoeing<T>(f, h, scatter);
+}
+
 template<typename T> void ArrayBasedDenseMatrix<T>::init(InFileText& f, const bool readData,
   const bool transpose)
 {
 //  static_assert(std::is_arithmetic<T>::value, "Arithmetical type expected"); //TODO: check boost::multiprecision type traits
+  if(isMatrixCollectionFileType(f.fileType()))
+  {
+    CollectionMatrixHeader h;
+    ParseHeaderCollection(f, h);
+    m_nrows = ( transpose ? h.m_ncolumns : h.m_nrows );
+    m_ncolumns = ( transpose ? h.m_nrows : h.m_ncolumns );
+    m_stride = ( isRowMajor() ? m_ncolumns : ( isTiled() ? numeric::tiled_tile_size() : m_nrows ) );
+    if(readData)
+      ReadCollection(f, h, transpose);
+    return;
+  }
+
   if(f.fileType() != FT_MatrixText)
     throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
 
@@ -58,9 +109,11 @@ template<typename T> void ArrayBasedDenseMatrix<T>::init(InFileText& f, const bo
   m_ncolumns = f_ncolumns;
   if(transpose)
     std::swap(m_nrows,m_ncolumns);
-  m_stride = ( isRowMajor() ? m_ncolumns : m_nrows );
+  m_stride = ( isRowMajor() ? m_ncolumns : ( isTiled() ? numeric::tiled_tile_size() : m_nrows ) );
 
-  if(readData) {
+  if(readData && isTiled()) {
+    ReadTiledDat(f, f_nrows, f_ncolumns, transpose);
+  } else if(readData) {
     ensureAllocated();
 
     //no placement new call is required, data should be initialized when read in
@@ -75,6 +128,18 @@ template<typename T> void ArrayBasedDenseMatrix<T>::init(InFileText& f, const bo
 //data IO
 template<typename T> void ArrayBasedDenseMatrix<T>::readFromFile(InFileText& f, const bool transpose)
 {
+  if(isMatrixCollectionFileType(f.fileType()))
+  {
+    //entries can't be read without header, so file is reread from the beginning
+    if(f.lineNum() != 0)
+      f.reset();
+    CollectionMatrixHeader h;
+    ParseHeaderCollection(f, h);
+    if( ( transpose ? h.m_ncolumns : h.m_nrows ) != m_nrows || ( transpose ? h.m_nrows : h.m_ncolumns ) != m_ncolumns )
+      throw FileFormatValueBoundsError("Mismatched size of matrix in file",f.fileType(),f.fileName().c_str(),f.lineNum());
+    return ReadCollection(f, h, transpose);
+  }
+
   if(f.fileType() != FT_MatrixText)
     throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
 
@@ -93,6 +158,9 @@ template<typename T> void ArrayBasedDenseMatrix<T>::readFromFile(InFileText& f,
     }
   }
 
+  if(isTiled())
+    return ReadTiledDat(f, f_nrows, f_ncolumns, transpose);
+
   //allocate memory if necessary
   ensureAllocated();
 
@@ -117,6 +185,12 @@ template<typename T> void ArrayBasedDenseMatrix<T>::writeToFile(OutFileText& f,
 
   WriteHeaderDat(f, f_nrows, f_ncolumns);
 
+  if(isTiled()) {
+    WriteTiledDat(f, f_nrows, f_ncolumns, transpose, print_precision);
+    f.flush();
+    return;
+  }
+
   const size_t output_stride = ( ((isRowMajor() && transpose) || (!isRowMajor() && !transpose)) ? f_nrows : 1 );
   const size_t output_inc = ( ((isRowMajor() && transpose) || (!isRowMajor() && !transpose)) ? 1 : f_ncolumns );
 
@@ -292,6 +366,99 @@ template<typename T> void ArrayBasedCDSBandedMatrix<T>::writeToFile(OutFileText&
   f.flush();
 }
 
+template<typename T> void SymmetricCDSBandedMatrix<T>::ReadRowsDat(InFileText& f)
+{
+  const size_t stride = m_upper_band + 1;
+  T* const data = ArrayBasedDenseMatrix<T>::getDataPtr();
+  std::unique_ptr<T[]> row( new T[2*m_upper_band+1] );
+  //no placement new call is required, data should be initialized when read in
+  for (size_t i = 0; i < m_nrows; ++i)
+  {
+    const size_t lower = std::min(i, m_upper_band);
+    const size_t upper = std::min(m_upper_band, m_nrows - 1 - i);
+    f.readNextLine_scanNumArray<T>(lower+upper+1, lower+upper+1, row.get());
+    for (size_t k = 1; k <= lower; ++k)
+    {
+      if(row[lower-k] != data[(i-k)*stride+k])
+        throw FileFormatValueBoundsError("Banded matrix in file isn't symmetric",f.fileType(),f.fileName().c_str(),f.lineNum());
+    }
+    for (size_t p = 0; p <= upper; ++p)
+      data[i*stride+p] = row[lower+p];
+    //padding
+    for (size_t p = upper+1; p < stride; ++p)
+      data[i*stride+p] = T(0);
+  }
+}
+
+template<typename T> void SymmetricCDSBandedMatrix<T>::init(InFileText& f, const bool readData,
+  const bool transpose)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  size_t f_nrows=0,
+         f_ncolumns=0,
+         f_upper_band=0,
+         f_lower_band=0;
+  ArrayBasedCDSBandedMatrix<T>::ParseHeaderDat(f,f_nrows,f_ncolumns,f_upper_band,f_lower_band);
+  if( ( f_nrows != f_ncolumns ) || ( f_upper_band != f_lower_band ) )
+    throw FileFormatValueBoundsError("Banded matrix in file isn't symmetrically banded",f.fileType(),f.fileName().c_str(),f.lineNum());
+  m_nrows = m_ncolumns = f_nrows;
+  m_upper_band = m_lower_band = f_upper_band;
+
+  if(readData) {
+    ensureAllocated();
+    ReadRowsDat(f);
+  }
+}
+
+template<typename T> void SymmetricCDSBandedMatrix<T>::readFromFile(InFileText& f, const bool transpose)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  if(f.lineNum()==0) {
+    //just opened file, check header
+    size_t tmp_nrows=0,
+           tmp_ncolumns=0,
+           tmp_upper_band=0,
+           tmp_lower_band=0;
+    ArrayBasedCDSBandedMatrix<T>::ParseHeaderDat(f,tmp_nrows,tmp_ncolumns,tmp_upper_band,tmp_lower_band);
+    if( ( m_nrows != tmp_nrows ) || ( m_ncolumns != tmp_ncolumns ) || (m_upper_band != tmp_upper_band) || (m_lower_band != tmp_lower_band) ) {
+      throw FileFormatValueBoundsError("Mismatched size of matrix in file",f.fileType(),f.fileName().c_str(),f.lineNum());
+    }
+  }
+
+  //allocate memory if necessary
+  ensureAllocated();
+
+  ReadRowsDat(f);
+}
+
+template<typename T> void SymmetricCDSBandedMatrix<T>::writeToFile(OutFileText& f, const bool transpose, const int print_precision)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  ArrayBasedCDSBandedMatrix<T>::WriteHeaderDat(f, m_nrows, m_ncolumns, m_upper_band, m_lower_band);
+
+  const size_t stride = m_upper_band + 1;
+  const T* const data = ArrayBasedDenseMatrix<T>::getDataPtr();
+  std::unique_ptr<T[]> row( new T[2*m_upper_band+1] );
+  for (size_t i = 0; i < m_nrows; ++i)
+  {
+    //lower bands are gathered from columns of upper ones
+    const size_t lower = std::min(i, m_upper_band);
+    const size_t upper = std::min(m_upper_band, m_nrows - 1 - i);
+    for (size_t k = 1; k <= lower; ++k)
+      row[lower-k] = data[(i-k)*stride+k];
+    for (size_t p = 0; p <= upper; ++p)
+      row[lower+p] = data[i*stride+p];
+    f.println_printNumArray(lower+upper+1, row.get(), 1, print_precision);
+  }
+  f.flush();
+}
+
 //type-specific allocation
 template<typename T> inline void Matrix<T>::ensureAllocated()
 {
@@ -440,6 +607,695 @@ template<typename T> inline void ValArrayCDSBandedMatrix<T>::ensureAllocated()
   }
 }
 
+template<typename T> inline void SymmetricCDSBandedMatrix<T>::ensureAllocated()
+{
+  if( m_buf==nullptr || ArrayBasedDenseMatrix<T>::m_data==nullptr )
+  {
+    void* buf=nullptr;
+    ArrayBasedDenseMatrix<T>::m_data = reinterpret_cast<T*>(
+        numeric::aligned_malloc(sizeof(T)*getStoredSize(),
+          numeric::getCacheLineAlignment<T>(), &buf)
+        );
+    m_buf.reset(buf);
+    if(ArrayBasedDenseMatrix<T>::m_data == nullptr) {
+      throw OOMError("Can't allocate aligned data buffer for the matrix");
+    }
+  }
+}
+
+template<typename T>  SymmetricCDSBandedMatrix<T>::~SymmetricCDSBandedMatrix()
+{
+  //explicitly call destructor for types that require it
+  if(std::is_class<T>::value)
+  {
+    size_t i;
+    for (i = 0; i < getStoredSize(); ++i) {
+      ArrayBasedDenseMatrix<T>::m_data[i].~T();
+    }
+  }
+  //no need to free allocated memory, m_buf will take care of it
+}
+
+template<typename T> inline void CSRMatrix<T>::ensureAllocated()
+{
+  if( m_buf==nullptr || ArrayBasedDenseMatrix<T>::m_data==nullptr || m_column_indices==nullptr )
+  {
+    void* buf=nullptr;
+    ArrayBasedDenseMatrix<T>::m_data = reinterpret_cast<T*>(
+        numeric::aligned_malloc(sizeof(T)*std::max(m_capacity,size_t(1)), numeric::getCacheLineAlignment<T>(), &buf)
+        );
+    m_buf.reset(buf);
+    buf=nullptr;
+    m_column_indices = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*std::max(m_capacity,size_t(1)), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_column_indices_buf.reset(buf);
+    if(ArrayBasedDenseMatrix<T>::m_data == nullptr || m_column_indices == nullptr) {
+      throw OOMError("Can't allocate aligned data buffer for the matrix");
+    }
+  }
+  if( m_row_ptr==nullptr )
+  {
+    void* buf=nullptr;
+    m_row_ptr = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*(m_nrows+1), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_row_ptr_buf.reset(buf);
+    if(m_row_ptr == nullptr) {
+      throw OOMError("Can't allocate aligned data buffer for the matrix");
+    }
+    //no rows have stored elements until structure is filled in
+    std::fill(m_row_ptr, m_row_ptr + m_nrows + 1, size_t(0));
+  }
+}
+
+template<typename T> void CSRMatrix<T>::destroyObjects()
+{
+  //explicitly call destructor for types that require it
+  if(std::is_class<T>::value && ArrayBasedDenseMatrix<T>::m_data != nullptr)
+  {
+    for (size_t i = 0; i < m_nnz; ++i) {
+      ArrayBasedDenseMatrix<T>::m_data[i].~T();
+    }
+  }
+}
+
+template<typename T>  CSRMatrix<T>::~CSRMatrix()
+{
+  destroyObjects();
+  //no need to free allocated memory, smart pointers will take care of it
+}
+
+template<typename T> size_t CSRMatrix<T>::index(size_t i, size_t j) const
+{
+  const size_t* const begin = m_column_indices + m_row_ptr[i];
+  const size_t* const end = m_column_indices + m_row_ptr[i+1];
+  const size_t* const it = std::lower_bound(begin, end, j);
+  if(it == end || *it != j)
+    throw ParameterError("element is not stored in sparse matrix");
+  return it - m_column_indices;
+}
+
+template<typename T> void CSRMatrix<T>::reallocate(const size_t nrows, const size_t ncolumns, const size_t nnz)
+{
+  destroyObjects();
+  m_nnz = 0;
+  if(nnz > m_capacity)
+  {
+    m_buf.reset();
+    ArrayBasedDenseMatrix<T>::m_data = nullptr;
+    m_column_indices_buf.reset();
+    m_column_indices = nullptr;
+    m_capacity = nnz;
+  }
+  //number of rows may be changed by init without touching row pointers, so they are always allocated anew
+  m_row_ptr_buf.reset();
+  m_row_ptr = nullptr;
+  m_nrows = nrows;
+  m_ncolumns = ncolumns;
+  ArrayBasedDenseMatrix<T>::m_stride = ncolumns;
+  ensureAllocated();
+}
+
+template<typename T> void CSRMatrix<T>::normalizeRows()
+{
+  T* const data = getDataPtr();
+  std::vector<size_t> order;
+  std::vector<size_t> columns;
+  std::vector<T> values;
+  size_t pos = 0;
+  for(size_t i = 0; i < m_nrows; i++)
+  {
+    const size_t begin = m_row_ptr[i],
+                 end = m_row_ptr[i+1];
+    m_row_ptr[i] = pos;
+    bool sorted = true;
+    for(size_t k = begin + 1; k < end && sorted; k++)
+      sorted = ( m_column_indices[k-1] <= m_column_indices[k] );
+    if(!sorted)
+    {
+      order.resize(end - begin);
+      for(size_t k = begin; k < end; k++)
+        order[k - begin] = k;
+      std::stable_sort(order.begin(), order.end(),
+        [&](const size_t l, const size_t r) { return m_column_indices[l] < m_column_indices[r]; });
+      columns.clear();
+      values.clear();
+      for(const size_t k : order)
+      {
+        columns.push_back(m_column_indices[k]);
+        values.push_back(std::move(data[k]));
+      }
+      std::copy(columns.begin(), columns.end(), m_column_indices + begin);
+      std::move(values.begin(), values.end(), data + begin);
+    }
+    for(size_t k = begin; k < end; k++)
+    {
+      if(pos > m_row_ptr[i] && m_column_indices[pos-1] == m_column_indices[k])
+      {
+        //duplicates are summed up
+        data[pos-1] += data[k];
+      } else {
+        if(pos != k)
+        {
+          m_column_indices[pos] = m_column_indices[k];
+          data[pos] = std::move(data[k]);
+        }
+        pos++;
+      }
+    }
+  }
+  m_row_ptr[m_nrows] = pos;
+  //explicitly call destructor for elements left over after summing up duplicates
+  if(std::is_class<T>::value)
+  {
+    for(size_t k = pos; k < m_nnz; k++)
+      data[k].~T();
+  }
+  m_nnz = pos;
+}
+
+template<typename T> void CSRMatrix<T>::assignTriplets(const size_t nrows, const size_t ncolumns,
+  const std::vector<size_t>& rows, const std::vector<size_t>& columns, const std::vector<T>& values)
+{
+  if(rows.size() != columns.size() || rows.size() != values.size())
+    throw ParameterError("sizes of triplet arrays mismatch");
+  //counting sort by rows, then sort every row by columns
+  std::vector<size_t> row_ptr(nrows+1, 0);
+  for(size_t k = 0; k < rows.size(); k++)
+  {
+    if(rows[k] >= nrows || columns[k] >= ncolumns)
+      throw ParameterError("sparse matrix element is out of bounds");
+    row_ptr[rows[k]+1]++;
+  }
+  for(size_t i = 0; i < nrows; i++)
+    row_ptr[i+1] += row_ptr[i];
+  std::vector<size_t> order(rows.size());
+  {
+    std::vector<size_t> next(row_ptr.begin(), row_ptr.end() - 1);
+    for(size_t k = 0; k < rows.size(); k++)
+      order[next[rows[k]]++] = k;
+  }
+  size_t nnz = 0;
+  for(size_t i = 0; i < nrows; i++)
+  {
+    std::sort(order.begin() + row_ptr[i], order.begin() + row_ptr[i+1],
+      [&](const size_t l, const size_t r) { return columns[l] < columns[r]; });
+    for(size_t k = row_ptr[i]; k < row_ptr[i+1]; k++)
+      if(k == row_ptr[i] || columns[order[k]] != columns[order[k-1]])
+        nnz++;
+  }
+  reallocate(nrows, ncolumns, nnz);
+  T* const data = getDataPtr();
+  size_t pos = 0;
+  for(size_t i = 0; i < nrows; i++)
+  {
+    m_row_ptr[i] = pos;
+    for(size_t k = row_ptr[i]; k < row_ptr[i+1]; k++)
+    {
+      if(k == row_ptr[i] || columns[order[k]] != columns[order[k-1]])
+      {
+        new(data + pos) T(values[order[k]]);
+        m_column_indices[pos++] = columns[order[k]];
+      } else {
+        //duplicates are summed up
+        data[pos-1] += values[order[k]];
+      }
+    }
+  }
+  m_row_ptr[nrows] = pos;
+  m_nnz = pos;
+}
+
+template<typename T> void CSRMatrix<T>::readDat(InFileText& f, const size_t f_nrows, const size_t f_ncolumns,
+  const bool transpose)
+{
+  std::vector<size_t> rows, columns;
+  std::vector<T> values;
+  std::unique_ptr<T[]> row( new T[f_ncolumns] );
+  const T zero = T(0);
+  for (size_t i = 0; i < f_nrows; ++i) {
+    f.readNextLine_scanNumArray<T>(f_ncolumns, f_ncolumns, row.get());
+    for (size_t j = 0; j < f_ncolumns; ++j)
+    {
+      if(row[j] != zero)
+      {
+        rows.push_back(transpose ? j : i);
+        columns.push_back(transpose ? i : j);
+        values.push_back(row[j]);
+      }
+    }
+  }
+  assignTriplets(transpose ? f_ncolumns : f_nrows, transpose ? f_nrows : f_ncolumns, rows, columns, values);
+}
+
+template<typename T> void CSRMatrix<T>::readMatrixMarket(InFileText& f, const CollectionMatrixHeader& h, const bool transpose)
+{
+  reallocate(transpose ? h.m_ncolumns : h.m_nrows, transpose ? h.m_nrows : h.m_ncolumns, h.maxEntries());
+  //entries are appended in file order and counted in m_row_ptr[1..nrows],
+  //row indices are only kept once entries come out of row major order.
+  //m_nnz holds number of constructed elements, so that they are destroyed properly on parsing error
+  T* const data = getDataPtr();
+  size_t* const counts = m_row_ptr + 1;
+  std::vector<size_t> rows;
+  bool ordered = true;
+  size_t last_i = 0,
+         last_j = 0;
+  const T zero = T(0);
+  ReadEntriesMatrixMarket<T>(f, h, [&](size_t i, size_t j, const T& v) {
+    //dense array format has zeros stored explicitly
+    if(!h.m_coordinate && v == zero)
+      return;
+    if(transpose)
+      std::swap(i, j);
+    if(ordered && m_nnz > 0 && ( i < last_i || ( i == last_i && j <= last_j ) ))
+    {
+      ordered = false;
+      rows.reserve(h.maxEntries());
+      for(size_t r = 0; r < m_nrows; r++)
+        rows.insert(rows.end(), counts[r], r);
+    }
+    if(!ordered)
+      rows.push_back(i);
+    last_i = i;
+    last_j = j;
+    counts[i]++;
+    new(data + m_nnz) T(v);
+    m_column_indices[m_nnz++] = j;
+  });
+  for(size_t i = 0; i < m_nrows; i++)
+    m_row_ptr[i+1] += m_row_ptr[i];
+  //strictly increasing positions leave nothing to sort or sum up
+  if(ordered)
+    return;
+
+  //stable counting sort by rows, it keeps columns sorted within rows for column major files
+  void* buf = nullptr;
+  T* const sorted_data = reinterpret_cast<T*>(
+      numeric::aligned_malloc(sizeof(T)*std::max(m_nnz,size_t(1)), numeric::getCacheLineAlignment<T>(), &buf)
+      );
+  numeric::unique_aligned_buf_ptr sorted_data_buf(buf);
+  buf = nullptr;
+  size_t* const sorted_column_indices = reinterpret_cast<size_t*>(
+      numeric::aligned_malloc(sizeof(size_t)*std::max(m_nnz,size_t(1)), numeric::getCacheLineAlignment<size_t>(), &buf)
+      );
+  numeric::unique_aligned_buf_ptr sorted_column_indices_buf(buf);
+  if(sorted_data == nullptr || sorted_column_indices == nullptr)
+    throw OOMError("Can't allocate aligned data buffer for the matrix");
+  {
+    std::vector<size_t> next(m_row_ptr, m_row_ptr + m_nrows);
+    for(size_t k = 0; k < m_nnz; k++)
+    {
+      const size_t pos = next[rows[k]]++;
+      new(sorted_data + pos) T(std::move(data[k]));
+      sorted_column_indices[pos] = m_column_indices[k];
+    }
+  }
+  std::vector<size_t>().swap(rows);
+  destroyObjects();
+  m_buf = std::move(sorted_data_buf);
+  ArrayBasedDenseMatrix<T>::m_data = sorted_data;
+  m_column_indices_buf = std::move(sorted_column_indices_buf);
+  m_column_indices = sorted_column_indices;
+  m_capacity = m_nnz;
+  normalizeRows();
+}
+
+template<typename T> void CSRMatrix<T>::readHarwellBoeing(InFileText& f, const CollectionMatrixHeader& h, const bool transpose)
+{
+  //file holds compressed columns, so every entry gets its place in rows as soon as structure is read,
+  //and values are streamed straight into it
+  std::vector<size_t> column_ptr(h.m_ncolumns + 1);
+  std::vector<size_t> position(std::max(h.m_entries, size_t(1)));
+  ReadStructureHarwellBoeing(f, h, column_ptr.data(), position.data());
+  const bool mirrored = ( h.m_symmetry != TCollectionSymmetry::General );
+  const bool skew = ( h.m_symmetry == TCollectionSymmetry::SkewSymmetric );
+  const size_t nrows = ( transpose ? h.m_ncolumns : h.m_nrows );
+  std::vector<size_t> row_ptr(nrows + 1, 0);
+  for(size_t c = 0; c < h.m_ncolumns; c++)
+    for(size_t k = column_ptr[c]; k < column_ptr[c+1]; k++)
+    {
+      const size_t r = position[k];
+      row_ptr[( transpose ? c : r ) + 1]++;
+      if(mirrored && r != c)
+        row_ptr[( transpose ? r : c ) + 1]++;
+    }
+  for(size_t i = 0; i < nrows; i++)
+    row_ptr[i+1] += row_ptr[i];
+  reallocate(nrows, transpose ? h.m_nrows : h.m_ncolumns, row_ptr[nrows]);
+  std::copy(row_ptr.begin(), row_ptr.end(), m_row_ptr);
+
+  //walking columns in order keeps columns sorted within rows as long as row indices are sorted within columns
+  const size_t none = size_t(-1);
+  std::vector<size_t> mirror_position( mirrored ? position.size() : 0 );
+  for(size_t c = 0; c < h.m_ncolumns; c++)
+    for(size_t k = column_ptr[c]; k < column_ptr[c+1]; k++)
+    {
+      const size_t r = position[k];
+      const size_t i = ( transpose ? c : r ),
+                   j = ( transpose ? r : c );
+      position[k] = row_ptr[i]++;
+      m_column_indices[position[k]] = j;
+      if(mirrored)
+      {
+        mirror_position[k] = ( r != c ? row_ptr[j]++ : none );
+        if(r != c)
+          m_column_indices[mirror_position[k]] = i;
+      }
+    }
+
+  //values are scattered, so objects are constructed beforehand
+  T* const data = getDataPtr();
+  if(std::is_class<T>::value)
+  {
+    for(size_t k = 0; k < m_row_ptr[m_nrows]; k++)
+      new(data + k) T();
+  }
+  m_nnz = m_row_ptr[m_nrows];
+  ReadValuesHarwellBoeing<T>(f, h, [&](const size_t k, const T& v) {
+    data[position[k]] = v;
+    if(mirrored && mirror_position[k] != none)
+      data[mirror_position[k]] = ( skew ? T(-v) : v );
+  });
+  normalizeRows();
+}
+
+template<typename T> void CSRMatrix<T>::readCollection(InFileText& f, const CollectionMatrixHeader& h, const bool transpose)
+{
+  if(f.fileType() == FT_MatrixMarket)
+    readMatrixMarket(f, h, transpose);
+  else
+    readHarwellBoeing(f, h, transpose);
+}
+
+template<typename T> void CSRMatrix<T>::init(const bool reset, const bool initObjects)
+{
+  //there are no objects to construct in empty matrix, and stored ones are kept along with their structure otherwise
+  if(reset)
+    reallocate(m_nrows, m_ncolumns, 0);
+  else
+    ensureAllocated();
+}
+
+template<typename T> void CSRMatrix<T>::init(InFileText& f, const bool readData, const bool transpose)
+{
+  if(!MatrixBase::isRowMajor())
+    throw ParameterError("sparse matrices are stored in row major order only");
+  if(isMatrixCollectionFileType(f.fileType()))
+  {
+    CollectionMatrixHeader h;
+    ParseHeaderCollection(f, h);
+    m_nrows = ( transpose ? h.m_ncolumns : h.m_nrows );
+    m_ncolumns = ( transpose ? h.m_nrows : h.m_ncolumns );
+    ArrayBasedDenseMatrix<T>::m_stride = m_ncolumns;
+    if(readData)
+      readCollection(f, h, transpose);
+    return;
+  }
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  size_t f_nrows=0,
+         f_ncolumns=0;
+  ArrayBasedDenseMatrix<T>::ParseHeaderDat(f,f_nrows,f_ncolumns);
+  m_nrows = ( transpose ? f_ncolumns : f_nrows );
+  m_ncolumns = ( transpose ? f_nrows : f_ncolumns );
+  ArrayBasedDenseMatrix<T>::m_stride = m_ncolumns;
+  if(readData)
+    readDat(f, f_nrows, f_ncolumns, transpose);
+}
+
+template<typename T> void CSRMatrix<T>::readFromFile(InFileText& f, const bool transpose)
+{
+  if(isMatrixCollectionFileType(f.fileType()))
+  {
+    //entries can't be read without header, so file is reread from the beginning
+    if(f.lineNum() != 0)
+      f.reset();
+    CollectionMatrixHeader h;
+    ParseHeaderCollection(f, h);
+    if( ( transpose ? h.m_ncolumns : h.m_nrows ) != m_nrows || ( transpose ? h.m_nrows : h.m_ncolumns ) != m_ncolumns )
+      throw FileFormatValueBoundsError("Mismatched size of matrix in file",f.fileType(),f.fileName().c_str(),f.lineNum());
+    return readCollection(f, h, transpose);
+  }
+
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+
+  size_t f_nrows = ( transpose ? m_ncolumns : m_nrows ),
+         f_ncolumns = ( transpose ? m_nrows : m_ncolumns );
+
+  if(f.lineNum()==0) {
+    //just opened file, check header
+    size_t tmp_nrows=0,
+           tmp_ncolumns=0;
+    ArrayBasedDenseMatrix<T>::ParseHeaderDat(f,tmp_nrows,tmp_ncolumns);
+    if( ( f_nrows != tmp_nrows ) || ( f_ncolumns != tmp_ncolumns ) ) {
+      throw FileFormatValueBoundsError("Mismatched size of matrix in file",f.fileType(),f.fileName().c_str(),f.lineNum());
+    }
+  }
+  readDat(f, f_nrows, f_ncolumns, transpose);
+}
+
+template<typename T> void CSRMatrix<T>::writeToFile(OutFileText& f, const bool transpose, const int print_precision)
+{
+  if(f.fileType() != FT_MatrixText)
+    throw FileFormatUnsupportedError("File format unsupported",f.fileType(),f.fileName().c_str(),f.lineNum());
+  ensureAllocated();
+  const size_t f_nrows = ( transpose ? m_ncolumns : m_nrows ),
+               f_ncolumns = ( transpose ? m_nrows : m_ncolumns );
+  ArrayBasedDenseMatrix<T>::WriteHeaderDat(f, f_nrows, f_ncolumns);
+  //rows of transposed matrix are gathered column by column
+  std::vector<size_t> pos(m_row_ptr, m_row_ptr + m_nrows);
+  std::unique_ptr<T[]> row( new T[f_ncolumns] );
+  for (size_t i = 0; i < f_nrows; ++i) {
+    std::fill(row.get(), row.get() + f_ncolumns, T(0));
+    if(transpose)
+    {
+      for (size_t j = 0; j < m_nrows; ++j)
+        if(pos[j] < m_row_ptr[j+1] && m_column_indices[pos[j]] == i)
+          row[j] = getDataPtr()[pos[j]++];
+    } else {
+      for (size_t k = m_row_ptr[i]; k < m_row_ptr[i+1]; ++k)
+        row[m_column_indices[k]] = getDataPtr()[k];
+    }
+    f.println_printNumArray(f_ncolumns, row.get(), 1, print_precision);
+  }
+  f.flush();
+}
+
+template<typename T> void CDSBandedMatrix<T>::assignCSR(const CSRMatrix<T>& csr, std::vector<size_t>& permutation,
+  const bool reorder)
+{
+  if(csr.getRowsNum() != csr.getColumnsNum())
+    throw ParameterError("only square sparse matrices can be converted to banded ones");
+  if(!MatrixBase::isRowMajor())
+    throw ParameterError("banded matrices are converted in row major order only");
+  const size_t sz = csr.getRowsNum();
+  permutation.resize(sz);
+  if(reorder)
+  {
+    numeric::rcm_ordering(csr.getRowPtr(), csr.getColumnIndices(), sz, permutation.data());
+  } else {
+    for(size_t i = 0; i < sz; i++)
+      permutation[i] = i;
+  }
+  size_t upper_band = 0,
+         lower_band = 0;
+  numeric::csr_bandwidth(csr.getRowPtr(), csr.getColumnIndices(), sz, permutation.data(), upper_band, lower_band);
+
+  //reallocate storage
+  if(std::is_class<T>::value && ArrayBasedDenseMatrix<T>::m_data != nullptr)
+  {
+    for (size_t i = 0; i < ArrayBasedCDSBandedMatrix<T>::getStoredSize(); ++i) {
+      ArrayBasedDenseMatrix<T>::m_data[i].~T();
+    }
+  }
+  m_buf.reset();
+  ArrayBasedDenseMatrix<T>::m_data = nullptr;
+  MatrixBase::m_nrows = MatrixBase::m_ncolumns = sz;
+  ArrayBasedDenseMatrix<T>::m_stride = sz;
+  ArrayBasedCDSBandedMatrix<T>::m_upper_band = upper_band;
+  ArrayBasedCDSBandedMatrix<T>::m_lower_band = lower_band;
+  ArrayBasedDenseMatrix<T>::init(true, true);
+  numeric::csr_to_cds(csr.getDataPtr(), csr.getRowPtr(), csr.getColumnIndices(), sz, permutation.data(),
+    ArrayBasedDenseMatrix<T>::getDataPtr(), upper_band, lower_band);
+}
+
+template<typename T> inline void SELLMatrix<T>::ensureAllocated()
+{
+  if( m_buf==nullptr || ArrayBasedDenseMatrix<T>::m_data==nullptr || m_chunk_ptr==nullptr )
+  {
+    const size_t nchunks = getChunksNum();
+    void* buf=nullptr;
+    ArrayBasedDenseMatrix<T>::m_data = reinterpret_cast<T*>(
+        numeric::aligned_malloc(sizeof(T)*std::max(m_stored,size_t(1)), numeric::getCacheLineAlignment<T>(), &buf)
+        );
+    m_buf.reset(buf);
+    buf=nullptr;
+    m_column_indices = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*std::max(m_stored,size_t(1)), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_column_indices_buf.reset(buf);
+    buf=nullptr;
+    m_chunk_ptr = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*(nchunks+1), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_chunk_ptr_buf.reset(buf);
+    buf=nullptr;
+    m_permutation = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*std::max(nchunks*m_chunk_height,size_t(1)), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_permutation_buf.reset(buf);
+    buf=nullptr;
+    m_row_lengths = reinterpret_cast<size_t*>(
+        numeric::aligned_malloc(sizeof(size_t)*std::max(nchunks*m_chunk_height,size_t(1)), numeric::getCacheLineAlignment<size_t>(), &buf)
+        );
+    m_row_lengths_buf.reset(buf);
+    if(ArrayBasedDenseMatrix<T>::m_data == nullptr || m_column_indices == nullptr || m_chunk_ptr == nullptr
+        || m_permutation == nullptr || m_row_lengths == nullptr) {
+      throw OOMError("Can't allocate aligned data buffer for the matrix");
+    }
+  }
+}
+
+template<typename T> void SELLMatrix<T>::destroyObjects()
+{
+  //explicitly call destructor for types that require it
+  if(std::is_class<T>::value && ArrayBasedDenseMatrix<T>::m_data != nullptr)
+  {
+    for (size_t i = 0; i < m_stored; ++i) {
+      ArrayBasedDenseMatrix<T>::m_data[i].~T();
+    }
+  }
+}
+
+template<typename T>  SELLMatrix<T>::~SELLMatrix()
+{
+  destroyObjects();
+  //no need to free allocated memory, smart pointers will take care of it
+}
+
+template<typename T> void SELLMatrix<T>::init(const bool reset, const bool initObjects)
+{
+  //empty matrix without rows, contents are assigned from CSR
+  ensureAllocated();
+  std::fill(m_chunk_ptr, m_chunk_ptr + getChunksNum() + 1, size_t(0));
+  std::fill(m_row_lengths, m_row_lengths + getChunksNum()*m_chunk_height, size_t(0));
+}
+
+template<typename T> size_t SELLMatrix<T>::index(size_t i, size_t j) const
+{
+  //sorted position of row is looked up through permutation
+  const size_t pos = std::find(m_permutation, m_permutation + m_nrows, i) - m_permutation;
+  if(pos == m_nrows)
+    throw ParameterError("element is not stored in sparse matrix");
+  //padding repeats column index of the last stored element, so only first m_row_lengths[pos] elements of slice are looked at
+  const size_t k = pos / m_chunk_height, r = pos % m_chunk_height;
+  for(size_t l = 0, idx = m_chunk_ptr[k] + r; l < m_row_lengths[pos]; l++, idx += m_chunk_height)
+    if(m_column_indices[idx] == j)
+      return idx;
+  throw ParameterError("element is not stored in sparse matrix");
+}
+
+template<typename T> void SELLMatrix<T>::assignCSR(const CSRMatrix<T>& csr, const size_t chunk_height, const size_t sigma)
+{
+  const size_t* const row_ptr = csr.getRowPtr();
+  const size_t* const csr_columns = csr.getColumnIndices();
+  const T* const csr_data = csr.getDataPtr();
+  destroyObjects();
+  m_buf.reset();
+  ArrayBasedDenseMatrix<T>::m_data = nullptr;
+  m_nrows = csr.getRowsNum();
+  m_ncolumns = csr.getColumnsNum();
+  ArrayBasedDenseMatrix<T>::m_stride = m_ncolumns;
+  m_chunk_height = ( chunk_height > 0 ? chunk_height : numeric::sell_chunk_height<T>() );
+  m_sigma = ( sigma > 0 ? sigma : 32 * m_chunk_height );
+  const size_t nchunks = getChunksNum();
+  //sort rows by length within every window of sigma rows, longest first
+  std::vector<size_t> permutation(nchunks*m_chunk_height);
+  for(size_t i = 0; i < permutation.size(); i++)
+    permutation[i] = std::min(i, m_nrows - 1);
+  auto length = [&](const size_t i) { return row_ptr[i+1] - row_ptr[i]; };
+  for(size_t w = 0; w < m_nrows; w += m_sigma)
+    std::stable_sort(permutation.begin() + w, permutation.begin() + std::min(m_nrows, w + m_sigma),
+      [&](const size_t l, const size_t r) { return length(l) > length(r); });
+  //width of every chunk is length of its longest row
+  std::vector<size_t> chunk_ptr(nchunks+1, 0);
+  for(size_t k = 0; k < nchunks; k++)
+  {
+    size_t width = 0;
+    for(size_t r = 0; r < m_chunk_height && k*m_chunk_height + r < m_nrows; r++)
+      width = std::max(width, length(permutation[k*m_chunk_height + r]));
+    chunk_ptr[k+1] = chunk_ptr[k] + width*m_chunk_height;
+  }
+  m_stored = chunk_ptr[nchunks];
+  m_chunk_ptr = nullptr;
+  ensureAllocated();
+  std::copy(chunk_ptr.begin(), chunk_ptr.end(), m_chunk_ptr);
+  std::copy(permutation.begin(), permutation.end(), m_permutation);
+  T* const data = getDataPtr();
+  for(size_t k = 0; k < nchunks; k++)
+  {
+    const size_t width = (chunk_ptr[k+1] - chunk_ptr[k]) / m_chunk_height;
+    for(size_t r = 0; r < m_chunk_height; r++)
+    {
+      const size_t pos = k*m_chunk_height + r;
+      const size_t i = permutation[pos];
+      //rows past the end of matrix are empty, padding repeats the last column of row to keep gathers in bounds
+      const size_t len = ( pos < m_nrows ? length(i) : 0 );
+      m_row_lengths[pos] = len;
+      for(size_t j = 0; j < width; j++)
+      {
+        const size_t idx = chunk_ptr[k] + j*m_chunk_height + r;
+        if(j < len)
+        {
+          new(data + idx) T(csr_data[row_ptr[i] + j]);
+          m_column_indices[idx] = csr_columns[row_ptr[i] + j];
+        } else {
+          new(data + idx) T(0);
+          m_column_indices[idx] = ( len > 0 ? csr_columns[row_ptr[i] + len - 1] : 0 );
+        }
+      }
+    }
+  }
+}
+
+template<typename T> void SELLMatrix<T>::init(InFileText& f, const bool readData, const bool transpose)
+{
+  CSRMatrix<T> csr(MatrixBase::m_storage);
+  csr.init(f, readData, transpose);
+  assignCSR(csr, m_chunk_height, m_sigma);
+}
+
+template<typename T> void SELLMatrix<T>::readFromFile(InFileText& f, const bool transpose)
+{
+  CSRMatrix<T> csr(m_nrows, m_ncolumns, 0, MatrixBase::m_storage);
+  csr.readFromFile(f, transpose);
+  assignCSR(csr, m_chunk_height, m_sigma);
+}
+
+template<typename T> void SELLMatrix<T>::writeToFile(OutFileText& f, const bool transpose, const int print_precision)
+{
+  std::vector<size_t> rows, columns;
+  std::vector<T> values;
+  for(size_t k = 0; k < getChunksNum(); k++)
+    for(size_t idx = m_chunk_ptr[k]; idx < m_chunk_ptr[k+1]; idx++)
+    {
+      //explicitly stored zeros are kept, padding is skipped
+      const size_t pos = k*m_chunk_height + idx % m_chunk_height;
+      if((idx - m_chunk_ptr[k]) / m_chunk_height < m_row_lengths[pos])
+      {
+        rows.push_back(m_permutation[pos]);
+        columns.push_back(m_column_indices[idx]);
+        values.push_back(getDataPtr()[idx]);
+      }
+    }
+  CSRMatrix<T> csr(MatrixBase::m_storage);
+  csr.assignTriplets(m_nrows, m_ncolumns, rows, columns, values);
+  csr.writeToFile(f, transpose, print_precision);
+}
+
 // data access
 // TODO: dispatch based on getFlavour()
 template<typename T> inline T* MatrixBase::getDataPtr() const
@@ -490,7 +1346,7 @@ template<typename T> inline const T MatrixBase::operator[](size_t idx) const
 struct CreateMatrixHelperArgs
 {
   enum InitType { FixedSize, FromFile, FromFileFixedSize } m_InitType;
-  size_t m_nrows, m_ncolumns, m_upper_band, m_lower_band;
+  size_t m_nrows, m_ncolumns, m_upper_band, m_lower_band, m_nnz;
   bool m_reset, m_transpose, m_readData;
   InFileText* m_pf;
   numeric::TMatrixStorage m_storage;
@@ -507,6 +1363,8 @@ template<CreateMatrixHelperArgs::InitType type> struct CreateMatrixHelperFunc :
     switch(a.m_flavour)
     {
       case TMatrixFlavour::Dense:
+        if(a.m_storage == numeric::TMatrixStorage::Tiled && a.m_type != TMatrixType::Array && a.m_type != TMatrixType::ValArray)
+          throw ParameterError("tiled storage is supported by array based matrices only");
         switch(type)
         {
           case CreateMatrixHelperArgs::FixedSize:
@@ -648,9 +1506,49 @@ template<CreateMatrixHelperArgs::InitType type> struct CreateMatrixHelperFunc :
             break;
         }
         return p;
+      case TMatrixFlavour::SymmetricBanded:
+        if(a.m_storage == numeric::TMatrixStorage::Tiled)
+          throw ParameterError("banded matrices have their own storage");
+        if(a.m_type != TMatrixType::Array)
+          throw ParameterError("matrix type unsupported");
+        switch(type)
+        {
+          case CreateMatrixHelperArgs::FixedSize:
+            if(a.m_nrows != a.m_ncolumns)
+              throw ParameterError("symmetric banded matrices should be square");
+            p = new SymmetricCDSBandedMatrix<T>(a.m_nrows,std::max(a.m_upper_band,a.m_lower_band),a.m_storage);
+            p -> init(a.m_reset, true);
+            break;
+          case CreateMatrixHelperArgs::FromFileFixedSize:
+          case CreateMatrixHelperArgs::FromFile:
+            p = new SymmetricCDSBandedMatrix<T>(a.m_storage);
+            p -> init(*a.m_pf,a.m_readData,a.m_transpose);
+            break;
+        }
+        return p;
+      case TMatrixFlavour::Sparse:
+        if(a.m_storage != numeric::TMatrixStorage::RowMajor)
+          throw ParameterError("sparse matrices are stored in row major order only");
+        if(a.m_type != TMatrixType::Array)
+          throw ParameterError("matrix type unsupported");
+        switch(type)
+        {
+          case CreateMatrixHelperArgs::FixedSize:
+            p = new CSRMatrix<T>(a.m_nrows,a.m_ncolumns,a.m_nnz,a.m_storage);
+            p -> init(a.m_reset, true);
+            break;
+          case CreateMatrixHelperArgs::FromFileFixedSize:
+            p = new CSRMatrix<T>(a.m_nrows,a.m_ncolumns,0,a.m_storage);
+            p -> init(*a.m_pf,a.m_readData,a.m_transpose);
+            break;
+          case CreateMatrixHelperArgs::FromFile:
+            p = new CSRMatrix<T>(a.m_storage);
+            p -> init(*a.m_pf,a.m_readData,a.m_transpose);
+            break;
+        }
+        return p;
 //      case TMatrixFlavour::Hessenberg:
 //      case TMatrixFlavour::Triangular:
-//      case TMatrixFlavour::Sparse:
       default:
         throw ParameterError("matrix type unsupported");
     }
@@ -666,11 +1564,24 @@ inline MatrixBase* NewMatrix(const numeric::TPrecision p, const size_t nrows, co
   args.m_InitType = CreateMatrixHelperArgs::FixedSize;
   args.m_nrows = nrows; args.m_ncolumns = ncolumns;
   args.m_upper_band = upper_band; args.m_lower_band = lower_band;
+  args.m_nnz = 0;
   args.m_reset = reset; args.m_storage = storage;
   args.m_type = type; args.m_flavour = flavour;
   return CreateMatrixHelperFunc<CreateMatrixHelperArgs::FixedSize>()(p,args);
 }
 
+inline MatrixBase* NewSparseMatrix(const numeric::TPrecision p, const size_t nrows, const size_t ncolumns, const size_t nnz)
+{
+  CreateMatrixHelperArgs args;
+  args.m_InitType = CreateMatrixHelperArgs::FixedSize;
+  args.m_nrows = nrows; args.m_ncolumns = ncolumns;
+  args.m_upper_band = 0; args.m_lower_band = 0;
+  args.m_nnz = nnz;
+  args.m_reset = true; args.m_storage = numeric::TMatrixStorage::RowMajor;
+  args.m_type = TMatrixType::Array; args.m_flavour = TMatrixFlavour::Sparse;
+  return CreateMatrixHelperFunc<CreateMatrixHelperArgs::FixedSize>()(p,args);
+}
+
 inline MatrixBase* NewMatrix(const numeric::TPrecision p, InFileText* pf, const bool readData,
   const bool transpose, const numeric::TMatrixStorage storage,  const TMatrixType type, const TMatrixFlavour flavour)
 {
@@ -678,6 +1589,7 @@ inline MatrixBase* NewMatrix(const numeric::TPrecision p, InFileText* pf, const
     return nullptr;
   CreateMatrixHelperArgs args;
   args.m_InitType = CreateMatrixHelperArgs::FromFile;
+  args.m_nnz = 0;
   args.m_pf = pf; args.m_readData = readData;
   args.m_transpose = transpose; args.m_storage = storage;
   args.m_type = type; args.m_flavour = flavour;
@@ -694,7 +1606,9 @@ inline MatrixBase* NewMatrix(const numeric::TPrecision p, const size_t nrows, co
   args.m_InitType = CreateMatrixHelperArgs::FromFileFixedSize;
   args.m_nrows = nrows; args.m_ncolumns = ncolumns;
   args.m_upper_band = upper_band; args.m_lower_band = lower_band;
-  args.m_pf = pf; args.m_transpose = transpose; args.m_storage = storage;
+  args.m_nnz = 0;
+  args.m_pf = pf; args.m_readData = true;
+  args.m_transpose = transpose; args.m_storage = storage;
   args.m_type = type; args.m_flavour = flavour;
   return CreateMatrixHelperFunc<CreateMatrixHelperArgs::FromFileFixedSize>()(p,args);
 }
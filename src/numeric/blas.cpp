@@ -30,6 +30,90 @@ namespace numeric {
     const size_t sz,\
     const TThreading threading_model)
 
+# define INSTANTIATE_dgemm_block_pack_a( X ) BlockPackedMatrix< X > dgemm_block_pack_a\
+    (const TMatrixStorage stor,\
+    const X * const __RESTRICT a,\
+    const size_t nrows_a, const size_t ncolumns_a)
+
+# define INSTANTIATE_dgemm_block_pack_b( X ) BlockPackedMatrix< X > dgemm_block_pack_b\
+    (const TMatrixStorage stor,\
+    const X * const __RESTRICT b,\
+    const size_t nrows_b, const size_t ncolumns_b)
+
+# define INSTANTIATE_dgemm_block_packed_a( X ) void dgemm_block\
+    (const BlockPackedMatrix< X >& a,\
+    const X * const __RESTRICT b, X * const __RESTRICT c,\
+    const size_t nrows_b, const size_t ncolumns_b,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_block_packed_b( X ) void dgemm_block\
+    (const X * const __RESTRICT a,\
+    const BlockPackedMatrix< X >& b, X * const __RESTRICT c,\
+    const size_t nrows_a, const size_t ncolumns_a,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_batched( X ) void dgemm_batched\
+    (const TMatrixStorage stor,\
+    const X * const * const a, const X * const * const b, X * const * const c,\
+    const size_t nrows_a, const size_t ncolumns_a,\
+    const size_t nrows_b, const size_t ncolumns_b,\
+    const size_t batch,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_batched_strided( X ) void dgemm_batched\
+    (const TMatrixStorage stor,\
+    const X * const __RESTRICT a, const size_t stride_a,\
+    const X * const __RESTRICT b, const size_t stride_b,\
+    X * const __RESTRICT c, const size_t stride_c,\
+    const size_t nrows_a, const size_t ncolumns_a,\
+    const size_t nrows_b, const size_t ncolumns_b,\
+    const size_t batch,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_recursive( X ) void dgemm_recursive\
+    (const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,\
+    const X * const __RESTRICT a, const X * const __RESTRICT b, X * const __RESTRICT c,\
+    const size_t nrows_a, const size_t ncolumns_a,\
+    const size_t nrows_b, const size_t ncolumns_b,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_recursive_square( X ) void dgemm_recursive(\
+    const TMatrixStorage stor,\
+    const X * const __RESTRICT a, const X * const __RESTRICT b, X * const __RESTRICT c,\
+    const size_t sz,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_dgemm_strassen( X ) void dgemm_strassen\
+    (const TMatrixStorage stor,\
+    const X * const __RESTRICT a, const X * const __RESTRICT b, X * const __RESTRICT c,\
+    const size_t nrows_a, const size_t ncolumns_a,\
+    const size_t nrows_b, const size_t ncolumns_b,\
+    const TThreading threading_model,\
+    const size_t cutoff)
+
+# define INSTANTIATE_dgemm_strassen_square( X ) void dgemm_strassen(\
+    const TMatrixStorage stor,\
+    const X * const __RESTRICT a, const X * const __RESTRICT b, X * const __RESTRICT c,\
+    const size_t sz,\
+    const TThreading threading_model,\
+    const size_t cutoff)
+
+# define INSTANTIATE_gemm( X ) void gemm\
+    (const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,\
+    const size_t m, const size_t n, const size_t k,\
+    const X alpha, const X * const __RESTRICT a, const size_t lda,\
+    const X * const __RESTRICT b, const size_t ldb,\
+    const X beta, X * const __RESTRICT c, const size_t ldc,\
+    const TThreading threading_model)
+
+# define INSTANTIATE_gemv( X ) void gemv\
+    (const TMatrixStorage stor, const TMatrixTranspose transA,\
+    const size_t m, const size_t n,\
+    const X alpha, const X * const __RESTRICT a, const size_t lda,\
+    const X * const __RESTRICT x, const size_t incx,\
+    const X beta, X * const __RESTRICT y, const size_t incy,\
+    const TThreading threading_model)
+
   INSTANTIATE_dgemm(float);
   INSTANTIATE_dgemm_square(float);
   INSTANTIATE_dgemm(double);
@@ -60,4 +144,93 @@ namespace numeric {
     INSTANTIATE_dgemm_block_square(mpreal);
 # endif
 
+  INSTANTIATE_dgemm_block_pack_a(float);
+  INSTANTIATE_dgemm_block_pack_b(float);
+  INSTANTIATE_dgemm_block_packed_a(float);
+  INSTANTIATE_dgemm_block_packed_b(float);
+  INSTANTIATE_dgemm_block_pack_a(double);
+  INSTANTIATE_dgemm_block_pack_b(double);
+  INSTANTIATE_dgemm_block_packed_a(double);
+  INSTANTIATE_dgemm_block_packed_b(double);
+  INSTANTIATE_dgemm_block_pack_a(long double);
+  INSTANTIATE_dgemm_block_pack_b(long double);
+  INSTANTIATE_dgemm_block_packed_a(long double);
+  INSTANTIATE_dgemm_block_packed_b(long double);
+# ifdef HAVE_QUADMATH
+    INSTANTIATE_dgemm_block_pack_a(quad);
+    INSTANTIATE_dgemm_block_pack_b(quad);
+    INSTANTIATE_dgemm_block_packed_a(quad);
+    INSTANTIATE_dgemm_block_packed_b(quad);
+# endif
+# ifdef HAVE_MPREAL
+    INSTANTIATE_dgemm_block_pack_a(mpreal);
+    INSTANTIATE_dgemm_block_pack_b(mpreal);
+    INSTANTIATE_dgemm_block_packed_a(mpreal);
+    INSTANTIATE_dgemm_block_packed_b(mpreal);
+# endif
+
+  INSTANTIATE_dgemm_batched(float);
+  INSTANTIATE_dgemm_batched_strided(float);
+  INSTANTIATE_dgemm_batched(double);
+  INSTANTIATE_dgemm_batched_strided(double);
+  INSTANTIATE_dgemm_batched(long double);
+  INSTANTIATE_dgemm_batched_strided(long double);
+# ifdef HAVE_QUADMATH
+    INSTANTIATE_dgemm_batched(quad);
+    INSTANTIATE_dgemm_batched_strided(quad);
+# endif
+# ifdef HAVE_MPREAL
+    INSTANTIATE_dgemm_batched(mpreal);
+    INSTANTIATE_dgemm_batched_strided(mpreal);
+# endif
+
+  INSTANTIATE_dgemm_recursive(float);
+  INSTANTIATE_dgemm_recursive_square(float);
+  INSTANTIATE_dgemm_recursive(double);
+  INSTANTIATE_dgemm_recursive_square(double);
+  INSTANTIATE_dgemm_recursive(long double);
+  INSTANTIATE_dgemm_recursive_square(long double);
+# ifdef HAVE_QUADMATH
+    INSTANTIATE_dgemm_recursive(quad);
+    INSTANTIATE_dgemm_recursive_square(quad);
+# endif
+# ifdef HAVE_MPREAL
+    INSTANTIATE_dgemm_recursive(mpreal);
+    INSTANTIATE_dgemm_recursive_square(mpreal);
+# endif
+
+  INSTANTIATE_dgemm_strassen(float);
+  INSTANTIATE_dgemm_strassen_square(float);
+  INSTANTIATE_dgemm_strassen(double);
+  INSTANTIATE_dgemm_strassen_square(double);
+  INSTANTIATE_dgemm_strassen(long double);
+  INSTANTIATE_dgemm_strassen_square(long double);
+# ifdef HAVE_QUADMATH
+    INSTANTIATE_dgemm_strassen(quad);
+    INSTANTIATE_dgemm_strassen_square(quad);
+# endif
+# ifdef HAVE_MPREAL
+    INSTANTIATE_dgemm_strassen(mpreal);
+    INSTANTIATE_dgemm_strassen_square(mpreal);
+# endif
+
+  INSTANTIATE_gemm(float);
+  INSTANTIATE_gemv(float);
+  INSTANTIATE_gemm(double);
+  INSTANTIATE_gemv(double);
+  INSTANTIATE_gemm(long double);
+  INSTANTIATE_gemv(long double);
+# ifdef HAVE_QUADMATH
+    INSTANTIATE_gemm(quad);
+    INSTANTIATE_gemv(quad);
+# endif
+# ifdef HAVE_MPREAL
+    INSTANTIATE_gemm(mpreal);
+    INSTANTIATE_gemv(mpreal);
+# endif
+  INSTANTIATE_gemm(std::complex<float>);
+  INSTANTIATE_gemv(std::complex<float>);
+  INSTANTIATE_gemm(std::complex<double>);
+  INSTANTIATE_gemv(std::complex<double>);
+
 }
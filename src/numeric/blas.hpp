@@ -6,17 +6,45 @@
 #include "numeric/parallel.hpp"
 
 #include <cstddef>
+#include <stdexcept>
+#include <string>
 
 using std::size_t;
 
 namespace numeric
 {
 
-enum class TMatrixStorage { RowMajor, ColumnMajor };
+//Tiled: square tiles in row major order, tiles in Morton-like order, see blas_recursive_impl.hpp
+enum class TMatrixStorage { RowMajor, ColumnMajor, Tiled };
 enum class TMatrixTranspose : char { No='N', Transpose='T', Conjugate='C' };
+enum class TMatrixSide : char { Left='L', Right='R' };
+enum class TMatrixTriangle : char { Upper='U', Lower='L' };
+enum class TMatrixDiagonal : char { NonUnit='N', Unit='U' };
 enum class TMM_Algo : int { IJK=0, JKI, KIJ, IKJ, KJI, JIK };
 
+//routines working on submatrices given by leading dimensions, on banded or on packed matrices can't take tiled storage,
+//output would be left unwritten, so they fail loudly instead
+[[noreturn]] inline void __storage_unsupported(const char* const routine)
+{
+  throw std::invalid_argument(std::string(routine) + ": tiled storage is not supported");
+}
+
+//routines taking inner dimension of product twice(or once along with prepacked operand) would read out of bounds on mismatch
+inline void __check_inner_dimension(const char* const routine, const size_t ncolumns_a, const size_t nrows_b)
+{
+  if(ncolumns_a != nrows_b)
+    throw std::invalid_argument(std::string(routine) + ": inner dimensions of operands do not match");
+}
+
+//size of square tiles of tiled storage
+constexpr inline size_t tiled_tile_size() { return 128; }
+//number of elements of matrix in tiled storage, padding included
+inline size_t tiled_stored_size(const size_t nrows, const size_t ncolumns);
+//index of element (i,j) of matrix in tiled storage
+inline size_t tiled_index(const size_t nrows, const size_t ncolumns, const size_t i, const size_t j);
+
 //generic version of dgemm, C=op(A)*op(B)
+//complex matrices in row or column major order are multiplied by gemm, i.e. by 3M method or interleaved simd kernel
 template<typename T>
   void dgemm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
       const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
@@ -46,6 +74,124 @@ template<typename T>
     const size_t sz,
     const TThreading threading_model = T_Serial);
 
+//matrix packed once into internal layout of block dgemm, see blas_block_impl.hpp
+template<typename T> class BlockPackedMatrix;
+
+//pack left operand of block dgemm, so that it could be reused in many products without repacking
+template<typename T>
+  BlockPackedMatrix<T> dgemm_block_pack_a(const TMatrixStorage stor,
+      const T* const __RESTRICT a,
+      const size_t nrows_a, const size_t ncolumns_a);
+
+//pack right operand of block dgemm, so that it could be reused in many products without repacking
+template<typename T>
+  BlockPackedMatrix<T> dgemm_block_pack_b(const TMatrixStorage stor,
+      const T* const __RESTRICT b,
+      const size_t nrows_b, const size_t ncolumns_b);
+
+//block version of reduced dgemm with prepacked left operand, C=A*B
+//B and C are in the same storage order A was packed with
+template<typename T>
+  void dgemm_block(const BlockPackedMatrix<T>& a,
+      const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model = T_Serial);
+
+//block version of reduced dgemm with prepacked right operand, C=A*B
+//A and C are in the same storage order B was packed with
+template<typename T>
+  void dgemm_block(const T* const __RESTRICT a,
+      const BlockPackedMatrix<T>& b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const TThreading threading_model = T_Serial);
+
+//batched version of reduced dgemm for many small matrices, C[i]+=A[i]*B[i] for i in [0,batch)
+//matrices of batch are given by arrays of pointers
+template<typename T>
+  void dgemm_batched(const TMatrixStorage stor,
+      const T* const* const a, const T* const* const b, T* const* const c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const size_t batch,
+      const TThreading threading_model = T_Serial);
+
+//batched version of reduced dgemm for many small matrices, C[i]+=A[i]*B[i] for i in [0,batch)
+//matrices of batch are placed at constant distance from each other, X[i] = x + i*stride_x
+template<typename T>
+  void dgemm_batched(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const size_t stride_a,
+      const T* const __RESTRICT b, const size_t stride_b,
+      T* const __RESTRICT c, const size_t stride_c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const size_t batch,
+      const TThreading threading_model = T_Serial);
+
+//cache oblivious recursive version of dgemm, C+=op(A)*op(B), other dense products delegate tiled matrices to it
+template<typename T>
+  void dgemm_recursive(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model = T_Serial);
+
+//cache oblivious recursive version of reduced dgemm for square matrices
+template<typename T>
+  void dgemm_recursive(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t sz,
+      const TThreading threading_model = T_Serial);
+
+//Strassen-Winograd version of reduced dgemm, C=A*B
+//recursion stops when any dimension is below cutoff(0 selects default value), rest is done by block dgemm
+template<typename T>
+  void dgemm_strassen(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model = T_Serial,
+      const size_t cutoff = 0);
+
+//Strassen-Winograd version of reduced dgemm for square matrices
+template<typename T>
+  void dgemm_strassen(const TMatrixStorage stor,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz,
+    const TThreading threading_model = T_Serial,
+    const size_t cutoff = 0);
+
+//BLAS-like gemm for submatrices, C = alpha*op(A)*op(B) + beta*C
+//op(A) is m x k, op(B) is k x n, C is m x n, lda, ldb and ldc are leading dimensions of A, B and C
+//complex matrices are multiplied by 3M method(three real block products) or by interleaved simd kernel for small sizes
+template<typename T>
+  void gemm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const size_t m, const size_t n, const size_t k,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      const T* const __RESTRICT b, const size_t ldb,
+      const T beta, T* const __RESTRICT c, const size_t ldc,
+      const TThreading threading_model = T_Serial);
+
+//BLAS-like gemv for submatrices and strided vectors, y = alpha*op(A)*x + beta*y
+//A is m x n, lda is leading dimension of A, incx and incy are strides of x and y
+template<typename T>
+  void gemv(const TMatrixStorage stor, const TMatrixTranspose transA,
+      const size_t m, const size_t n,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      const T* const __RESTRICT x, const size_t incx,
+      const T beta, T* const __RESTRICT y, const size_t incy,
+      const TThreading threading_model = T_Serial);
+
+//BLAS-like trsm for submatrices, op(A)*X = alpha*B(left side) or X*op(A) = alpha*B(right side), X overwrites B
+//A is triangular m x m(left side) or n x n(right side) matrix, B is m x n, only triangle uplo of A is referenced
+//and its diagonal is assumed to be unit if diag is Unit. columns(left side) or rows(right side) of B are split between workers
+template<typename T>
+  void trsm(const TMatrixStorage stor, const TMatrixSide side, const TMatrixTriangle uplo,
+      const TMatrixTranspose transA, const TMatrixDiagonal diag,
+      const size_t m, const size_t n,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      T* const __RESTRICT b, const size_t ldb,
+      const TThreading threading_model = T_Serial);
+
 //generic dgbmv, y = \beta*y + \alpha*op(A)*x
 template<typename T>
   void dgemv(const TMatrixStorage stor, const TMatrixTranspose transA,
@@ -79,8 +225,8 @@ template<typename T>
   bool is_diagonally_dominant(const size_t sz, const size_t stride,
       const T* const __RESTRICT a);
 
-//generic dgbmm for banded matrices, C+=op(A)*op(B)
-//TODO:STUB! only tridiagonal matrices at the moment
+//generic dgbmm for banded matrices in CDS format, C+=op(A)*op(B)
+//band widths of C should be sums of band widths of op(A) and op(B)
 template<typename T>
   void dgbmm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
       const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
@@ -95,8 +241,23 @@ template<typename T>
     const size_t sz, const size_t band,
     const TThreading threading_model = T_Serial);
 
-//generic dgbmv for banded matrices, y+=op(A)*x
-//TODO:STUB! only tridiagonal matrices at the moment
+//diagonal-wise(Madsen-Rodrigue-Karush) dgbmm for banded matrices in CDS format, C+=op(A)*op(B)
+//band widths of C should be sums of band widths of op(A) and op(B)
+template<typename T>
+  void dgbmm_mrk(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a, const size_t upper_band_a, const size_t lower_band_a,
+      const size_t nrows_b, const size_t ncolumns_b, const size_t upper_band_b, const size_t lower_band_b,
+      const TThreading threading_model = T_Serial);
+
+//diagonal-wise dgbmm for square symmetrically banded matrices
+template<typename T>
+  void dgbmm_mrk(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model = T_Serial);
+
+//generic dgbmv for banded matrices in CDS format, y+=\alpha*op(A)*x
 template<typename T>
   void dgbmv(const TMatrixStorage stor, const TMatrixTranspose transA,
       const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
@@ -112,6 +273,54 @@ template<typename T>
     const T alpha = T(1.0),
     const TThreading threading_model = T_Serial);
 
+//symmetric banded matrices are stored in symmetric CDS format: row i keeps elements X(i,i+p), p in [0,band+1),
+//i.e. diagonal and upper bands only, elements outside of matrix are padding. the same array is column major CDS storage
+//of lower bands, so storage argument doesn't change layout, tiled storage isn't supported
+
+//dsbmv for symmetric banded matrices, y+=\alpha*A*x
+template<typename T>
+  void dsbmv(const TMatrixStorage stor,
+    const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
+    const size_t sz, const size_t band,
+    const T alpha = T(1.0),
+    const TThreading threading_model = T_Serial);
+
+//C+=op(A)*op(B) for square symmetrically banded A and B in CDS format, when product is known to be symmetric,
+//like Q'*W*Q. only diagonal and upper bands of C are computed, C is in symmetric CDS format with band width 2*band
+template<typename T>
+  void dsbmm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model = T_Serial);
+
+//sparse matrix in CSR format times vector, y+=\alpha*A*x
+//row i of A is a[row_ptr[i]..row_ptr[i+1]) with columns column_indices[row_ptr[i]..row_ptr[i+1])
+template<typename T>
+  void dcsrmv(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT row_ptr,
+      const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t nrows_a,
+      const T alpha = T(1.0),
+      const TThreading threading_model = T_Serial);
+
+//sparse matrix in CSR format times dense matrix in row major order(multiple right hand sides), C+=\alpha*A*B
+template<typename T>
+  void dcsrmm(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT row_ptr,
+      const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_b,
+      const T alpha = T(1.0),
+      const TThreading threading_model = T_Serial);
+
+//sparse matrix in SELL-C-sigma format times vector, y+=\alpha*A*x
+//rows are sorted by length within windows of sigma rows and grouped into chunks of chunk_height rows,
+//chunk k is stored column by column in a[chunk_ptr[k]..chunk_ptr[k+1]), row r of chunk k is row permutation[k*chunk_height+r] of A
+template<typename T>
+  void dsellmv(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT chunk_ptr,
+      const size_t* const __RESTRICT permutation,
+      const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t nrows_a, const size_t chunk_height,
+      const T alpha = T(1.0),
+      const TThreading threading_model = T_Serial);
+
 //add for banded matrices, a += b, assuming that band width of b is less or equal than that of a
 template<typename T>
   void banded_add(const TMatrixStorage stor,
@@ -139,6 +348,15 @@ template<typename T>
     const size_t band_b,
     const TThreading threading_model = T_Serial);
 
+//add for symmetric banded matrices in symmetric CDS format, a += b, assuming that band width of b is equal or less than that of a
+template<typename T>
+  void symmetric_banded_add(const TMatrixStorage stor,
+    T* const __RESTRICT a, const T* const __RESTRICT b,
+    const size_t sz,
+    const size_t band_a,
+    const size_t band_b,
+    const TThreading threading_model = T_Serial);
+
 //test for diagonal dominance for banded matrices
 template<typename T>
   bool is_banded_diagonally_dominant(const size_t sz,
@@ -155,7 +373,19 @@ template<typename T>
 #include "numeric/blas_impl.hpp"
 //block implementation based on paper "Anatomy of High-Performance Matrix Multiplication" by Kazushige Goto
 #include "numeric/blas_block_impl.hpp"
+//batched implementation with compile time sized kernels for small matrices
+#include "numeric/blas_batched_impl.hpp"
+//cache oblivious recursive implementation and tiled storage
+#include "numeric/blas_recursive_impl.hpp"
+//Strassen-Winograd implementation with block dgemm for small subproblems
+#include "numeric/blas_strassen_impl.hpp"
+//3M and interleaved implementations for complex matrices, used by gemm
+#include "numeric/blas_complex_impl.hpp"
+//BLAS-like gemm, gemv and trsm for submatrices, based on block implementation
+#include "numeric/blas_gemm_impl.hpp"
 //simple ijk implementation for banded matrices in CDS format
 #include "numeric/blas_banded_impl.hpp"
+//row parallel implementation for sparse matrices in CSR format
+#include "numeric/blas_sparse_impl.hpp"
 
 #endif /* _BLAS_HPP */
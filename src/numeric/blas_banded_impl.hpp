@@ -8,6 +8,8 @@
 #include "numeric/complex.hpp"
 #include "numeric/parallel.hpp"
 #include "numeric/cache.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_block_impl.hpp"
 
 #ifdef HAVE_CILK
 #include <cilk/cilk.h>
@@ -18,366 +20,217 @@
 #endif
 
 #include <cstddef>
+#include <algorithm>
+#include <vector>
 
 using std::size_t;
 
 namespace numeric {
 
-//helper for simple serial banded matrix multiplication
-template<typename T, bool tA, bool tB, bool cA, bool cB>
-  __FORCEINLINE inline void _gbmm_op(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t stride_a, const size_t stride_b, const size_t stride_c,
-    const size_t i, const size_t j, const size_t k)
-{
-  //if nothing's transposed, do c(i,k) += a(i,j) * b(j,k)
-  //transpose option switches corresponding indices. tA: a(i,j) -> a(j,i), tB: b(j,k) -> b(k,j)
-  //TODO: STUB!
-}
+//banded matrices are stored in CDS format: row i of X keeps elements X(i,i-lower_band+p), p in [0,upper_band+lower_band+1),
+//only first min(nrows,ncolumns) rows are stored, elements outside of matrix are padding and are never read or written.
+//row i of X' consists of elements of column i of X, so it is stored along antidiagonal with step stride-1.
+//op(X) is described by its own bands, for X' they're swapped, and by limits of its stored rows and columns,
+//for X they're min(nrows,ncolumns) and ncolumns, for X' - nrows and min(nrows,ncolumns)
 
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void tridiagonal_matmul_serial(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t rows)
-{
-  //TODO: transposed variants
-  //preunrolled tridiagonal algo
-  //i=0
-  {
-    //j=0
-    //c[1] += a[1] * b[0]; // == 0
-    c[2] += a[1] * b[1];
-    c[3] += a[1] * b[2];
-    //j=1
-    c[2] += a[2] * b[3];
-    c[3] += a[2] * b[4];
-    c[4] += a[2] * b[5];
-  }
-  for(size_t i = 1; i < rows - 1; i++)
-    for(int j = 0; j < 3; j++)
-      for(int k = 0; k < 3; k++)
-        c[5*i+j+k] += a[3*i+j] * b[3*(i+j-1)+k];
-  //i=rows-1
-  if(rows > 1)
-  {
-    //j=0
-    c[5*(rows-1)+0] += a[3*(rows-1)] * b[3*(rows-2)+0];
-    c[5*(rows-1)+1] += a[3*(rows-1)] * b[3*(rows-2)+1];
-    c[5*(rows-1)+2] += a[3*(rows-1)] * b[3*(rows-2)+2];
-    //j=1
-    c[5*(rows-1)+1] += a[3*(rows-1)+1] * b[3*(rows-2)+3];
-    c[5*(rows-1)+2] += a[3*(rows-1)+1] * b[3*(rows-2)+4];
-    //c[5*(rows-1)+3] += a[3*(rows-1)+1] * b[3*(rows-1)+2] // == 0
-  }
+//element p of row i of op(X), i.e. op(X)(i,i-lower_band_op+p), caller guarantees that it exists
+template<typename T, bool t, bool c>
+  __FORCEINLINE inline T _gb_op(const T* const  __RESTRICT x, const size_t stride, const size_t lower_band_op,
+    const size_t i, const size_t p)
+{
+  const T v = ( t ? x[(i+p-lower_band_op)*stride+stride-1-p] : x[i*stride+p] );
+  return ( c ? conj<T>(v) : v );
 }
 
-#ifdef HAVE_OPENMP
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void tridiagonal_matmul_openmp(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t rows)
-{
-  //TODO: transposed variants
-  //preunrolled tridiagonal algo
-  //i=0
-  {
-    //j=0
-    //c[1] += a[1] * b[0]; // == 0
-    c[2] += a[1] * b[1];
-    c[3] += a[1] * b[2];
-    //j=1
-    c[2] += a[2] * b[3];
-    c[3] += a[2] * b[4];
-    c[4] += a[2] * b[5];
-  }
-#pragma omp parallel for
-  for(size_t i = 1; i < rows - 1; i++)
-  {
-    for(int j = 0; j < 3; j++)
-      for(int k = 0; k < 3; k++)
-        c[5*i+j+k] += a[3*i+j] * b[3*(i+j-1)+k];
-  }
-  //i=rows-1
-  if(rows > 1)
+//rows [begin,end) of C+=op(A)*op(B) for banded matrices of any band width, only existing elements are used.
+//band widths of C are sums of those of op(A) and op(B), so c(i,p+q) += a(i,p)*b(i-lower_band_op_a+p,q),
+//inner loop runs along row of op(B) and C, i.e. across their diagonals, so it is vectorized for wide bands
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void banded_matmul_rows_clipped(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t stride_a, const size_t lower_band_op_a, const size_t columns_lim_op_a,
+    const size_t stride_b, const size_t lower_band_op_b, const size_t rows_lim_op_b, const size_t columns_lim_op_b,
+    const size_t begin, const size_t end)
+{
+  const size_t stride_c = stride_a + stride_b - 1;
+  //rows of op(B) that can be multiplied with elements of op(A)
+  const size_t r_lim = std::min(columns_lim_op_a, rows_lim_op_b) + lower_band_op_a;
+  for(size_t i = begin; i < end; i++)
   {
-    //j=0
-    c[5*(rows-1)+0] += a[3*(rows-1)] * b[3*(rows-2)+0];
-    c[5*(rows-1)+1] += a[3*(rows-1)] * b[3*(rows-2)+1];
-    c[5*(rows-1)+2] += a[3*(rows-1)] * b[3*(rows-2)+2];
-    //j=1
-    c[5*(rows-1)+1] += a[3*(rows-1)+1] * b[3*(rows-2)+3];
-    c[5*(rows-1)+2] += a[3*(rows-1)+1] * b[3*(rows-2)+4];
-    //c[5*(rows-1)+3] += a[3*(rows-1)+1] * b[3*(rows-1)+2] // == 0
+    const size_t p_begin = ( lower_band_op_a > i ? lower_band_op_a - i : 0 );
+    const size_t p_end = ( r_lim > i ? std::min(stride_a, r_lim - i) : 0 );
+    for(size_t p = p_begin; p < p_end; p++)
+    {
+      const size_t r = i + p - lower_band_op_a;
+      const T a_ip = _gb_op<T,tA,cA>(a,stride_a,lower_band_op_a,i,p);
+      const size_t q_begin = ( lower_band_op_b > r ? lower_band_op_b - r : 0 );
+      const size_t q_end = ( columns_lim_op_b + lower_band_op_b > r ? std::min(stride_b, columns_lim_op_b + lower_band_op_b - r) : 0 );
+      T* const __RESTRICT c_ip = c + i*stride_c + p;
+      for(size_t q = q_begin; q < q_end; q++)
+        c_ip[q] += a_ip * _gb_op<T,tB,cB>(b,stride_b,lower_band_op_b,r,q);
+    }
   }
 }
 
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void banded_matmul_openmp(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
-    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b)
-{
-  if( (upper_band_op_a == upper_band_op_b) &&
-      (upper_band_op_a == lower_band_op_a) &&
-      (upper_band_op_b == lower_band_op_b) &&
-      (upper_band_op_a == 1) &&
-      (nrows_op_a == ncolumns_op_a) &&
-      (ncolumns_op_a == ncolumns_op_b)
-    )
-  {
-    //product of square tridiagonal matrices
-    return tridiagonal_matmul_openmp<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a);
-  } else {
-    //TODO: STUB!
-  }
-/*
-  switch(tAlgo)
-  {
-    case TMM_Algo::IJK:
-          _gbmm_op<T,tA,tB,ccA,ccB>(a,b,c,ncolumns_op_a,ncolumns_op_b,ncolumns_op_b,i,j,k);
-      return;
-    case TMM_Algo::JKI:
-      return;
-    case TMM_Algo::KIJ:
-      return;
-    case TMM_Algo::IKJ:
-      return;
-    case TMM_Algo::KJI:
-      return;
-    case TMM_Algo::JIK:
-      return;
-  }
-*/
+//rows [begin,end) of C, where all elements of rows of op(A) and op(B) exist
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void banded_matmul_rows_full(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t stride_a, const size_t lower_band_op_a, const size_t stride_b, const size_t lower_band_op_b,
+    const size_t begin, const size_t end)
+{
+  const size_t stride_c = stride_a + stride_b - 1;
+  for(size_t i = begin; i < end; i++)
+    for(size_t p = 0; p < stride_a; p++)
+    {
+      const size_t r = i + p - lower_band_op_a;
+      const T a_ip = _gb_op<T,tA,cA>(a,stride_a,lower_band_op_a,i,p);
+      T* const __RESTRICT c_ip = c + i*stride_c + p;
+      for(size_t q = 0; q < stride_b; q++)
+        c_ip[q] += a_ip * _gb_op<T,tB,cB>(b,stride_b,lower_band_op_b,r,q);
+    }
 }
-#endif
 
-#ifdef HAVE_CILK
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void tridiagonal_matmul_cilk(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t rows)
-{
-  //TODO: transposed variants
-  //preunrolled tridiagonal algo
-  //i=0
-  {
-    //j=0
-    //c[1] += a[1] * b[0]; // == 0
-    c[2] += a[1] * b[1];
-    c[3] += a[1] * b[2];
-    //j=1
-    c[2] += a[2] * b[3];
-    c[3] += a[2] * b[4];
-    c[4] += a[2] * b[5];
-  }
-  cilk_for(size_t i = 1; i < rows - 1; i++)
-    for(int j = 0; j < 3; j++)
-      for(int k = 0; k < 3; k++)
-        c[5*i+j+k] += a[3*i+j] * b[3*(i+j-1)+k];
-  //i=rows-1
-  if(rows > 1)
-  {
-    //j=0
-    c[5*(rows-1)+0] += a[3*(rows-1)] * b[3*(rows-2)+0];
-    c[5*(rows-1)+1] += a[3*(rows-1)] * b[3*(rows-2)+1];
-    c[5*(rows-1)+2] += a[3*(rows-1)] * b[3*(rows-2)+2];
-    //j=1
-    c[5*(rows-1)+1] += a[3*(rows-1)+1] * b[3*(rows-2)+3];
-    c[5*(rows-1)+2] += a[3*(rows-1)+1] * b[3*(rows-2)+4];
-    //c[5*(rows-1)+3] += a[3*(rows-1)+1] * b[3*(rows-1)+2] // == 0
+//same for compile time band widths of matrices that aren't transposed, so loops are fully unrolled
+template<typename T, size_t SA, size_t SB>
+  inline void banded_matmul_rows_full(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t lower_band_a, const size_t begin, const size_t end)
+{
+  const size_t SC = SA + SB - 1;
+  for(size_t i = begin; i < end; i++)
+  {
+    const T* const __RESTRICT a_i = a + i*SA;
+    const T* const __RESTRICT b_r = b + (i-lower_band_a)*SB;
+    T c_i[SC];
+    for(size_t x = 0; x < SC; x++)
+      c_i[x] = c[i*SC+x];
+    for(size_t p = 0; p < SA; p++)
+      for(size_t q = 0; q < SB; q++)
+        c_i[p+q] += a_i[p] * b_r[p*SB+q];
+    for(size_t x = 0; x < SC; x++)
+      c[i*SC+x] = c_i[x];
   }
 }
 
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void banded_matmul_cilk(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
-    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b)
-{
-  if( (upper_band_op_a == upper_band_op_b) &&
-      (upper_band_op_a == lower_band_op_a) &&
-      (upper_band_op_b == lower_band_op_b) &&
-      (upper_band_op_a == 1) &&
-      (nrows_op_a == ncolumns_op_a) &&
-      (ncolumns_op_a == ncolumns_op_b)
-    )
-  {
-    //product of square tridiagonal matrices
-    return tridiagonal_matmul_cilk<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a);
-  } else {
-    //TODO: STUB!
-  }
-/*
-  switch(tAlgo)
-  {
-    case TMM_Algo::IJK:
-          _gbmm_op<T,tA,tB,ccA,ccB>(a,b,c,ncolumns_op_a,ncolumns_op_b,ncolumns_op_b,i,j,k);
-      return;
-    case TMM_Algo::JKI:
-      return;
-    case TMM_Algo::KIJ:
-      return;
-    case TMM_Algo::IKJ:
-      return;
-    case TMM_Algo::KJI:
-      return;
-    case TMM_Algo::JIK:
-      return;
-  }
-*/
-}
-#endif
-
-#ifdef HAVE_TBB
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void tridiagonal_matmul_tbb(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
-    const size_t rows)
-{
-  //TODO: transposed variants
-  //preunrolled tridiagonal algo
-  //i=0
-  {
-    //j=0
-    //c[1] += a[1] * b[0]; // == 0
-    c[2] += a[1] * b[1];
-    c[3] += a[1] * b[2];
-    //j=1
-    c[2] += a[2] * b[3];
-    c[3] += a[2] * b[4];
-    c[4] += a[2] * b[5];
-  }
-  parallelForElem( size_t(1), rows - 1,
-      [&a,&b,&c](size_t i)
-      {
-        for(int j = 0; j < 3; j++)
-          for(int k = 0; k < 3; k++)
-            c[5*i+j+k] += a[3*i+j] * b[3*(i+j-1)+k];
-      });
-  //i=rows-1
-  if(rows > 1)
+//rows [begin,end) of C+=op(A)*op(B), rows near matrix edges are clipped
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void banded_matmul_rows(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t stride_a, const size_t lower_band_op_a, const size_t columns_lim_op_a,
+    const size_t stride_b, const size_t lower_band_op_b, const size_t rows_lim_op_b, const size_t columns_lim_op_b,
+    const size_t begin, const size_t end)
+{
+  //interior rows [full_begin,full_end) use full rows of op(A) and full rows of op(B) multiplied by them
+  const size_t full_begin = std::min(end, std::max(begin, lower_band_op_a + lower_band_op_b));
+  const size_t r_lim = std::min(columns_lim_op_a, rows_lim_op_b);
+  const size_t c_lim = columns_lim_op_b + lower_band_op_b + 1;
+  const size_t full_lim = std::min(r_lim + 1, ( c_lim > stride_b ? c_lim - stride_b : 0 )) + lower_band_op_a;
+  const size_t full_end = std::max(full_begin, std::min(end, ( full_lim > stride_a ? full_lim - stride_a : 0 )));
+  banded_matmul_rows_clipped<T,tA,tB,cA,cB>(a,b,c,stride_a,lower_band_op_a,columns_lim_op_a,
+    stride_b,lower_band_op_b,rows_lim_op_b,columns_lim_op_b,begin,full_begin);
+  const bool plain = !tA && !tB && !cA && !cB && stride_a == stride_b;
+  switch( plain ? stride_a : 0 )
   {
-    //j=0
-    c[5*(rows-1)+0] += a[3*(rows-1)] * b[3*(rows-2)+0];
-    c[5*(rows-1)+1] += a[3*(rows-1)] * b[3*(rows-2)+1];
-    c[5*(rows-1)+2] += a[3*(rows-1)] * b[3*(rows-2)+2];
-    //j=1
-    c[5*(rows-1)+1] += a[3*(rows-1)+1] * b[3*(rows-2)+3];
-    c[5*(rows-1)+2] += a[3*(rows-1)+1] * b[3*(rows-2)+4];
-    //c[5*(rows-1)+3] += a[3*(rows-1)+1] * b[3*(rows-1)+2] // == 0
+    case 3:
+      banded_matmul_rows_full<T,3,3>(a,b,c,lower_band_op_a,full_begin,full_end);
+      break;
+    case 5:
+      banded_matmul_rows_full<T,5,5>(a,b,c,lower_band_op_a,full_begin,full_end);
+      break;
+    case 7:
+      banded_matmul_rows_full<T,7,7>(a,b,c,lower_band_op_a,full_begin,full_end);
+      break;
+    case 9:
+      banded_matmul_rows_full<T,9,9>(a,b,c,lower_band_op_a,full_begin,full_end);
+      break;
+    default:
+      banded_matmul_rows_full<T,tA,tB,cA,cB>(a,b,c,stride_a,lower_band_op_a,stride_b,lower_band_op_b,full_begin,full_end);
+      break;
   }
+  banded_matmul_rows_clipped<T,tA,tB,cA,cB>(a,b,c,stride_a,lower_band_op_a,columns_lim_op_a,
+    stride_b,lower_band_op_b,rows_lim_op_b,columns_lim_op_b,full_end,end);
 }
 
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void banded_matmul_tbb(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+//C+=op(A)*op(B) for banded matrices of any band width, stored rows of C are split between workers
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void banded_matmul_generic(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
-    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b)
-{
-  if( (upper_band_op_a == upper_band_op_b) &&
-      (upper_band_op_a == lower_band_op_a) &&
-      (upper_band_op_b == lower_band_op_b) &&
-      (upper_band_op_a == 1) &&
-      (nrows_op_a == ncolumns_op_a) &&
-      (ncolumns_op_a == ncolumns_op_b)
-    )
-  {
-    //product of square tridiagonal matrices
-    return tridiagonal_matmul_tbb<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a);
-  } else {
-    //TODO: STUB!
-  }
-/*
-  switch(tAlgo)
-  {
-    case TMM_Algo::IJK:
-          _gbmm_op<T,tA,tB,ccA,ccB>(a,b,c,ncolumns_op_a,ncolumns_op_b,ncolumns_op_b,i,j,k);
-      return;
-    case TMM_Algo::JKI:
-      return;
-    case TMM_Algo::KIJ:
-      return;
-    case TMM_Algo::IKJ:
-      return;
-    case TMM_Algo::KJI:
-      return;
-    case TMM_Algo::JIK:
-      return;
-  }
-*/
+    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b,
+    const TThreading threading_model)
+{
+  const size_t stride_a = upper_band_op_a + lower_band_op_a + 1;
+  const size_t stride_b = upper_band_op_b + lower_band_op_b + 1;
+  const size_t stored_a = std::min(nrows_op_a, ncolumns_op_a);
+  const size_t stored_b = std::min(ncolumns_op_a, ncolumns_op_b);
+  const size_t rows_lim_op_a = ( tA ? nrows_op_a : stored_a );
+  const size_t columns_lim_op_a = ( tA ? stored_a : ncolumns_op_a );
+  const size_t rows_lim_op_b = ( tB ? ncolumns_op_a : stored_b );
+  const size_t columns_lim_op_b = ( tB ? stored_b : ncolumns_op_b );
+  //rows of C that are both stored and nonzero
+  const size_t rows = std::min(rows_lim_op_a, std::min(nrows_op_a, ncolumns_op_b));
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t units = rows * stride_a * stride_b / 65536;
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t workers = std::max(size_t(1), std::min(max_workers, units));
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    banded_matmul_rows<T,tA,tB,cA,cB>(a,b,c,stride_a,lower_band_op_a,columns_lim_op_a,
+      stride_b,lower_band_op_b,rows_lim_op_b,columns_lim_op_b,rows*t/workers,rows*(t+1)/workers);
+  });
 }
-#endif
 
 template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void banded_matmul_serial(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+  inline void dgbmm_helper(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
-    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b)
-{
-  if( (upper_band_op_a == upper_band_op_b) &&
-      (upper_band_op_a == lower_band_op_a) &&
-      (upper_band_op_b == lower_band_op_b) &&
-      (upper_band_op_a == 1) &&
-      (nrows_op_a == ncolumns_op_a) &&
-      (ncolumns_op_a == ncolumns_op_b)
-    )
-  {
-    //product of square tridiagonal matrices
-    return tridiagonal_matmul_serial<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a);
-  } else {
-    //TODO: STUB!
-  }
-/*
-  switch(tAlgo)
-  {
-    case TMM_Algo::IJK:
-          _gbmm_op<T,tA,tB,ccA,ccB>(a,b,c,ncolumns_op_a,ncolumns_op_b,ncolumns_op_b,i,j,k);
-      return;
-    case TMM_Algo::JKI:
-      return;
-    case TMM_Algo::KIJ:
-      return;
-    case TMM_Algo::IKJ:
-      return;
-    case TMM_Algo::KJI:
-      return;
-    case TMM_Algo::JIK:
-      return;
-  }
-*/
+    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b,
+    const TThreading threading_model)
+{
+  //square tridiagonal matrices take the same path, interior rows of their product are fully unrolled
+  return banded_matmul_generic<T,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
+                                               upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b,threading_model);
 }
 
-template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
-  inline void dgbmm_helper(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+//picks instance of dgbmm_helper for given transpositions
+template<typename T>
+  inline void dgbmm_dispatch(const bool tA, const bool tB, const bool cA, const bool cB,
+    const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
     const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b,
     const TThreading threading_model)
 {
-  switch(threading_model)
+#define _DGBMM_HELPER(TA,TB,CA,CB) dgbmm_helper<T,TMM_Algo::IJK,TA,TB,CA,CB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,\
+    upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b,threading_model)
+  if(tA && tB)
   {
-    case T_Serial:
-      return banded_matmul_serial<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
-                                                        upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b);
-    case T_Std:
-//      return banded_matmul_stdthreads<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
-#ifdef HAVE_PTHREADS
-    case T_Posix:
-//      return banded_matmul_pthreads<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
-#endif
-#ifdef HAVE_OPENMP
-    case T_OpenMP:
-      return banded_matmul_openmp<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
-                                                        upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b);
-#endif
-#ifdef HAVE_CILK
-    case T_Cilk:
-      return banded_matmul_cilk<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
-                                                        upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b);
-#endif
-#ifdef HAVE_TBB
-    case T_TBB:
-      return banded_matmul_tbb<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
-                                                        upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b);
-#endif
-    case T_Undefined:
-    default:
-      return banded_matmul_serial<T,tAlgo,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,
-                                                        upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b);
+    if(cA && cB)
+      return _DGBMM_HELPER(true,true,true,true);
+    else if(cA && !cB)
+      return _DGBMM_HELPER(true,true,true,false);
+    else if(!cA && cB)
+      return _DGBMM_HELPER(true,true,false,true);
+    else //if((!cA) && (!cB))
+      return _DGBMM_HELPER(true,true,false,false);
+  }
+  else if(tA && !tB)
+  {
+    if(cA)
+      return _DGBMM_HELPER(true,false,true,false);
+    else
+      return _DGBMM_HELPER(true,false,false,false);
+  }
+  else if(!tA && tB)
+  {
+    if(cB)
+      return _DGBMM_HELPER(false,true,false,true);
+    else
+      return _DGBMM_HELPER(false,true,false,false);
+  }
+  else //if((!tA) && (!tB))
+  {
+    return _DGBMM_HELPER(false,false,false,false);
   }
+#undef _DGBMM_HELPER
 }
 
-//reduced dgbmm for banded matrices, C+=A*B
+//reduced dgbmm for banded matrices, C+=op(A)*op(B)
+//C should have upper and lower band widths equal to sums of those of op(A) and op(B)
 template<typename T>
   void dgbmm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
       const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
@@ -385,18 +238,33 @@ template<typename T>
       const size_t nrows_b, const size_t ncolumns_b, const size_t upper_band_b, const size_t lower_band_b,
       const TThreading threading_model)
 {
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  const bool cB = (transB == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
   switch(stor)
   {
     case TMatrixStorage::RowMajor:
       {
-        //TODO: STUB!
-        return dgbmm_helper<T,TMM_Algo::IJK,false,false,false,false>(a,b,c,nrows_a,ncolumns_a,ncolumns_b,
-            upper_band_a,lower_band_a,upper_band_b,lower_band_b,threading_model);
+        return dgbmm_dispatch<T>(tA,tB,cA,cB,a,b,c,
+            ( tA ? ncolumns_a : nrows_a ), ( tA ? nrows_a : ncolumns_a ), ( tB ? nrows_b : ncolumns_b ),
+            ( tA ? lower_band_a : upper_band_a ), ( tA ? upper_band_a : lower_band_a ),
+            ( tB ? lower_band_b : upper_band_b ), ( tB ? upper_band_b : lower_band_b ),
+            threading_model);
       }
     case TMatrixStorage::ColumnMajor:
       {
-        //TODO: STUB!
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major CDS storage of X is row major CDS storage of X', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return dgbmm_dispatch<T>(tB,tA,cB,cA,b,a,c,
+            ( tB ? nrows_b : ncolumns_b ), ( tB ? ncolumns_b : nrows_b ), ( tA ? ncolumns_a : nrows_a ),
+            ( tB ? upper_band_b : lower_band_b ), ( tB ? lower_band_b : upper_band_b ),
+            ( tA ? upper_band_a : lower_band_a ), ( tA ? lower_band_a : upper_band_a ),
+            threading_model);
       }
+    case TMatrixStorage::Tiled:
+      //not supported, banded matrices have their own storage
+      __storage_unsupported("dgbmm");
   }
 }
 
@@ -410,91 +278,332 @@ template<typename T>
   return dgbmm<T>(stor,transA,transB,a,b,c,sz,sz,band,band,sz,sz,band,band,threading_model);
 }
 
-template<typename T, bool transA>
-  void dgbmv_helper(const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
-      const size_t nrows_a, const size_t ncolumns_a, const size_t upper_band_a, const size_t lower_band_a,
-      const T alpha,
-      const TThreading threading_model)
+//helpers for diagonal-wise banded matrix multiplication, based on paper
+//N. Madsen, G. Rodrigue and J. Karush, "Matrix multiplication by diagonals on a vector/parallel processor", 1976.
+//diagonals of op(A) and op(B) are packed into contiguous vectors, zero padded so that product of any pair of diagonals
+//is stride-1 sweep with no bounds checks: cd[p+q][i] += ad[p][i] * bd[q][i+p], where bd is shifted by lower_band_op_a.
+//diagonal of C is accumulated in registers over all pairs of diagonals it consists of, block of rows at a time,
+//diagonals of C are split between workers and are added to C when all of them are done
+
+//pack op(X) into diagonal-major layout xd[p*len+j] = op(X)(row0+j-shift,row0+j-shift-lower_band_op+p) for j in [begin,end),
+//zeros outside of op(X)
+template<typename T, bool t, bool c>
+  inline void __mrk_pack(const T* const __RESTRICT x, const size_t stride, const size_t lower_band_op,
+    const size_t rows_lim_op, const size_t columns_lim_op,
+    T* const __RESTRICT xd, const size_t len, const size_t row0, const size_t shift, const size_t begin, const size_t end)
 {
-  const size_t sz = ( transA ? nrows_a : ncolumns_a );
-  const size_t stride_a = upper_band_a + lower_band_a + 1;
-  if(!transA)
+  for(size_t p = 0; p < stride; p++)
   {
-    //too few operations to benefit from threading(< stride_a^2)
-    for(size_t j = 0; j < upper_band_a; j++)
+    //rows where diagonal p of op(X) exists
+    const size_t i_begin = std::max(row0, ( lower_band_op > p ? lower_band_op - p : 0 ));
+    const size_t i_lim = std::min(rows_lim_op, ( columns_lim_op + lower_band_op > p ? columns_lim_op + lower_band_op - p : 0 ));
+    const size_t j_begin = std::min(end, std::max(begin, i_begin - row0 + shift));
+    const size_t j_end = std::max(j_begin, std::min(end, ( i_lim > row0 ? i_lim - row0 + shift : 0 )));
+    T* const __RESTRICT xd_p = xd + p*len;
+    for(size_t j = begin; j < j_begin; j++)
+      xd_p[j] = T(0);
+    for(size_t j = j_begin; j < j_end; j++)
+      xd_p[j] = _gb_op<T,t,c>(x,stride,lower_band_op,row0+j-shift,p);
+    for(size_t j = j_end; j < end; j++)
+      xd_p[j] = T(0);
+  }
+}
+
+//rows [i0,i0+R) of diagonals [pc,pc+K) of C, sums of products of diagonals p of op(A) with diagonals pc+k-p of op(B),
+//diagonal of op(A) is loaded once for all K diagonals of C where possible
+template<typename T, size_t R, size_t K>
+  __FORCEINLINE inline void __mrk_kernel(const T* const __RESTRICT ad, const size_t len_a,
+    const T* const __RESTRICT bd, const size_t len_b, const size_t stride_a, const size_t stride_b,
+    T* const __RESTRICT cd, const size_t len_c, const size_t pc, const size_t i0)
+{
+  T acc[K][R];
+  for(size_t k = 0; k < K; k++)
+    for(size_t r = 0; r < R; r++)
+      acc[k][r] = T(0);
+  //pairs of diagonals common for all K diagonals of C
+  const size_t p_common_begin = ( pc + K > stride_b ? pc + K - stride_b : 0 );
+  const size_t p_common_end = std::max(p_common_begin, std::min(pc + 1, stride_a));
+  for(size_t p = p_common_begin; p < p_common_end; p++)
+  {
+    const T* const __RESTRICT ad_p = ad + p*len_a + i0;
+    for(size_t k = 0; k < K; k++)
     {
-      for(size_t i = 0; i <= j + lower_band_a; i++)
-      {
-        y[i] += alpha*a[lower_band_a + j + i*(stride_a - 1)]*x[j];
-      }
+      const T* const __RESTRICT bd_q = bd + (pc+k-p)*len_b + i0 + p;
+      for(size_t r = 0; r < R; r++)
+        acc[k][r] += ad_p[r] * bd_q[r];
     }
-    switch(threading_model)
+  }
+  //the rest of pairs
+  for(size_t k = 0; k < K; k++)
+  {
+    const size_t p_begin = ( pc + k >= stride_b ? pc + k - stride_b + 1 : 0 );
+    const size_t p_end = std::min(pc + k + 1, stride_a);
+    for(size_t p = p_begin; p < std::min(p_common_begin, p_end); p++)
     {
-      case T_Std:
-  //      break;
-#ifdef HAVE_PTHREADS
-      case T_Posix:
-  //      break;
-#endif
-#ifdef HAVE_OPENMP
-      case T_OpenMP:
-#pragma omp parallel for
-        for(size_t j = 0; j <= sz - stride_a; j++)
-        {
-          for(size_t i = 0; i < stride_a; i++)
-          {
-            y[i + j] += alpha*a[stride_a - 1 + j*stride_a + i*(stride_a - 1)]*x[upper_band_a + j];
-          }
-        }
-        break;
-#endif
-#ifdef HAVE_CILK
-      case T_Cilk:
-        cilk_for(size_t j = 0; j <= sz - stride_a; j++)
+      const T* const __RESTRICT ad_p = ad + p*len_a + i0;
+      const T* const __RESTRICT bd_q = bd + (pc+k-p)*len_b + i0 + p;
+      for(size_t r = 0; r < R; r++)
+        acc[k][r] += ad_p[r] * bd_q[r];
+    }
+    for(size_t p = std::max(p_common_end, p_begin); p < p_end; p++)
+    {
+      const T* const __RESTRICT ad_p = ad + p*len_a + i0;
+      const T* const __RESTRICT bd_q = bd + (pc+k-p)*len_b + i0 + p;
+      for(size_t r = 0; r < R; r++)
+        acc[k][r] += ad_p[r] * bd_q[r];
+    }
+  }
+  for(size_t k = 0; k < K; k++)
+    for(size_t r = 0; r < R; r++)
+      cd[(pc+k)*len_c+i0+r] = acc[k][r];
+}
+
+//first and last+1 diagonals of C for every worker, so that workers get nearly equal numbers of diagonal pairs
+inline std::vector<size_t> __mrk_split(const size_t stride_a, const size_t stride_b, const size_t workers)
+{
+  const size_t stride_c = stride_a + stride_b - 1;
+  std::vector<size_t> bounds(workers + 1, stride_c);
+  bounds[0] = 0;
+  size_t pairs = 0;
+  size_t t = 1;
+  for(size_t pc = 0; pc < stride_c && t < workers; pc++)
+  {
+    pairs += std::min(pc + 1, stride_a) - ( pc >= stride_b ? pc - stride_b + 1 : 0 );
+    while(t < workers && pairs * workers >= t * stride_a * stride_b)
+      bounds[t++] = pc + 1;
+  }
+  return bounds;
+}
+
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void banded_matmul_mrk(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b,
+    const TThreading threading_model)
+{
+  const size_t stride_a = upper_band_op_a + lower_band_op_a + 1;
+  const size_t stride_b = upper_band_op_b + lower_band_op_b + 1;
+  const size_t stride_c = stride_a + stride_b - 1;
+  const size_t lower_band_op_c = lower_band_op_a + lower_band_op_b;
+  const size_t stored_a = std::min(nrows_op_a, ncolumns_op_a);
+  const size_t stored_b = std::min(ncolumns_op_a, ncolumns_op_b);
+  const size_t rows_lim_op_a = ( tA ? nrows_op_a : stored_a );
+  const size_t columns_lim_op_a = ( tA ? stored_a : ncolumns_op_a );
+  const size_t rows_lim_op_b = ( tB ? ncolumns_op_a : stored_b );
+  const size_t columns_lim_op_b = ( tB ? stored_b : ncolumns_op_b );
+  //rows of C that are both stored and nonzero
+  const size_t rows = std::min(rows_lim_op_a, std::min(nrows_op_a, ncolumns_op_b));
+  if(rows == 0)
+    return;
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  //rows of C are processed in chunks, so that packed diagonals stay in cache and workspace stays small,
+  //chunk has to be much longer than band of op(A), since rows of op(B) are shared between neighbour chunks
+  const size_t R = 16;
+  const size_t K = 4;
+  const size_t chunk = std::min(rows, std::max(4 * stride_a,
+      ( (size_t(1) << 20) * max_workers / (sizeof(T) * (stride_a + stride_b + stride_c)) ) / R * R));
+  //row i of C is multiplied with rows [i-lower_band_op_a,i+upper_band_op_a] of op(B)
+  const size_t len_b = chunk + stride_a - 1;
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t units = chunk * stride_a * stride_b / 65536;
+  const size_t workers = std::max(size_t(1), std::min(std::min(max_workers, units), stride_c));
+  const TThreading workers_model = ( workers > 1 ? threading_model : T_Serial );
+  const std::vector<size_t> bounds = __mrk_split(stride_a, stride_b, workers);
+  //diagonals of op(A) and op(B) for block of rows should fit in L1 cache
+  const size_t block = std::max(R, ( 32768 / (sizeof(T) * (stride_a + stride_b)) ) / R * R);
+  //allocate workspace once: packed diagonals of op(A), op(B) and C for chunk of rows
+  unique_aligned_buf_ptr ws_buf;
+  T* const ad = __mm_block_alloc<T>(stride_a*chunk + stride_b*len_b + stride_c*chunk, ws_buf);
+  T* const bd = ad + stride_a*chunk;
+  T* const cd = bd + stride_b*len_b;
+  for(size_t i_chunk = 0; i_chunk < rows; i_chunk += chunk)
+  {
+    const size_t rows_chunk = std::min(chunk, rows - i_chunk);
+    const size_t len_b_chunk = rows_chunk + stride_a - 1;
+    //rows of op(B) start from i_chunk-lower_band_op_a, which may be out of op(B)
+    const size_t row0_b = ( i_chunk > lower_band_op_a ? i_chunk - lower_band_op_a : 0 );
+    const size_t shift_b = ( i_chunk > lower_band_op_a ? 0 : lower_band_op_a - i_chunk );
+    run_workers(workers_model, workers, [&](const size_t t)
+    {
+      __mrk_pack<T,tA,cA>(a,stride_a,lower_band_op_a,rows_lim_op_a,columns_lim_op_a,ad,chunk,i_chunk,0,
+                          rows_chunk*t/workers,rows_chunk*(t+1)/workers);
+      __mrk_pack<T,tB,cB>(b,stride_b,lower_band_op_b,rows_lim_op_b,columns_lim_op_b,bd,len_b,row0_b,shift_b,
+                          len_b_chunk*t/workers,len_b_chunk*(t+1)/workers);
+    });
+    run_workers(workers_model, workers, [&](const size_t t)
+    {
+      for(size_t ib = 0; ib < rows_chunk; ib += block)
+      {
+        const size_t ie = std::min(rows_chunk, ib + block);
+        size_t pc = bounds[t];
+        for(; pc + K <= bounds[t+1]; pc += K)
         {
-          for(size_t i = 0; i < stride_a; i++)
-          {
-            y[i + j] += alpha*a[stride_a - 1 + j*stride_a + i*(stride_a - 1)]*x[upper_band_a + j];
-          }
+          size_t i0 = ib;
+          for(; i0 + R <= ie; i0 += R)
+            __mrk_kernel<T,R,K>(ad,chunk,bd,len_b,stride_a,stride_b,cd,chunk,pc,i0);
+          for(; i0 < ie; i0++)
+            __mrk_kernel<T,1,K>(ad,chunk,bd,len_b,stride_a,stride_b,cd,chunk,pc,i0);
         }
-        break;
-#endif
-#ifdef HAVE_TBB
-      case T_TBB:
-        parallelForElem(size_t(0), sz - stride_a + 1,
-        [&a,&x,&y,&stride_a,&alpha,&upper_band_a](size_t j){
-          for(size_t i = 0; i < stride_a; i++)
-          {
-            y[i + j] += alpha*a[stride_a - 1 + j*stride_a + i*(stride_a - 1)]*x[upper_band_a + j];
-          }
-        });
-        break;
-#endif
-      case T_Serial:
-      case T_Undefined:
-      default:
-        for(size_t j = 0; j <= sz - stride_a; j++)
+        for(; pc < bounds[t+1]; pc++)
         {
-          for(size_t i = 0; i < stride_a; i++)
-          {
-            y[i + j] += alpha*a[stride_a - 1 + j*stride_a + i*(stride_a - 1)]*x[upper_band_a + j];
-          }
+          size_t i0 = ib;
+          for(; i0 + R <= ie; i0 += R)
+            __mrk_kernel<T,R,1>(ad,chunk,bd,len_b,stride_a,stride_b,cd,chunk,pc,i0);
+          for(; i0 < ie; i0++)
+            __mrk_kernel<T,1,1>(ad,chunk,bd,len_b,stride_a,stride_b,cd,chunk,pc,i0);
         }
-        break;
-    }
-    //too few operations to benefit from threading(< stride_a^2)
-    for(size_t j = sz - stride_a + 1; j < sz - upper_band_a; j++)
+      }
+    });
+    //add diagonals of product to C
+    run_workers(workers_model, workers, [&](const size_t t)
     {
-      for(size_t i = 0 ; i < sz - j; i++)
+      for(size_t i = i_chunk + rows_chunk*t/workers; i < i_chunk + rows_chunk*(t+1)/workers; i++)
       {
-        y[i + j] += alpha*a[stride_a - 1 + j*stride_a + i*(stride_a - 1)]*x[upper_band_a + j];
+        const size_t p_begin = ( lower_band_op_c > i ? lower_band_op_c - i : 0 );
+        const size_t p_end = ( columns_lim_op_b + lower_band_op_c > i ? std::min(stride_c, columns_lim_op_b + lower_band_op_c - i) : 0 );
+        for(size_t p = p_begin; p < p_end; p++)
+          c[i*stride_c+p] += cd[p*chunk+i-i_chunk];
       }
+    });
+  }
+}
+
+//picks instance of banded_matmul_mrk for given transpositions
+template<typename T>
+  inline void dgbmm_mrk_dispatch(const bool tA, const bool tB, const bool cA, const bool cB,
+    const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const size_t upper_band_op_a, const size_t lower_band_op_a, const size_t upper_band_op_b, const size_t lower_band_op_b,
+    const TThreading threading_model)
+{
+#define _MRK_HELPER(TA,TB,CA,CB) banded_matmul_mrk<T,TA,TB,CA,CB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,\
+    upper_band_op_a,lower_band_op_a,upper_band_op_b,lower_band_op_b,threading_model)
+  if(tA && tB)
+  {
+    if(cA && cB)
+      return _MRK_HELPER(true,true,true,true);
+    else if(cA && !cB)
+      return _MRK_HELPER(true,true,true,false);
+    else if(!cA && cB)
+      return _MRK_HELPER(true,true,false,true);
+    else //if((!cA) && (!cB))
+      return _MRK_HELPER(true,true,false,false);
+  }
+  else if(tA && !tB)
+  {
+    if(cA)
+      return _MRK_HELPER(true,false,true,false);
+    else
+      return _MRK_HELPER(true,false,false,false);
+  }
+  else if(!tA && tB)
+  {
+    if(cB)
+      return _MRK_HELPER(false,true,false,true);
+    else
+      return _MRK_HELPER(false,true,false,false);
+  }
+  else //if((!tA) && (!tB))
+  {
+    return _MRK_HELPER(false,false,false,false);
+  }
+#undef _MRK_HELPER
+}
+
+//diagonal-wise dgbmm for banded matrices, C+=op(A)*op(B)
+//C should have upper and lower band widths equal to sums of those of op(A) and op(B)
+template<typename T>
+  void dgbmm_mrk(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a, const size_t upper_band_a, const size_t lower_band_a,
+      const size_t nrows_b, const size_t ncolumns_b, const size_t upper_band_b, const size_t lower_band_b,
+      const TThreading threading_model)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  const bool cB = (transB == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        return dgbmm_mrk_dispatch<T>(tA,tB,cA,cB,a,b,c,
+            ( tA ? ncolumns_a : nrows_a ), ( tA ? nrows_a : ncolumns_a ), ( tB ? nrows_b : ncolumns_b ),
+            ( tA ? lower_band_a : upper_band_a ), ( tA ? upper_band_a : lower_band_a ),
+            ( tB ? lower_band_b : upper_band_b ), ( tB ? upper_band_b : lower_band_b ),
+            threading_model);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major CDS storage of X is row major CDS storage of X', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return dgbmm_mrk_dispatch<T>(tB,tA,cB,cA,b,a,c,
+            ( tB ? nrows_b : ncolumns_b ), ( tB ? ncolumns_b : nrows_b ), ( tA ? ncolumns_a : nrows_a ),
+            ( tB ? upper_band_b : lower_band_b ), ( tB ? lower_band_b : upper_band_b ),
+            ( tA ? upper_band_a : lower_band_a ), ( tA ? lower_band_a : upper_band_a ),
+            threading_model);
+      }
+    case TMatrixStorage::Tiled:
+      //not supported, banded matrices have their own storage
+      __storage_unsupported("dgbmm_mrk");
+  }
+}
+
+//diagonal-wise dgbmm for square symmetrically banded matrices
+template<typename T>
+  void dgbmm_mrk(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model)
+{
+  return dgbmm_mrk<T>(stor,transA,transB,a,b,c,sz,sz,band,band,sz,sz,band,band,threading_model);
+}
+
+//rows [begin,end) of y+=\alpha*op(A)*x for banded matrix of any band width
+//diagonals of op(A) are processed one by one, so inner loop runs along diagonal and contiguous x and y,
+//rows are processed in blocks to keep y in L1 cache
+template<typename T, bool tA, bool cA>
+  inline void banded_matvec_rows(const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t stride_a, const size_t lower_band_op_a, const size_t columns_lim_op_a,
+      const T alpha,
+      const size_t begin, const size_t end)
+{
+  const size_t block = 512;
+  for(size_t ib = begin; ib < end; ib += block)
+  {
+    const size_t ie = std::min(end, ib + block);
+    for(size_t p = 0; p < stride_a; p++)
+    {
+      //rows where diagonal p of op(A) exists
+      const size_t i_begin = std::max(ib, ( lower_band_op_a > p ? lower_band_op_a - p : 0 ));
+      const size_t i_end = ( columns_lim_op_a + lower_band_op_a > p ? std::min(ie, columns_lim_op_a + lower_band_op_a - p) : 0 );
+      for(size_t i = i_begin; i < i_end; i++)
+        y[i] += alpha * _gb_op<T,tA,cA>(a,stride_a,lower_band_op_a,i,p) * x[i+p-lower_band_op_a];
     }
-  } else {
-    //TODO: STUB!
   }
 }
 
+template<typename T, bool transA, bool conjA>
+  void dgbmv_helper(const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t nrows_a, const size_t ncolumns_a, const size_t upper_band_a, const size_t lower_band_a,
+      const T alpha,
+      const TThreading threading_model)
+{
+  const size_t stride_a = upper_band_a + lower_band_a + 1;
+  const size_t stored_a = std::min(nrows_a, ncolumns_a);
+  const size_t lower_band_op_a = ( transA ? upper_band_a : lower_band_a );
+  const size_t columns_lim_op_a = ( transA ? stored_a : ncolumns_a );
+  const size_t rows = ( transA ? ncolumns_a : stored_a );
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t units = rows * stride_a / 65536;
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t workers = std::max(size_t(1), std::min(max_workers, units));
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    banded_matvec_rows<T,transA,conjA>(a,x,y,stride_a,lower_band_op_a,columns_lim_op_a,alpha,rows*t/workers,rows*(t+1)/workers);
+  });
+}
+
 //generic dgbmv for banded matrices, y+=\alpha*op(A)*x
 template<typename T>
   void dgbmv(const TMatrixStorage stor, const TMatrixTranspose transA,
@@ -504,23 +613,30 @@ template<typename T>
       const TThreading threading_model /* = T_Serial */ )
 {
   const bool tA = transA != TMatrixTranspose::No;
-//  const bool cA = transA == TMatrixTranspose::Conjugate; // TODO: STUB!
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
   switch(stor)
   {
     case TMatrixStorage::RowMajor:
       {
-        if(tA)
-          return dgbmv_helper<T,true>(a,x,y,nrows_a,ncolumns_a,upper_band_a,lower_band_a,alpha,threading_model);
+        if(tA && cA)
+          return dgbmv_helper<T,true,true>(a,x,y,nrows_a,ncolumns_a,upper_band_a,lower_band_a,alpha,threading_model);
+        else if(tA)
+          return dgbmv_helper<T,true,false>(a,x,y,nrows_a,ncolumns_a,upper_band_a,lower_band_a,alpha,threading_model);
         else
-          return dgbmv_helper<T,false>(a,x,y,nrows_a,ncolumns_a,upper_band_a,lower_band_a,alpha,threading_model);
+          return dgbmv_helper<T,false,false>(a,x,y,nrows_a,ncolumns_a,upper_band_a,lower_band_a,alpha,threading_model);
       }
     case TMatrixStorage::ColumnMajor:
       {
-        if(tA)
-          return dgbmv_helper<T,false>(a,x,y,ncolumns_a,nrows_a,lower_band_a,upper_band_a,alpha,threading_model);
+        if(tA && cA)
+          return dgbmv_helper<T,false,true>(a,x,y,ncolumns_a,nrows_a,lower_band_a,upper_band_a,alpha,threading_model);
+        else if(tA)
+          return dgbmv_helper<T,false,false>(a,x,y,ncolumns_a,nrows_a,lower_band_a,upper_band_a,alpha,threading_model);
         else
-          return dgbmv_helper<T,true>(a,x,y,ncolumns_a,nrows_a,lower_band_a,upper_band_a,alpha,threading_model);
+          return dgbmv_helper<T,true,false>(a,x,y,ncolumns_a,nrows_a,lower_band_a,upper_band_a,alpha,threading_model);
       }
+    case TMatrixStorage::Tiled:
+      //not supported, banded matrices have their own storage
+      __storage_unsupported("dgbmv");
   }
 }
 
@@ -535,6 +651,215 @@ template<typename T>
   return dgbmv<T>(stor,transA,a,x,y,sz,sz,band,band,alpha,threading_model);
 }
 
+//rows [begin,end) of y+=\alpha*A*x for symmetric banded matrix, row i of A is gathered from row i of storage(upper bands)
+//and from column i of it(lower bands, along antidiagonal with step stride-1), so rows are independent.
+//like banded_matvec_rows, diagonals are processed one by one in blocks of rows
+template<typename T>
+  inline void symmetric_banded_matvec_rows(const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t sz, const size_t band,
+      const T alpha,
+      const size_t begin, const size_t end)
+{
+  const size_t stride = band + 1;
+  const size_t block = 512;
+  for(size_t ib = begin; ib < end; ib += block)
+  {
+    const size_t ie = std::min(end, ib + block);
+    for(size_t i = ib; i < ie; i++)
+      y[i] += alpha * a[i*stride] * x[i];
+    for(size_t p = 1; p < stride; p++)
+    {
+      //A(i,i+p)
+      const size_t u_end = ( sz > p ? std::min(ie, sz - p) : 0 );
+      for(size_t i = ib; i < u_end; i++)
+        y[i] += alpha * a[i*stride + p] * x[i + p];
+      //A(i,i-p) = A(i-p,i)
+      for(size_t i = std::max(ib, p); i < ie; i++)
+        y[i] += alpha * a[(i - p)*stride + p] * x[i - p];
+    }
+  }
+}
+
+//dsbmv for symmetric banded matrices, y+=\alpha*A*x
+template<typename T>
+  void dsbmv(const TMatrixStorage stor,
+    const T* const __RESTRICT a, const T* const __RESTRICT x, T* const __RESTRICT y,
+    const size_t sz, const size_t band,
+    const T alpha /* = T(1.0) */,
+    const TThreading threading_model /* = T_Serial */)
+{
+  if(stor == TMatrixStorage::Tiled)
+    //not supported, banded matrices have their own storage
+    __storage_unsupported("dsbmv");
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t units = sz * (2*band + 1) / 65536;
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t workers = std::max(size_t(1), std::min(max_workers, units));
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    symmetric_banded_matvec_rows<T>(a,x,y,sz,band,alpha,sz*t/workers,sz*(t+1)/workers);
+  });
+}
+
+//rows [begin,end) of diagonal and upper bands of symmetric C+=op(A)*op(B), op(A) and op(B) have band width band,
+//so c(i,i+q) += sum of op(A)(i,k)*op(B)(k,i+q) over k in [i+q-band,i+band], q in [0,2*band]
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void symmetric_banded_matmul_rows_clipped(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const size_t begin, const size_t end)
+{
+  const size_t stride = 2*band + 1;
+  for(size_t i = begin; i < end; i++)
+  {
+    const size_t q_end = std::min(stride, sz - i);
+    const size_t k_end = std::min(sz, i + band + 1);
+    T* const __RESTRICT c_i = c + i*stride;
+    for(size_t q = 0; q < q_end; q++)
+    {
+      const size_t j = i + q;
+      T sum = T(0);
+      for(size_t k = ( j > band ? j - band : 0 ); k < k_end; k++)
+        sum += _gb_op<T,tA,cA>(a,stride,band,i,k+band-i) * _gb_op<T,tB,cB>(b,stride,band,k,j+band-k);
+      c_i[q] += sum;
+    }
+  }
+}
+
+//same for compile time band width of matrices that aren't transposed and rows where all elements exist,
+//products of elements of row i of A with rows of B that fall into lower bands of C are dropped at compile time
+template<typename T, size_t B>
+  inline void symmetric_banded_matmul_rows_full(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t begin, const size_t end)
+{
+  const size_t S = 2*B + 1;
+  for(size_t i = begin; i < end; i++)
+  {
+    const T* const __RESTRICT a_i = a + i*S;
+    const T* const __RESTRICT b_r = b + (i-B)*S;
+    T c_i[S];
+    for(size_t x = 0; x < S; x++)
+      c_i[x] = c[i*S+x];
+    for(size_t p = 0; p < S; p++)
+      for(size_t q = 0; q < S; q++)
+        if(p + q >= 2*B)
+          c_i[p+q-2*B] += a_i[p] * b_r[p*S+q];
+    for(size_t x = 0; x < S; x++)
+      c[i*S+x] = c_i[x];
+  }
+}
+
+//rows [begin,end) of symmetric C+=op(A)*op(B), rows near matrix edges are clipped
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void symmetric_banded_matmul_rows(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const size_t begin, const size_t end)
+{
+  //interior rows [full_begin,full_end) use full rows of A and B
+  const size_t full_begin = std::min(end, std::max(begin, band));
+  const size_t full_end = std::max(full_begin, std::min(end, ( sz > 2*band ? sz - 2*band : 0 )));
+  symmetric_banded_matmul_rows_clipped<T,tA,tB,cA,cB>(a,b,c,sz,band,begin,full_begin);
+  const bool plain = !tA && !tB && !cA && !cB;
+  switch( plain ? band : 0 )
+  {
+    case 1:
+      symmetric_banded_matmul_rows_full<T,1>(a,b,c,full_begin,full_end);
+      break;
+    case 2:
+      symmetric_banded_matmul_rows_full<T,2>(a,b,c,full_begin,full_end);
+      break;
+    case 3:
+      symmetric_banded_matmul_rows_full<T,3>(a,b,c,full_begin,full_end);
+      break;
+    case 4:
+      symmetric_banded_matmul_rows_full<T,4>(a,b,c,full_begin,full_end);
+      break;
+    default:
+      symmetric_banded_matmul_rows_clipped<T,tA,tB,cA,cB>(a,b,c,sz,band,full_begin,full_end);
+      break;
+  }
+  symmetric_banded_matmul_rows_clipped<T,tA,tB,cA,cB>(a,b,c,sz,band,full_end,end);
+}
+
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void dsbmm_helper(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model)
+{
+  const size_t stride = 2*band + 1;
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t units = sz * stride * (band + 1) / 65536;
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t workers = std::max(size_t(1), std::min(max_workers, units));
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    symmetric_banded_matmul_rows<T,tA,tB,cA,cB>(a,b,c,sz,band,sz*t/workers,sz*(t+1)/workers);
+  });
+}
+
+//picks instance of dsbmm_helper for given transpositions
+template<typename T>
+  inline void dsbmm_dispatch(const bool tA, const bool tB, const bool cA, const bool cB,
+    const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model)
+{
+#define _DSBMM_HELPER(TA,TB,CA,CB) dsbmm_helper<T,TA,TB,CA,CB>(a,b,c,sz,band,threading_model)
+  if(tA && tB)
+  {
+    if(cA && cB)
+      return _DSBMM_HELPER(true,true,true,true);
+    else if(cA && !cB)
+      return _DSBMM_HELPER(true,true,true,false);
+    else if(!cA && cB)
+      return _DSBMM_HELPER(true,true,false,true);
+    else //if((!cA) && (!cB))
+      return _DSBMM_HELPER(true,true,false,false);
+  }
+  else if(tA && !tB)
+  {
+    if(cA)
+      return _DSBMM_HELPER(true,false,true,false);
+    else
+      return _DSBMM_HELPER(true,false,false,false);
+  }
+  else if(!tA && tB)
+  {
+    if(cB)
+      return _DSBMM_HELPER(false,true,false,true);
+    else
+      return _DSBMM_HELPER(false,true,false,false);
+  }
+  else //if((!tA) && (!tB))
+  {
+    return _DSBMM_HELPER(false,false,false,false);
+  }
+#undef _DSBMM_HELPER
+}
+
+//C+=op(A)*op(B) for square symmetrically banded A and B, only diagonal and upper bands of symmetric C are computed
+template<typename T>
+  void dsbmm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz, const size_t band,
+    const TThreading threading_model /* = T_Serial */)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  const bool cB = (transB == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      return dsbmm_dispatch<T>(tA,tB,cA,cB,a,b,c,sz,band,threading_model);
+    case TMatrixStorage::ColumnMajor:
+      //calculate C'=(op(B))'*(op(A))' as dgbmm does, symmetric storage of C' is the same as that of C
+      return dsbmm_dispatch<T>(tB,tA,cB,cA,b,a,c,sz,band,threading_model);
+    case TMatrixStorage::Tiled:
+      //not supported, banded matrices have their own storage
+      __storage_unsupported("dsbmm");
+  }
+}
+
 
 //add for banded matrices, a += b, assuming that band width of b is less or equal than that of a
 template<typename T>
@@ -636,6 +961,9 @@ template<typename T>
             lower_band_a,upper_band_a,lower_band_b,upper_band_b,
             threading_model);
       }
+    case TMatrixStorage::Tiled:
+      //not supported, banded matrices have their own storage
+      __storage_unsupported("banded_add");
   }
 }
 
@@ -663,6 +991,22 @@ template<typename T>
   return banded_add<T>(stor,a,b,sz,sz,band_a,band_a,band_b,band_b,threading_model);
 }
 
+//add for symmetric banded matrices, a += b, assuming that band width of b is equal or less than that of a
+//symmetric CDS format is CDS format without lower bands
+template<typename T>
+  void symmetric_banded_add(const TMatrixStorage stor,
+    T* const __RESTRICT a, const T* const __RESTRICT b,
+    const size_t sz,
+    const size_t band_a,
+    const size_t band_b,
+    const TThreading threading_model /* = T_Serial */)
+{
+  if(stor == TMatrixStorage::Tiled)
+    //not supported, banded matrices have their own storage
+    __storage_unsupported("symmetric_banded_add");
+  return banded_add_helper<T>(a,b,sz,sz,band_a,0,band_b,0,threading_model);
+}
+
 
 template<typename T> bool is_banded_diagonally_dominant(const size_t sz,
     const size_t lower_band, const size_t upper_band,
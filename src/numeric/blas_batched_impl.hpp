@@ -0,0 +1,293 @@
+#pragma once
+#ifndef _BLAS_BATCHED_IMPL_HPP
+#define _BLAS_BATCHED_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+using std::size_t;
+
+namespace numeric {
+
+//helpers for batched multiplication of many small matrices
+//every product C[i]+=A[i]*B[i] is done by single call of small kernel without any packing,
+//kernels for common square sizes have dimensions known at compile time, so loops are fully unrolled
+//and rows of C are kept in registers and updated with vector instructions.
+//for power of two sizes gcc turns row kernel into reduction over columns of B and shuffles B around,
+//so float and double 8x8 and 16x16 products keep rows as gcc vector types instead(other types and compilers
+//use rank-1 updates of C). 32x32 rows take 4-8 registers each, which spills, so the plain row kernel is kept there.
+//NB: interleaving matrices of batch(packing chunks of 64 bytes worth of matrices lane by lane) to vectorize
+//across it doesn't pay off, even with 64 byte vector types packing costs more than it saves.
+
+//matrices of batch given by array of pointers
+template<typename P> struct __batch_pointers
+{
+  const P* ptrs;
+  P operator()(const size_t i) const { return ptrs[i]; }
+};
+
+//matrices of batch given by pointer to first one and distance between consecutive ones
+template<typename P> struct __batch_strided
+{
+  P base;
+  size_t stride;
+  P operator()(const size_t i) const { return base + i * stride; }
+};
+
+//small kernel for compile time sizes, C[M x N] += A[M x K] * B[K x N]
+template<typename T, size_t M, size_t K, size_t N>
+  __FORCEINLINE inline void __gemm_small_kernel(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c)
+{
+  for(size_t i = 0; i < M; i++)
+  {
+    T c_row[N];
+    for(size_t j = 0; j < N; j++)
+      c_row[j] = c[i*N+j];
+    for(size_t p = 0; p < K; p++)
+    {
+      const T a_ip = a[i*K+p];
+      for(size_t j = 0; j < N; j++)
+        c_row[j] += a_ip * b[p*N+j];
+    }
+    for(size_t j = 0; j < N; j++)
+      c[i*N+j] = c_row[j];
+  }
+}
+
+//small kernel for compile time sizes done by rank-1 updates, C[M x N] += A[M x K] * B[K x N]
+template<typename T, size_t M, size_t K, size_t N>
+  __FORCEINLINE inline void __gemm_small_kernel_rank1(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c)
+{
+  for(size_t p = 0; p < K; p++)
+    for(size_t i = 0; i < M; i++)
+    {
+      const T a_ip = a[i*K+p];
+      for(size_t j = 0; j < N; j++)
+        c[i*N+j] += a_ip * b[p*N+j];
+    }
+}
+
+//float and double rows of power of two widths are handled as whole vectors by gcc vector extensions,
+//which are lowered to one or several simd registers of the target, so nothing is left to vectorizer
+template<typename T> struct __batched_vector_rows : std::false_type {};
+#if defined(__GNUC__)
+template<> struct __batched_vector_rows<float> : std::true_type {};
+template<> struct __batched_vector_rows<double> : std::true_type {};
+
+//small kernel for compile time power of two width of B and C, row of C is kept in vector register(s)
+template<typename T, size_t N>
+  __FORCEINLINE inline void __gemm_small_kernel_vector(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t m, const size_t k)
+{
+  typedef T row_type __attribute__((vector_size(N*sizeof(T))));
+  for(size_t i = 0; i < m; i++)
+  {
+    //rows aren't necessarily aligned to vector size, memcpy is turned into unaligned loads and stores
+    row_type c_row;
+    std::memcpy(&c_row, &c[i*N], sizeof(row_type));
+    for(size_t p = 0; p < k; p++)
+    {
+      row_type b_row;
+      std::memcpy(&b_row, &b[p*N], sizeof(row_type));
+      c_row += a[i*k+p] * b_row;
+    }
+    std::memcpy(&c[i*N], &c_row, sizeof(row_type));
+  }
+}
+#endif
+
+//small kernel for compile time width of B and C only, to keep code size of larger kernels reasonable
+template<typename T, size_t N>
+  __FORCEINLINE inline void __gemm_small_kernel(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t m, const size_t k)
+{
+  for(size_t i = 0; i < m; i++)
+  {
+    T c_row[N];
+    for(size_t j = 0; j < N; j++)
+      c_row[j] = c[i*N+j];
+    for(size_t p = 0; p < k; p++)
+    {
+      const T a_ip = a[i*k+p];
+      for(size_t j = 0; j < N; j++)
+        c_row[j] += a_ip * b[p*N+j];
+    }
+    for(size_t j = 0; j < N; j++)
+      c[i*N+j] = c_row[j];
+  }
+}
+
+//small kernel for runtime sizes
+template<typename T>
+  __FORCEINLINE inline void __gemm_small_kernel(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t m, const size_t k, const size_t n)
+{
+  for(size_t i = 0; i < m; i++)
+    for(size_t p = 0; p < k; p++)
+    {
+      const T a_ip = a[i*k+p];
+      for(size_t j = 0; j < n; j++)
+        c[i*n+j] += a_ip * b[p*n+j];
+    }
+}
+
+template<typename T, size_t S, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_fixed(const AP& a, const BP& b, const CP& c, const size_t begin, const size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+    __gemm_small_kernel<T,S,S,S>(a(i),b(i),c(i));
+}
+
+template<typename T, size_t S, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_fixed_rank1(const AP& a, const BP& b, const CP& c, const size_t begin, const size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+    __gemm_small_kernel_rank1<T,S,S,S>(a(i),b(i),c(i));
+}
+
+#if defined(__GNUC__)
+template<typename T, size_t S, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_fixed_pow2(std::true_type, const AP& a, const BP& b, const CP& c, const size_t begin, const size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+    __gemm_small_kernel_vector<T,S>(a(i),b(i),c(i),S,S);
+}
+#endif
+
+template<typename T, size_t S, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_fixed_pow2(std::false_type, const AP& a, const BP& b, const CP& c, const size_t begin, const size_t end)
+{
+  return __gemm_batched_fixed_rank1<T,S>(a,b,c,begin,end);
+}
+
+template<typename T, size_t N, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_fixed_width(const AP& a, const BP& b, const CP& c,
+    const size_t m, const size_t k, const size_t begin, const size_t end)
+{
+  for(size_t i = begin; i < end; i++)
+    __gemm_small_kernel<T,N>(a(i),b(i),c(i),m,k);
+}
+
+//products [begin,end) of batch
+template<typename T, typename AP, typename BP, typename CP>
+  inline void __gemm_batched_range(const AP& a, const BP& b, const CP& c,
+    const size_t m, const size_t k, const size_t n,
+    const size_t begin, const size_t end)
+{
+  if(m == k && k == n)
+  {
+    switch(m)
+    {
+      case 2:  return __gemm_batched_fixed<T,2>(a,b,c,begin,end);
+      case 3:  return __gemm_batched_fixed<T,3>(a,b,c,begin,end);
+      case 4:  return __gemm_batched_fixed<T,4>(a,b,c,begin,end);
+      case 5:  return __gemm_batched_fixed<T,5>(a,b,c,begin,end);
+      case 6:  return __gemm_batched_fixed<T,6>(a,b,c,begin,end);
+      case 7:  return __gemm_batched_fixed<T,7>(a,b,c,begin,end);
+      case 8:  return __gemm_batched_fixed_pow2<T,8>(__batched_vector_rows<T>(),a,b,c,begin,end);
+      case 12: return __gemm_batched_fixed<T,12>(a,b,c,begin,end);
+      case 16: return __gemm_batched_fixed_pow2<T,16>(__batched_vector_rows<T>(),a,b,c,begin,end);
+      case 24: return __gemm_batched_fixed_width<T,24>(a,b,c,m,k,begin,end);
+      case 32: return __gemm_batched_fixed_width<T,32>(a,b,c,m,k,begin,end);
+      default: break;
+    }
+  }
+  for(size_t i = begin; i < end; i++)
+    __gemm_small_kernel<T>(a(i),b(i),c(i),m,k,n);
+}
+
+//batch is split between workers in contiguous ranges
+template<typename T, typename AP, typename BP, typename CP>
+  inline void dgemm_batched_helper(const AP& a, const BP& b, const CP& c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const size_t batch, const TThreading threading_model)
+{
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t flops = nrows_op_a * ncolumns_op_a * ncolumns_op_b;
+  const size_t min_batch = ( flops == 0 ? batch : ( 65536 + flops - 1 ) / flops );
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t units = batch / ( min_batch == 0 ? 1 : min_batch );
+  const size_t workers = ( max_workers < units ? max_workers : units );
+  if(batch == 0 || flops == 0)
+    return;
+  if(workers <= 1)
+    return __gemm_batched_range<T>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,0,batch);
+  run_workers(threading_model, workers, [&](const size_t t)
+  {
+    __gemm_batched_range<T>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,batch*t/workers,batch*(t+1)/workers);
+  });
+}
+
+//batched version of reduced dgemm, C[i]+=A[i]*B[i] for i in [0,batch)
+template<typename T>
+  void dgemm_batched(const TMatrixStorage stor,
+      const T* const* const a, const T* const* const b, T* const* const c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const size_t batch,
+      const TThreading threading_model)
+{
+  __check_inner_dimension("dgemm_batched", ncolumns_a, nrows_b);
+  const __batch_pointers<const T*> pa{a};
+  const __batch_pointers<const T*> pb{b};
+  const __batch_pointers<T*> pc{c};
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        return dgemm_batched_helper<T>(pa,pb,pc,nrows_a,ncolumns_a,ncolumns_b,batch,threading_model);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return dgemm_batched_helper<T>(pb,pa,pc,ncolumns_b,nrows_b,nrows_a,batch,threading_model);
+      }
+    case TMatrixStorage::Tiled:
+      //not supported, small matrices fit in single tile anyway
+      __storage_unsupported("dgemm_batched");
+  }
+}
+
+//strided batched version of reduced dgemm, C[i]+=A[i]*B[i] for i in [0,batch), X[i] = x + i*stride_x
+template<typename T>
+  void dgemm_batched(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const size_t stride_a,
+      const T* const __RESTRICT b, const size_t stride_b,
+      T* const __RESTRICT c, const size_t stride_c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const size_t batch,
+      const TThreading threading_model)
+{
+  __check_inner_dimension("dgemm_batched", ncolumns_a, nrows_b);
+  const __batch_strided<const T*> pa{a, stride_a};
+  const __batch_strided<const T*> pb{b, stride_b};
+  const __batch_strided<T*> pc{c, stride_c};
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        return dgemm_batched_helper<T>(pa,pb,pc,nrows_a,ncolumns_a,ncolumns_b,batch,threading_model);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return dgemm_batched_helper<T>(pb,pa,pc,ncolumns_b,nrows_b,nrows_a,batch,threading_model);
+      }
+    case TMatrixStorage::Tiled:
+      //not supported, small matrices fit in single tile anyway
+      __storage_unsupported("dgemm_batched");
+  }
+}
+
+}
+
+#endif /* _BLAS_BATCHED_IMPL_HPP */
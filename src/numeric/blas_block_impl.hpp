@@ -6,19 +6,15 @@
 #include "numeric/blas.hpp"
 #include "numeric/complex.hpp"
 #include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
 #include "numeric/cache.hpp"
-
-#ifdef HAVE_CILK
-#include <cilk/cilk.h>
-#endif
-
-#ifdef HAVE_TBB
-#include "numeric/parallel_tbb.hpp"
-#endif
+#include "numeric/blas_block_kernels.hpp"
 
 #include <limits>
 #include <cstddef>
 #include <cstring>
+#include <new>
+#include <vector>
 
 using std::size_t;
 
@@ -28,276 +24,332 @@ namespace numeric {
 //helper for block matrix multiplication
 //see paper "Anatomy of High-Performance Matrix Multiplication" by Kazushige Goto for detailed algorithm description
 //NB: Goto in the paper used column major ordering, we use row major here
-
-template<typename T, size_t nr, size_t mr>
-  __FORCEINLINE inline void __mm_block_op(const T * const  __RESTRICT a, const size_t stride_a,
-                                          const T * const  __RESTRICT b, const size_t stride_b,
-                                                T * const  __RESTRICT c, const size_t stride_c)
+//
+//loop structure(C += A*B, A is m x k, B is k x n):
+//  jc: n is split into panels of width nc,
+//    pc: k is split into panels of depth kc, kc x nc panel of B is packed into nr-wide slivers,
+//      ic: m is split into blocks of height mc, mc x kc block of A is packed into mr-high slivers,
+//        jr, ir: mr x nr micro tile of C is updated by micro kernel from packed slivers
+//packed slivers are zero padded, so micro kernel always works on full mr x nr tiles,
+//partial tiles on right and bottom edges are handled by edge kernel via temporary tile
+//micro kernel and block sizes are selected at runtime, see blas_block_kernels.hpp
+
+//edge kernel for partial m x n tiles(m <= mr, n <= nr)
+template<typename T>
+  __FORCEINLINE inline void __mm_block_kernel_edge(const BlockKernel<T>& kernel, const size_t kc,
+                                                   const T * const  __RESTRICT a_p,
+                                                   const T * const  __RESTRICT b_p,
+                                                         T * const  __RESTRICT c, const size_t stride_c,
+                                                   const size_t m, const size_t n)
 {
-  alignas(getDefaultAlignment<T>()) T a_pack[nr*mr];
-  for(size_t j = 0; j < mr; j++)
-    for(size_t i = 0; i < nr; i++)
-      a_pack[i*mr+j] = a[i*stride_a+j];
-
-  for(size_t kk = 0; kk < stride_c/mr; kk++)
-  {
-    for(size_t jjj = 0; jjj < mr; jjj++)
-    {
-      for(size_t kkk = 0; kkk < mr; kkk++)
-      {
-        for(size_t i = 0; i < nr; i++)
-        {
-          c[i*stride_c+kk*mr+kkk] += a_pack[i*mr+jjj] * b[kk*mr+kkk+jjj*stride_b];
-        }
-      }
-    }
-  }
+  alignas(getDefaultAlignment<T>()) T c_tile[max_block_kernel_tile_size()];
+  const size_t mr = kernel.mr, nr = kernel.nr;
+  for(size_t i = 0; i < mr*nr; i++)
+    c_tile[i] = T(0);
+  kernel.func(kc, a_p, b_p, c_tile, nr);
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+      c[i*stride_c+j] += c_tile[i*nr+j];
 }
 
-#ifdef NDEBUG
-template<>
-  __FORCEINLINE inline void __mm_block_op<double, 4, 4>(const double * const  __RESTRICT a, const size_t stride_a,
-                                                        const double * const  __RESTRICT b, const size_t stride_b,
-                                                              double * const  __RESTRICT c, const size_t stride_c)
+//offset of element (i,j) of op(X) in row major X with leading dimension ld, op(X) is X or X'(t)
+template<bool t>
+  constexpr inline size_t __mm_block_offset(const size_t ld, const size_t i, const size_t j)
 {
-  constexpr size_t pack_size = 4;
-  const size_t b_sz = stride_b/pack_size;
-  const size_t c_sz = stride_c/pack_size;
-  __m256d c_pack0, c_pack1, c_pack2, c_pack3;
-  __m256d c_tmp0, c_tmp1, c_tmp2, c_tmp3;
-
-  for(size_t kk = 0; kk < c_sz; kk++)
-  {
-      __m256d b_pack0 = _mm256_loadu_pd(&b[(kk+0*b_sz)*pack_size]);
-      __m256d b_pack1 = _mm256_loadu_pd(&b[(kk+1*b_sz)*pack_size]);
-      __m256d b_pack2 = _mm256_loadu_pd(&b[(kk+2*b_sz)*pack_size]);
-      __m256d b_pack3 = _mm256_loadu_pd(&b[(kk+3*b_sz)*pack_size]);
-
-      __m256d a_broad0 = _mm256_set1_pd(a[0+0*stride_a]);
-      __m256d a_broad1 = _mm256_set1_pd(a[1+0*stride_a]);
-      __m256d a_broad2 = _mm256_set1_pd(a[2+0*stride_a]);
-      __m256d a_broad3 = _mm256_set1_pd(a[3+0*stride_a]);
-      c_tmp0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a_broad0, b_pack0),_mm256_mul_pd(a_broad1, b_pack1)),
-                              _mm256_add_pd(_mm256_mul_pd(a_broad2, b_pack2),_mm256_mul_pd(a_broad3, b_pack3)));
-
-      __m256d a_broad4 = _mm256_set1_pd(a[0+1*stride_a]);
-      __m256d a_broad5 = _mm256_set1_pd(a[1+1*stride_a]);
-      __m256d a_broad6 = _mm256_set1_pd(a[2+1*stride_a]);
-      __m256d a_broad7 = _mm256_set1_pd(a[3+1*stride_a]);
-      c_tmp1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a_broad4, b_pack0),_mm256_mul_pd(a_broad5, b_pack1)),
-                              _mm256_add_pd(_mm256_mul_pd(a_broad6, b_pack2),_mm256_mul_pd(a_broad7, b_pack3)));
-
-      __m256d a_broad8 = _mm256_set1_pd(a[0+2*stride_a]);
-      __m256d a_broad9 = _mm256_set1_pd(a[1+2*stride_a]);
-      __m256d a_broad10 = _mm256_set1_pd(a[2+2*stride_a]);
-      __m256d a_broad11 = _mm256_set1_pd(a[3+2*stride_a]);
-      c_tmp2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a_broad8, b_pack0),_mm256_mul_pd(a_broad9, b_pack1)),
-                              _mm256_add_pd(_mm256_mul_pd(a_broad10, b_pack2),_mm256_mul_pd(a_broad11, b_pack3)));
-
-      __m256d a_broad12 = _mm256_set1_pd(a[0+3*stride_a]);
-      __m256d a_broad13 = _mm256_set1_pd(a[1+3*stride_a]);
-      __m256d a_broad14 = _mm256_set1_pd(a[2+3*stride_a]);
-      __m256d a_broad15 = _mm256_set1_pd(a[3+3*stride_a]);
-      c_tmp3 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a_broad12, b_pack0),_mm256_mul_pd(a_broad13, b_pack1)),
-                              _mm256_add_pd(_mm256_mul_pd(a_broad14, b_pack2),_mm256_mul_pd(a_broad15, b_pack3)));
-
-      c_pack0 = _mm256_loadu_pd(&c[(kk+0*c_sz)*pack_size]);
-      c_pack1 = _mm256_loadu_pd(&c[(kk+1*c_sz)*pack_size]);
-      c_pack2 = _mm256_loadu_pd(&c[(kk+2*c_sz)*pack_size]);
-      c_pack3 = _mm256_loadu_pd(&c[(kk+3*c_sz)*pack_size]);
-
-      c_pack0 = _mm256_add_pd(c_pack0, c_tmp0);
-      c_pack1 = _mm256_add_pd(c_pack1, c_tmp1);
-      c_pack2 = _mm256_add_pd(c_pack2, c_tmp2);
-      c_pack3 = _mm256_add_pd(c_pack3, c_tmp3);
-
-      _mm256_storeu_pd(&c[(kk+0*c_sz)*pack_size], c_pack0);
-      _mm256_storeu_pd(&c[(kk+1*c_sz)*pack_size], c_pack1);
-      _mm256_storeu_pd(&c[(kk+2*c_sz)*pack_size], c_pack2);
-      _mm256_storeu_pd(&c[(kk+3*c_sz)*pack_size], c_pack3);
-  }
+  return ( t ? j*ld+i : i*ld+j );
 }
-#endif
 
-/*
-template<>
-  __FORCEINLINE inline void __mm_block_op(const float * const  __RESTRICT a, const float * const  __RESTRICT b, float * const  __RESTRICT c,
-    const size_t n)
+//element (i,j) of op(X), op(X) is X, X'(t) or conjugated X'(t and c)
+template<typename T, bool t, bool c>
+  __FORCEINLINE inline T __mm_block_op(const T * const  __RESTRICT src, const size_t ld, const size_t i, const size_t j)
 {
-  const int pack_size = 8;
-  __m256 c_pack0, c_pack1, c_pack2, c_pack3, c_pack4, c_pack5, c_pack6, c_pack7;
-  c_pack0 = _mm256_loadu_ps(&c[0*pack_size]);
-  c_pack1 = _mm256_loadu_ps(&c[1*pack_size]);
-  c_pack2 = _mm256_loadu_ps(&c[2*pack_size]);
-  c_pack3 = _mm256_loadu_ps(&c[3*pack_size]);
-  c_pack4 = _mm256_loadu_ps(&c[4*pack_size]);
-  c_pack5 = _mm256_loadu_ps(&c[5*pack_size]);
-  c_pack6 = _mm256_loadu_ps(&c[6*pack_size]);
-  c_pack7 = _mm256_loadu_ps(&c[7*pack_size]);
-  for(int i = 0; i < n; i++)
-  {
-      __m256 areg0 = _mm256_set1_ps(a[i]);
-      __m256 b_pack0 = _mm256_loadu_ps(&b[pack_size*(8*i + 0)]);
-      c_pack0 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack0), c_pack0);
-      __m256 b_pack1 = _mm256_loadu_ps(&b[pack_size*(8*i + 1)]);
-      c_pack1 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack1), c_pack1);
-      __m256 b_pack2 = _mm256_loadu_ps(&b[pack_size*(8*i + 2)]);
-      c_pack2 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack2), c_pack2);
-      __m256 b_pack3 = _mm256_loadu_ps(&b[pack_size*(8*i + 3)]);
-      c_pack3 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack3), c_pack3);
-      __m256 b_pack4 = _mm256_loadu_ps(&b[pack_size*(8*i + 4)]);
-      c_pack4 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack4), c_pack4);
-      __m256 b_pack5 = _mm256_loadu_ps(&b[pack_size*(8*i + 5)]);
-      c_pack5 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack5), c_pack5);
-      __m256 b_pack6 = _mm256_loadu_ps(&b[pack_size*(8*i + 6)]);
-      c_pack6 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack6), c_pack6);
-      __m256 b_pack7 = _mm256_loadu_ps(&b[pack_size*(8*i + 7)]);
-      c_pack7 = _mm256_add_ps(_mm256_mul_ps(areg0,b_pack7), c_pack7);
-  }
-  _mm256_storeu_ps(&c[0*pack_size], c_pack0);
-  _mm256_storeu_ps(&c[1*pack_size], c_pack1);
-  _mm256_storeu_ps(&c[2*pack_size], c_pack2);
-  _mm256_storeu_ps(&c[3*pack_size], c_pack3);
-  _mm256_storeu_ps(&c[4*pack_size], c_pack4);
-  _mm256_storeu_ps(&c[5*pack_size], c_pack5);
-  _mm256_storeu_ps(&c[6*pack_size], c_pack6);
-  _mm256_storeu_ps(&c[7*pack_size], c_pack7);
+  return ( c ? conj<T>(src[__mm_block_offset<t>(ld,i,j)]) : src[__mm_block_offset<t>(ld,i,j)] );
 }
-*/
 
-template<typename T>
-  __FORCEINLINE inline void __mm_block_pack(const T * const  __RESTRICT src, const size_t src_stride, const size_t src_rows,
-                                                  T * const  __RESTRICT dst, const size_t dst_stride, const size_t dst_rows)
+//pack m x k block of alpha*op(A) into mr-high slivers, zero padding last sliver
+template<typename T, bool tA, bool cA>
+  __FORCEINLINE inline void __mm_block_pack_a(const T * const  __RESTRICT src, const size_t src_stride,
+                                              const size_t m, const size_t k, const size_t mr, const T alpha,
+                                                    T * const  __RESTRICT dst)
 {
-  for(size_t i = 0; i < src_rows; i++)
+  for(size_t ir = 0; ir < m; ir += mr)
   {
-    for(size_t j = 0; j < dst_stride; j++)
+    const size_t m_tile = ( m - ir < mr ? m - ir : mr );
+    T * const __RESTRICT dst_sliver = &dst[ir*k];
+    for(size_t p = 0; p < k; p++)
     {
-      dst[i*dst_stride+j] = src[i*src_stride+j];
+      for(size_t i = 0; i < m_tile; i++)
+        dst_sliver[p*mr+i] = alpha * __mm_block_op<T,tA,cA>(src,src_stride,ir+i,p);
+      for(size_t i = m_tile; i < mr; i++)
+        dst_sliver[p*mr+i] = T(0);
     }
   }
-  if(dst_rows > src_rows)
-  {
-    for(size_t n = src_rows*dst_stride; n < dst_rows*dst_stride; n++)
-      dst[n] = 0;
-  }
 }
 
-
-template<typename T, size_t mr>
-  __FORCEINLINE inline void __mm_block_pack_zorder_down(const T * const  __RESTRICT src, const size_t src_stride, const size_t src_rows,
-                                                              T * const  __RESTRICT dst, const size_t dst_stride, const size_t dst_rows)
+//pack k x n panel of op(B) into nr-wide slivers, zero padding last sliver
+template<typename T, bool tB, bool cB>
+  __FORCEINLINE inline void __mm_block_pack_b(const T * const  __RESTRICT src, const size_t src_stride,
+                                              const size_t k, const size_t n, const size_t nr,
+                                                    T * const  __RESTRICT dst)
 {
-  for(size_t i = 0; i < src_rows; i++)
+  for(size_t jr = 0; jr < n; jr += nr)
   {
-    for(size_t j = 0; j < dst_stride; j++)
+    const size_t n_tile = ( n - jr < nr ? n - jr : nr );
+    T * const __RESTRICT dst_sliver = &dst[jr*k];
+    for(size_t p = 0; p < k; p++)
     {
-      dst[(i/mr)*mr*dst_stride+i%mr+j*mr] = src[i*src_stride+j];
+      for(size_t j = 0; j < n_tile; j++)
+        dst_sliver[p*nr+j] = __mm_block_op<T,tB,cB>(src,src_stride,p,jr+j);
+      for(size_t j = n_tile; j < nr; j++)
+        dst_sliver[p*nr+j] = T(0);
     }
   }
-  if(dst_rows > src_rows)
-  {
-    for(size_t i = src_rows; i < dst_rows; i++)
-      for(size_t j = 0; j < dst_stride; j++)
-        dst[(i/mr)*mr*dst_stride+i%mr+j*mr] = 0;
-  }
 }
 
+//macro kernel, C[m x n] += packed A[m x k] * packed B[k x n]
 template<typename T>
-  __FORCEINLINE inline void __mm_block_unpack(const T * const  __RESTRICT src, const size_t src_stride, const size_t src_rows,
-                                                    T * const  __RESTRICT dst, const size_t dst_stride, const size_t dst_rows)
+  __FORCEINLINE inline void __mm_block_macro_kernel(const BlockKernel<T>& kernel,
+                                                    const size_t m, const size_t n, const size_t k,
+                                                    const T * const  __RESTRICT a_p,
+                                                    const T * const  __RESTRICT b_p,
+                                                          T * const  __RESTRICT c, const size_t stride_c)
 {
-  for(size_t i = 0; i < dst_rows; i++)
+  const size_t mr = kernel.mr, nr = kernel.nr;
+  for(size_t jr = 0; jr < n; jr += nr)
   {
-    for(size_t j = 0; j < src_stride; j++)
+    const size_t n_tile = ( n - jr < nr ? n - jr : nr );
+    for(size_t ir = 0; ir < m; ir += mr)
     {
-      dst[i*dst_stride+j] = src[i*src_stride+j];
+      const size_t m_tile = ( m - ir < mr ? m - ir : mr );
+      if(m_tile == mr && n_tile == nr)
+        kernel.func(k, &a_p[ir*k], &b_p[jr*k], &c[ir*stride_c+jr], stride_c);
+      else
+        __mm_block_kernel_edge<T>(kernel, k, &a_p[ir*k], &b_p[jr*k], &c[ir*stride_c+jr], stride_c, m_tile, n_tile);
     }
   }
 }
 
+constexpr inline size_t __round_up(const size_t val, const size_t inc)
+{
+  return ( val % inc == 0 ? val : val - (val % inc) + inc);
+}
 
+//aligned buffer for packed blocks, reused across iterations
 template<typename T>
-  __FORCEINLINE inline void __mm_block_unpack_add(const T * const  __RESTRICT src, const size_t src_stride, const size_t src_rows,
-                                                        T * const  __RESTRICT dst, const size_t dst_stride, const size_t dst_rows)
+  inline T* __mm_block_alloc(const size_t sz, unique_aligned_buf_ptr& buf)
+{
+  void * raw = nullptr;
+  T * const aligned = reinterpret_cast<T*>(aligned_malloc(sizeof(T) * sz, getDefaultAlignment<T>(), &raw));
+  buf.reset(raw);
+  if(aligned == nullptr)
+    throw std::bad_alloc();
+  return aligned;
+}
+
+//matrix packed once into layout of block dgemm operand, so that repeated products with it skip packing
+//every kc-deep panel holds all zero padded mr-high(left operand) or nr-wide(right operand) slivers of row major matrix,
+//so packed block starting at any multiple of mr(nr) is contiguous part of panel, whatever mc(nc) is
+//micro kernel and kc are fixed at packing time
+template<typename T> class BlockPackedMatrix
 {
-  for(size_t i = 0; i < dst_rows; i++)
+  unique_aligned_buf_ptr m_buf;
+  T* m_data;
+  const BlockKernel<T>* m_kernel;
+  TMatrixStorage m_stor;
+  bool m_left;
+  size_t m_nrows, m_ncolumns;
+  size_t m_width, m_depth, m_kc;
+public:
+  BlockPackedMatrix() : m_buf(nullptr), m_data(nullptr), m_kernel(nullptr), m_stor(TMatrixStorage::RowMajor), m_left(true)
+    , m_nrows(0), m_ncolumns(0), m_width(0), m_depth(0), m_kc(0) {}
+  //pack row major width x depth matrix(left operand) or depth x width matrix(right operand) with leading dimension ld
+  BlockPackedMatrix(const TMatrixStorage stor, const bool left,
+      const T* const __RESTRICT x, const size_t ld,
+      const size_t nrows, const size_t ncolumns,
+      const size_t width, const size_t depth)
+    : m_buf(nullptr), m_data(nullptr), m_stor(stor), m_left(left)
+    , m_nrows(nrows), m_ncolumns(ncolumns), m_width(width), m_depth(depth)
   {
-    for(size_t j = 0; j < src_stride; j++)
+    const BlockConfig<T> config = block_config<T>();
+    m_kernel = config.kernel;
+    m_kc = config.sizes.kc;
+    const size_t r = getSliverSize();
+    if(m_width == 0 || m_depth == 0)
+      return;
+    m_data = __mm_block_alloc<T>(__round_up(m_width, r) * m_depth, m_buf);
+    for(size_t pc = 0; pc < m_depth; pc += m_kc)
     {
-      dst[i*dst_stride+j] += src[i*src_stride+j];
+      const size_t k_block = ( m_depth - pc < m_kc ? m_depth - pc : m_kc );
+      if(m_left)
+        __mm_block_pack_a<T,false,false>(&x[pc], ld, m_width, k_block, r, T(1), getPanel(pc));
+      else
+        __mm_block_pack_b<T,false,false>(&x[pc*ld], ld, k_block, m_width, r, getPanel(pc));
     }
   }
+  TMatrixStorage getStorage() const { return m_stor; }
+  size_t getRowsNum() const { return m_nrows; }
+  size_t getColumnsNum() const { return m_ncolumns; }
+  //packed as left operand of row major product
+  bool isLeft() const { return m_left; }
+  //rows(left operand) or columns(right operand) of row major matrix
+  size_t getWidth() const { return m_width; }
+  //columns(left operand) or rows(right operand) of row major matrix
+  size_t getDepth() const { return m_depth; }
+  size_t getPanelDepth() const { return m_kc; }
+  const BlockKernel<T>& getKernel() const { return *m_kernel; }
+  size_t getSliverSize() const { return ( m_left ? m_kernel->mr : m_kernel->nr ); }
+  //panel starting at row(left operand) or column(right operand) pc of row major matrix
+  T* getPanel(const size_t pc) { return &m_data[pc * __round_up(m_width, getSliverSize())]; }
+  const T* getPanel(const size_t pc) const { return &m_data[pc * __round_up(m_width, getSliverSize())]; }
+};
+
+//block sizes and micro kernel of product, prepacked operand dictates kernel and kc
+template<typename T>
+  inline BlockConfig<T> __mm_block_config(const BlockPackedMatrix<T>* const a_packed, const BlockPackedMatrix<T>* const b_packed)
+{
+  BlockConfig<T> config = block_config<T>();
+  const BlockPackedMatrix<T>* const packed = ( a_packed != nullptr ? a_packed : b_packed );
+  if(packed != nullptr)
+  {
+    config.kernel = &packed->getKernel();
+    config.sizes.kc = packed->getPanelDepth();
+  }
+  return config;
 }
 
-constexpr inline size_t __round_up(const size_t val, const size_t inc)
+//block matrix multiplication C += alpha*op(A)*op(B) for submatrices with leading dimensions(strides) lda, ldb, ldc
+template<typename T, bool tA = false, bool tB = false, bool cA = false, bool cB = false>
+  inline void __block_matmul_serial(const T* const  __RESTRICT a, const size_t lda,
+    const T* const  __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const T alpha = T(1),
+    const BlockPackedMatrix<T>* const a_packed = nullptr, const BlockPackedMatrix<T>* const b_packed = nullptr)
 {
-  return ( val % inc == 0 ? val : val - (val % inc) + inc);
+  //calculate block sizes
+  const BlockConfig<T> config = __mm_block_config<T>(a_packed, b_packed);
+  const BlockKernel<T>& kernel = *config.kernel;
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  const size_t mc = __round_up(config.sizes.mc, mr);
+  const size_t kc = config.sizes.kc;
+  const size_t nc = __round_up(config.sizes.nc, nr);
+  if(nrows_op_a == 0 || ncolumns_op_a == 0 || ncolumns_op_b == 0)
+    return;
+  //allocate memory for packed blocks once
+  const size_t mc_sz = ( nrows_op_a < mc ? __round_up(nrows_op_a, mr) : mc );
+  const size_t kc_sz = ( ncolumns_op_a < kc ? ncolumns_op_a : kc );
+  const size_t nc_sz = ( ncolumns_op_b < nc ? __round_up(ncolumns_op_b, nr) : nc );
+  unique_aligned_buf_ptr a_buf, b_buf;
+  T * const Aic_buf = ( a_packed == nullptr ? __mm_block_alloc<T>(mc_sz * kc_sz, a_buf) : nullptr );
+  T * const Bpj_buf = ( b_packed == nullptr ? __mm_block_alloc<T>(kc_sz * nc_sz, b_buf) : nullptr );
+  for(size_t jc = 0; jc < ncolumns_op_b; jc += nc)
+  {
+    const size_t n_block = ( ncolumns_op_b - jc < nc ? ncolumns_op_b - jc : nc );
+    for(size_t pc = 0; pc < ncolumns_op_a; pc += kc)
+    {
+      const size_t k_block = ( ncolumns_op_a - pc < kc ? ncolumns_op_a - pc : kc );
+      //pack Bpj -> Bpj_p to minimize L2 cache misses and assist vectorization
+      const T * const __RESTRICT Bpj_p = ( b_packed != nullptr ? &b_packed->getPanel(pc)[jc*k_block] : Bpj_buf );
+      if(b_packed == nullptr)
+        __mm_block_pack_b<T,tB,cB>(&b[__mm_block_offset<tB>(ldb,pc,jc)], ldb, k_block, n_block, nr, Bpj_buf);
+      for(size_t ic = 0; ic < nrows_op_a; ic += mc)
+      {
+        const size_t m_block = ( nrows_op_a - ic < mc ? nrows_op_a - ic : mc );
+        //pack Aic -> Aic_p to minimize TLB misses
+        const T * const __RESTRICT Aic_p = ( a_packed != nullptr ? &a_packed->getPanel(pc)[ic*k_block] : Aic_buf );
+        if(a_packed == nullptr)
+          __mm_block_pack_a<T,tA,cA>(&a[__mm_block_offset<tA>(lda,ic,pc)], lda, m_block, k_block, mr, alpha, Aic_buf);
+        __mm_block_macro_kernel<T>(kernel, m_block, n_block, k_block, Aic_p, Bpj_p, &c[ic*ldc+jc], ldc);
+      }
+    }
+  }
 }
 
 template<typename T>
   inline void block_matmul_serial(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
-  //calculate block sizes and index limits
-  constexpr size_t mr = default_max_hw_vector_size() / sizeof(T);
-  constexpr size_t nr = default_max_hw_vector_size() / sizeof(T);
-//  const size_t mc = __round_up((default_tlb_page_capacity() - (nr+4)) * default_page_size() / ( sizeof(T) *__round_up(nrows_op_a, nr) ), mr);
-//TODO: block size tuning
-  const size_t mc = 128;
-  const size_t kc = mc; // wild guess
-  const size_t nrows_op_a_rounded = __round_up(nrows_op_a, nr);
-  const size_t sz_i = nrows_op_a / nr;
-  const size_t sz_j = ncolumns_op_a / mc;
-  const size_t sz_k = ncolumns_op_b / kc;
-  const size_t remainder_sz_i = nrows_op_a % nr;
-  const size_t remainder_sz_j = ncolumns_op_a % mc;
-  const size_t remainder_sz_k = ncolumns_op_b % kc;
-  //allocate memory for packed blocks
-//  void * buf = nullptr;
-//  T * const Aj_p = reinterpret_cast<T * const>(aligned_malloc(sizeof(T) * mc * __round_up(nrows_op_a, nr), getDefaultAlignment<T>(), buf));
-//  T * const Bjk_p = reinterpret_cast<T * const>(aligned_malloc(sizeof(T) * mc * kc, getDefaultAlignment<T>(), buf));
-//  T * const Cjki_p = reinterpret_cast<T * const>(aligned_malloc(sizeof(T) * nr * kc, getDefaultAlignment<T>(), buf));
-  for(size_t j = 0; j < sz_j; j++)
+  __block_matmul_serial<T>(a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
+}
+
+//parallel version of block matrix multiplication
+//for every kc x nc panel of B: workers pack disjoint sets of nr-wide slivers into shared buffer,
+//then every worker packs mc x kc blocks of A from its own range of rows into its own buffer
+//and updates corresponding rows of C, so no synchronization is needed except joining workers after each phase,
+//which is cheap for std and posix backends as their regions run on persistent pool of ParallelScheduler
+template<typename T, bool tA = false, bool tB = false, bool cA = false, bool cB = false>
+  inline void __block_matmul_parallel(const TThreading threading_model,
+    const T* const  __RESTRICT a, const size_t lda,
+    const T* const  __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const T alpha = T(1),
+    const BlockPackedMatrix<T>* const a_packed = nullptr, const BlockPackedMatrix<T>* const b_packed = nullptr)
+{
+  //calculate block sizes
+  const BlockConfig<T> config = __mm_block_config<T>(a_packed, b_packed);
+  const BlockKernel<T>& kernel = *config.kernel;
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  const size_t mc = __round_up(config.sizes.mc, mr);
+  const size_t kc = config.sizes.kc;
+  const size_t nc = __round_up(config.sizes.nc, nr);
+  if(nrows_op_a == 0 || ncolumns_op_a == 0 || ncolumns_op_b == 0)
+    return;
+  //split rows of C between workers in multiples of mr
+  const size_t row_slivers = __round_up(nrows_op_a, mr) / mr;
+  const size_t max_workers = ParallelScheduler::getThreadsNumber();
+  const size_t workers = ( max_workers == 0 ? 1 : ( max_workers < row_slivers ? max_workers : row_slivers ) );
+  if(workers <= 1)
+    return __block_matmul_serial<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,nrows_op_a,ncolumns_op_a,ncolumns_op_b,alpha,a_packed,b_packed);
+  const size_t worker_rows = ( row_slivers + workers - 1 ) / workers * mr;
+  //allocate memory for packed blocks once: shared panel of B, private blocks of A
+  const size_t mc_sz = ( worker_rows < mc ? worker_rows : mc );
+  const size_t kc_sz = ( ncolumns_op_a < kc ? ncolumns_op_a : kc );
+  const size_t nc_sz = ( ncolumns_op_b < nc ? __round_up(ncolumns_op_b, nr) : nc );
+  unique_aligned_buf_ptr b_buf;
+  T * const Bpj_buf = ( b_packed == nullptr ? __mm_block_alloc<T>(kc_sz * nc_sz, b_buf) : nullptr );
+  std::vector<unique_aligned_buf_ptr> a_bufs(workers);
+  std::vector<T*> Aic_buf(workers, nullptr);
+  if(a_packed == nullptr)
+    for(size_t t = 0; t < workers; t++)
+      Aic_buf[t] = __mm_block_alloc<T>(mc_sz * kc_sz, a_bufs[t]);
+  for(size_t jc = 0; jc < ncolumns_op_b; jc += nc)
   {
-    alignas(getDefaultAlignment<T>()) T Aj_p[nrows_op_a_rounded * mc];
-    alignas(getDefaultAlignment<T>()) T Bjk_p[mc * kc];
-    alignas(getDefaultAlignment<T>()) T Cjki_p[nr * kc];
-    //pack Aj -> Aj_p to minimize TLB misses
-    __mm_block_pack<T>(&a[j*mc], ncolumns_op_a, nrows_op_a, Aj_p, mc, nrows_op_a_rounded);
-    for(size_t k = 0; k < sz_k; k++)
+    const size_t n_block = ( ncolumns_op_b - jc < nc ? ncolumns_op_b - jc : nc );
+    const size_t col_slivers = __round_up(n_block, nr) / nr;
+    for(size_t pc = 0; pc < ncolumns_op_a; pc += kc)
     {
-      //pack Bjk -> Bjk_p to minimize L2 cache misses and assist vectorization
-      __mm_block_pack<T>(&b[j*mc*ncolumns_op_b+k*kc], ncolumns_op_b, mc, Bjk_p, kc, mc);
-      for(size_t i = 0; i < sz_i; i++)
-      {
-        memset(reinterpret_cast<void*>(Cjki_p), 0, nr * kc * sizeof(T));
-        for(size_t jj = 0; jj < mc/mr; jj++)
+      const size_t k_block = ( ncolumns_op_a - pc < kc ? ncolumns_op_a - pc : kc );
+      //pack Bpj -> Bpj_p, every worker packs its own range of slivers
+      const T * const __RESTRICT Bpj_p = ( b_packed != nullptr ? &b_packed->getPanel(pc)[jc*k_block] : Bpj_buf );
+      if(b_packed == nullptr)
+        run_workers(threading_model, workers, [&](const size_t t)
         {
-          __mm_block_op<T,nr,mr>(&Aj_p[i*nr*mc+jj*mr], mc, &Bjk_p[jj*mr*kc], kc, Cjki_p, kc);
-        }
-        //unpack Cjki_p
-        __mm_block_unpack_add<T>(Cjki_p, kc, nr, &c[i*nr*ncolumns_op_b+j*kc], ncolumns_op_b, nr);
-      }
-      //remainder
-      if(remainder_sz_i != 0)
+          const size_t sliver_begin = col_slivers * t / workers;
+          const size_t sliver_end = col_slivers * (t + 1) / workers;
+          if(sliver_begin == sliver_end)
+            return;
+          const size_t j_begin = sliver_begin * nr;
+          const size_t j_end = ( sliver_end * nr < n_block ? sliver_end * nr : n_block );
+          __mm_block_pack_b<T,tB,cB>(&b[__mm_block_offset<tB>(ldb,pc,jc+j_begin)], ldb, k_block, j_end - j_begin, nr, &Bpj_buf[j_begin*k_block]);
+        });
+      //pack Aic -> Aic_p and update C, every worker processes its own range of rows
+      run_workers(threading_model, workers, [&](const size_t t)
       {
-        memset(reinterpret_cast<void*>(Cjki_p), 0, nr * kc * sizeof(T));
-        for(size_t jj = 0; jj < mc/mr; jj++)
+        const size_t i_begin = worker_rows * t;
+        const size_t i_end = ( worker_rows * (t + 1) < nrows_op_a ? worker_rows * (t + 1) : nrows_op_a );
+        for(size_t ic = i_begin; ic < i_end; ic += mc)
         {
-          __mm_block_op<T,nr,mr>(&Aj_p[sz_i*nr*mc+jj*mr], mc, &Bjk_p[jj*mr*kc], kc, Cjki_p, kc);
+          const size_t m_block = ( i_end - ic < mc ? i_end - ic : mc );
+          const T * const __RESTRICT Aic_p = ( a_packed != nullptr ? &a_packed->getPanel(pc)[ic*k_block] : Aic_buf[t] );
+          if(a_packed == nullptr)
+            __mm_block_pack_a<T,tA,cA>(&a[__mm_block_offset<tA>(lda,ic,pc)], lda, m_block, k_block, mr, alpha, Aic_buf[t]);
+          __mm_block_macro_kernel<T>(kernel, m_block, n_block, k_block, Aic_p, Bpj_p, &c[ic*ldc+jc], ldc);
         }
-        __mm_block_unpack_add<T>(Cjki_p, kc, nr, &c[sz_i*nr*ncolumns_op_b+j*kc], ncolumns_op_b, remainder_sz_i);
-      }
+      });
     }
-    //remainder loop
-    for(size_t k = 0; k < remainder_sz_k; k++)
-    {
-    }
-  }
-  //remainder loop
-  for(size_t j = 0; j < remainder_sz_j; j++)
-  {
   }
 }
 
@@ -305,6 +357,7 @@ template<typename T>
   inline void block_matmul_stdthreads(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
+  __block_matmul_parallel<T>(T_Std,a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 }
 
 #ifdef HAVE_PTHREADS
@@ -312,6 +365,7 @@ template<typename T>
   inline void block_matmul_pthreads(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
+  __block_matmul_parallel<T>(T_Posix,a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 }
 #endif
 
@@ -320,6 +374,7 @@ template<typename T>
   inline void block_matmul_openmp(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
+  __block_matmul_parallel<T>(T_OpenMP,a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 }
 #endif
 
@@ -328,6 +383,7 @@ template<typename T>
   inline void block_matmul_cilk(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
+  __block_matmul_parallel<T>(T_Cilk,a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 }
 #endif
 
@@ -336,6 +392,7 @@ template<typename T>
   inline void block_matmul_tbb(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
     const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b)
 {
+  __block_matmul_parallel<T>(T_TBB,a,ncolumns_op_a,b,ncolumns_op_b,c,ncolumns_op_b,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 }
 #endif
 
@@ -356,7 +413,7 @@ template<typename T>
 #endif
 #ifdef HAVE_OPENMP
     case T_OpenMP:
-      return block_matmul_serial<T>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
+      return block_matmul_openmp<T>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b);
 #endif
 #ifdef HAVE_CILK
     case T_Cilk:
@@ -392,6 +449,11 @@ template<typename T>
         //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
         return dgemm_block_helper<T>(b,a,c,ncolumns_b,nrows_b,nrows_a,threading_model);
       }
+    case TMatrixStorage::Tiled:
+      {
+        //tiled matrices are multiplied tile by tile by recursive implementation, which uses block dgemm for tiles
+        return dgemm_recursive<T>(stor,TMatrixTranspose::No,TMatrixTranspose::No,a,b,c,nrows_a,ncolumns_a,nrows_b,ncolumns_b,threading_model);
+      }
   }
 }
 
@@ -405,6 +467,105 @@ template<typename T>
     return dgemm_block<T>(stor,a,b,c,sz,sz,sz,sz,threading_model);
 }
 
+//pack left operand of block dgemm once
+template<typename T>
+  BlockPackedMatrix<T> dgemm_block_pack_a(const TMatrixStorage stor,
+      const T* const __RESTRICT a,
+      const size_t nrows_a, const size_t ncolumns_a)
+{
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      return BlockPackedMatrix<T>(stor,true,a,ncolumns_a,nrows_a,ncolumns_a,nrows_a,ncolumns_a);
+    case TMatrixStorage::ColumnMajor:
+      //column major A is row major A', which is right operand of C'=(op(B))'*(op(A))'
+      return BlockPackedMatrix<T>(stor,false,a,nrows_a,nrows_a,ncolumns_a,nrows_a,ncolumns_a);
+    case TMatrixStorage::Tiled:
+      //not supported, tiles are packed by every product anyway
+      __storage_unsupported("dgemm_block_pack_a");
+  }
+  return BlockPackedMatrix<T>();
+}
+
+//pack right operand of block dgemm once
+template<typename T>
+  BlockPackedMatrix<T> dgemm_block_pack_b(const TMatrixStorage stor,
+      const T* const __RESTRICT b,
+      const size_t nrows_b, const size_t ncolumns_b)
+{
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      return BlockPackedMatrix<T>(stor,false,b,ncolumns_b,nrows_b,ncolumns_b,ncolumns_b,nrows_b);
+    case TMatrixStorage::ColumnMajor:
+      //column major B is row major B', which is left operand of C'=(op(B))'*(op(A))'
+      return BlockPackedMatrix<T>(stor,true,b,nrows_b,nrows_b,ncolumns_b,ncolumns_b,nrows_b);
+    case TMatrixStorage::Tiled:
+      //not supported, tiles are packed by every product anyway
+      __storage_unsupported("dgemm_block_pack_b");
+  }
+  return BlockPackedMatrix<T>();
+}
+
+template<typename T>
+  inline void dgemm_block_packed_helper(const T* const  __RESTRICT a, const size_t lda,
+    const T* const  __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const BlockPackedMatrix<T>* const a_packed, const BlockPackedMatrix<T>* const b_packed,
+    const TThreading threading_model)
+{
+  if(threading_model == T_Serial || threading_model == T_Undefined)
+    return __block_matmul_serial<T>(a,lda,b,ldb,c,ldc,nrows_op_a,ncolumns_op_a,ncolumns_op_b,T(1),a_packed,b_packed);
+  return __block_matmul_parallel<T>(threading_model,a,lda,b,ldb,c,ldc,nrows_op_a,ncolumns_op_a,ncolumns_op_b,T(1),a_packed,b_packed);
+}
+
+//block dgemm with prepacked left operand, C=A*B
+template<typename T>
+  void dgemm_block(const BlockPackedMatrix<T>& a,
+      const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model)
+{
+  __check_inner_dimension("dgemm_block", a.getDepth(), nrows_b);
+  switch(a.getStorage())
+  {
+    case TMatrixStorage::RowMajor:
+      return dgemm_block_packed_helper<T>(nullptr,0,b,ncolumns_b,c,ncolumns_b,
+          a.getWidth(),a.getDepth(),ncolumns_b,&a,nullptr,threading_model);
+    case TMatrixStorage::ColumnMajor:
+      //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B), A' is packed as right operand
+      return dgemm_block_packed_helper<T>(b,nrows_b,nullptr,0,c,a.getWidth(),
+          ncolumns_b,nrows_b,a.getWidth(),nullptr,&a,threading_model);
+    case TMatrixStorage::Tiled:
+      //never packed
+      __storage_unsupported("dgemm_block");
+  }
+}
+
+//block dgemm with prepacked right operand, C=A*B
+template<typename T>
+  void dgemm_block(const T* const __RESTRICT a,
+      const BlockPackedMatrix<T>& b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const TThreading threading_model)
+{
+  __check_inner_dimension("dgemm_block", ncolumns_a, b.getDepth());
+  switch(b.getStorage())
+  {
+    case TMatrixStorage::RowMajor:
+      return dgemm_block_packed_helper<T>(a,ncolumns_a,nullptr,0,c,b.getWidth(),
+          nrows_a,ncolumns_a,b.getWidth(),nullptr,&b,threading_model);
+    case TMatrixStorage::ColumnMajor:
+      //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B), B' is packed as left operand
+      return dgemm_block_packed_helper<T>(nullptr,0,a,nrows_a,c,nrows_a,
+          b.getWidth(),ncolumns_a,nrows_a,&b,nullptr,threading_model);
+    case TMatrixStorage::Tiled:
+      //never packed
+      __storage_unsupported("dgemm_block");
+  }
+}
+
 
 }
 
@@ -0,0 +1,400 @@
+#include "numeric/blas_block_kernels.hpp"
+#include "numeric/cpu_features.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+//simd kernels are compiled for their own instruction sets regardless of compiler flags
+//and are registered only if cpu supports them, so the same binary runs on any x86 cpu
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define NUMERIC_BLOCK_KERNELS_X86
+# define NUMERIC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace numeric {
+
+#ifdef NUMERIC_BLOCK_KERNELS_X86
+
+//every kernel keeps mr x nr tile of C in registers: mr rows of nv vectors each,
+//row of packed B is loaded once per iteration, values of packed A are broadcasted
+
+NUMERIC_TARGET("sse2")
+static void block_kernel_sse2_d4x4(const size_t kc, const double * const __RESTRICT a_p, const double * const __RESTRICT b_p,
+                                   double * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 4, nv = 2, w = 2;
+  __m128d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm_setzero_pd();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m128d b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm_load_pd(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m128d a_broad = _mm_set1_pd(a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm_add_pd(acc[i][v], _mm_mul_pd(a_broad, b_pack[v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm_storeu_pd(&c[i*stride_c+v*w], _mm_add_pd(_mm_loadu_pd(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("sse2")
+static void block_kernel_sse2_s4x8(const size_t kc, const float * const __RESTRICT a_p, const float * const __RESTRICT b_p,
+                                   float * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 4, nv = 2, w = 4;
+  __m128 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm_setzero_ps();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m128 b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm_load_ps(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m128 a_broad = _mm_set1_ps(a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm_add_ps(acc[i][v], _mm_mul_ps(a_broad, b_pack[v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm_storeu_ps(&c[i*stride_c+v*w], _mm_add_ps(_mm_loadu_ps(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx")
+static void block_kernel_avx_d4x8(const size_t kc, const double * const __RESTRICT a_p, const double * const __RESTRICT b_p,
+                                  double * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 4, nv = 2, w = 4;
+  __m256d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_pd();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m256d b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm256_load_pd(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256d a_broad = _mm256_broadcast_sd(&a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_add_pd(acc[i][v], _mm256_mul_pd(a_broad, b_pack[v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_pd(&c[i*stride_c+v*w], _mm256_add_pd(_mm256_loadu_pd(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx")
+static void block_kernel_avx_s4x16(const size_t kc, const float * const __RESTRICT a_p, const float * const __RESTRICT b_p,
+                                   float * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 4, nv = 2, w = 8;
+  __m256 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_ps();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m256 b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm256_load_ps(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256 a_broad = _mm256_broadcast_ss(&a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_add_ps(acc[i][v], _mm256_mul_ps(a_broad, b_pack[v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_ps(&c[i*stride_c+v*w], _mm256_add_ps(_mm256_loadu_ps(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void block_kernel_avx2_fma_d6x8(const size_t kc, const double * const __RESTRICT a_p, const double * const __RESTRICT b_p,
+                                       double * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 6, nv = 2, w = 4;
+  __m256d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_pd();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m256d b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm256_load_pd(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256d a_broad = _mm256_broadcast_sd(&a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_fmadd_pd(a_broad, b_pack[v], acc[i][v]);
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_pd(&c[i*stride_c+v*w], _mm256_add_pd(_mm256_loadu_pd(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void block_kernel_avx2_fma_s6x16(const size_t kc, const float * const __RESTRICT a_p, const float * const __RESTRICT b_p,
+                                        float * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 6, nv = 2, w = 8;
+  __m256 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_ps();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m256 b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm256_load_ps(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256 a_broad = _mm256_broadcast_ss(&a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_fmadd_ps(a_broad, b_pack[v], acc[i][v]);
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_ps(&c[i*stride_c+v*w], _mm256_add_ps(_mm256_loadu_ps(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx512f")
+static void block_kernel_avx512_d12x16(const size_t kc, const double * const __RESTRICT a_p, const double * const __RESTRICT b_p,
+                                       double * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 12, nv = 2, w = 8;
+  __m512d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm512_setzero_pd();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m512d b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm512_load_pd(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m512d a_broad = _mm512_set1_pd(a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm512_fmadd_pd(a_broad, b_pack[v], acc[i][v]);
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm512_storeu_pd(&c[i*stride_c+v*w], _mm512_add_pd(_mm512_loadu_pd(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx512f")
+static void block_kernel_avx512_s12x32(const size_t kc, const float * const __RESTRICT a_p, const float * const __RESTRICT b_p,
+                                       float * const __RESTRICT c, const size_t stride_c)
+{
+  constexpr size_t mr = 12, nv = 2, w = 16;
+  __m512 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm512_setzero_ps();
+  for(size_t p = 0; p < kc; p++)
+  {
+    __m512 b_pack[nv];
+    for(size_t v = 0; v < nv; v++)
+      b_pack[v] = _mm512_load_ps(&b_p[p*nv*w+v*w]);
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m512 a_broad = _mm512_set1_ps(a_p[p*mr+i]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm512_fmadd_ps(a_broad, b_pack[v], acc[i][v]);
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm512_storeu_ps(&c[i*stride_c+v*w], _mm512_add_ps(_mm512_loadu_ps(&c[i*stride_c+v*w]), acc[i][v]));
+}
+
+#endif
+
+template<typename T> static void register_generic_block_kernel(std::vector<BlockKernel<T>>& kernels)
+{
+  constexpr size_t nr = generic_block_kernel_nr<T>();
+  static_assert(4 * nr <= max_block_kernel_tile_size(), "generic micro kernel tile is too large");
+  kernels.push_back({ "generic", 4, nr, &__mm_block_kernel_generic<T,4,nr> });
+}
+
+static std::vector<BlockKernel<double>> make_block_kernels_double()
+{
+  std::vector<BlockKernel<double>> kernels;
+#ifdef NUMERIC_BLOCK_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-12x16", 12, 16, &block_kernel_avx512_d12x16 });
+  if(cpu.avx2 && cpu.fma)
+    kernels.push_back({ "avx2-fma-6x8", 6, 8, &block_kernel_avx2_fma_d6x8 });
+  if(cpu.avx)
+    kernels.push_back({ "avx-4x8", 4, 8, &block_kernel_avx_d4x8 });
+  if(cpu.sse2)
+    kernels.push_back({ "sse2-4x4", 4, 4, &block_kernel_sse2_d4x4 });
+#endif
+  register_generic_block_kernel<double>(kernels);
+  return kernels;
+}
+
+static std::vector<BlockKernel<float>> make_block_kernels_float()
+{
+  std::vector<BlockKernel<float>> kernels;
+#ifdef NUMERIC_BLOCK_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-12x32", 12, 32, &block_kernel_avx512_s12x32 });
+  if(cpu.avx2 && cpu.fma)
+    kernels.push_back({ "avx2-fma-6x16", 6, 16, &block_kernel_avx2_fma_s6x16 });
+  if(cpu.avx)
+    kernels.push_back({ "avx-4x16", 4, 16, &block_kernel_avx_s4x16 });
+  if(cpu.sse2)
+    kernels.push_back({ "sse2-4x8", 4, 8, &block_kernel_sse2_s4x8 });
+#endif
+  register_generic_block_kernel<float>(kernels);
+  return kernels;
+}
+
+template<> const std::vector<BlockKernel<float>>& block_kernels<float>()
+{
+  static const std::vector<BlockKernel<float>> kernels = make_block_kernels_float();
+  return kernels;
+}
+
+template<> const std::vector<BlockKernel<double>>& block_kernels<double>()
+{
+  static const std::vector<BlockKernel<double>> kernels = make_block_kernels_double();
+  return kernels;
+}
+
+static size_t clamp_size(const size_t val, const size_t lo, const size_t hi)
+{
+  return ( val < lo ? lo : ( val > hi ? hi : val ) );
+}
+
+BlockSizes default_block_sizes(const size_t type_size, const size_t mr, const size_t nr)
+{
+  const size_t l1 = ( cache_size(1) > 0 ? cache_size(1) : 32*1024 );
+  const size_t l2 = ( cache_size(2) > 0 ? cache_size(2) : (DEFAULT_L2_CACHE_SIZE) );
+  const size_t l3 = cache_size(3);
+  BlockSizes sizes;
+  sizes.kc = clamp_size(l1 / ( 2 * nr * type_size ) / 8 * 8, 64, 1024);
+  sizes.mc = clamp_size(l2 / ( 2 * sizes.kc * type_size ) / mr * mr, mr, 1024 / mr * mr);
+  sizes.nc = ( l3 > 0 ? clamp_size(l3 / ( 2 * sizes.kc * type_size ) / nr * nr, nr, 8192 / nr * nr) : 4096 / nr * nr );
+  return sizes;
+}
+
+std::string block_profile_path()
+{
+  const char* path = std::getenv("CALC_BLOCK_PROFILE");
+  if(path != nullptr && path[0] != '\0')
+    return path;
+  const char* home = std::getenv("HOME");
+  if(home == nullptr)
+    home = std::getenv("USERPROFILE");
+  return std::string( home != nullptr ? home : "." ) + "/.calc_block_profile";
+}
+
+//cpu model as it's written to tuning profile
+static std::string profile_cpu_name()
+{
+  std::string name = cpu_model_name();
+  for(char& ch : name)
+    if(ch == ' ' || ch == '\t')
+      ch = '_';
+  return name;
+}
+
+//parse profile line, returns false for comments and malformed lines
+static bool parse_profile_line(const std::string& line, std::string& cpu, std::string& type_name, BlockProfileEntry& entry)
+{
+  if(line.empty() || line[0] == '#')
+    return false;
+  std::istringstream ss(line);
+  return static_cast<bool>(ss >> cpu >> type_name >> entry.sizes.mc >> entry.sizes.kc >> entry.sizes.nc >> entry.kernel)
+    && entry.sizes.mc > 0 && entry.sizes.kc > 0 && entry.sizes.nc > 0;
+}
+
+bool read_block_profile(const std::string& path, const std::string& type_name, BlockProfileEntry& entry)
+{
+  std::ifstream f(path);
+  if(!f)
+    return false;
+  const std::string this_cpu = profile_cpu_name();
+  bool found = false;
+  std::string line;
+  while(std::getline(f, line))
+  {
+    std::string cpu, line_type;
+    BlockProfileEntry line_entry;
+    if(!parse_profile_line(line, cpu, line_type, line_entry) || line_type != type_name)
+      continue;
+    //exact cpu match wins over wildcard
+    if(cpu == this_cpu)
+    {
+      entry = line_entry;
+      return true;
+    }
+    if(cpu == "*" && !found)
+    {
+      entry = line_entry;
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool write_block_profile(const std::string& path, const std::string& type_name, const BlockProfileEntry& entry)
+{
+  const std::string this_cpu = profile_cpu_name();
+  std::ostringstream new_line;
+  new_line << this_cpu << ' ' << type_name << ' ' << entry.sizes.mc << ' ' << entry.sizes.kc << ' ' << entry.sizes.nc << ' ' << entry.kernel;
+  //keep entries for other cpus and types
+  std::vector<std::string> lines;
+  bool replaced = false;
+  {
+    std::ifstream f(path);
+    std::string line;
+    while(f && std::getline(f, line))
+    {
+      std::string cpu, line_type;
+      BlockProfileEntry line_entry;
+      if(parse_profile_line(line, cpu, line_type, line_entry) && cpu == this_cpu && line_type == type_name)
+      {
+        if(!replaced)
+          lines.push_back(new_line.str());
+        replaced = true;
+      } else {
+        lines.push_back(line);
+      }
+    }
+  }
+  if(lines.empty())
+    lines.push_back("# block matrix multiplication tuning profile: <cpu model> <type> <mc> <kc> <nc> <kernel>");
+  if(!replaced)
+    lines.push_back(new_line.str());
+  std::ofstream f(path, std::ios::trunc);
+  for(const std::string& line : lines)
+    f << line << '\n';
+  return static_cast<bool>(f);
+}
+
+}
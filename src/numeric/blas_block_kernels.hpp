@@ -0,0 +1,166 @@
+#pragma once
+#ifndef _BLAS_BLOCK_KERNELS_HPP
+#define _BLAS_BLOCK_KERNELS_HPP
+#include "config.h"
+
+#include "numeric/cache.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//micro kernel for block matrix multiplication, c[mr x nr] += a_p[mr x kc] * b_p[kc x nr]
+//a_p is packed column by column(mr values per column), b_p is packed row by row(nr values per row)
+//b_p is aligned to default alignment, c is unaligned
+template<typename T, size_t mr, size_t nr>
+  __FORCEINLINE inline void __mm_block_kernel(const size_t kc,
+                                              const T * const  __RESTRICT a_p,
+                                              const T * const  __RESTRICT b_p,
+                                                    T * const  __RESTRICT c, const size_t stride_c)
+{
+  T c_acc[mr*nr];
+  for(size_t n = 0; n < mr*nr; n++)
+    c_acc[n] = T(0);
+  for(size_t p = 0; p < kc; p++)
+  {
+    for(size_t i = 0; i < mr; i++)
+    {
+      const T a_ip = a_p[p*mr+i];
+      for(size_t j = 0; j < nr; j++)
+        c_acc[i*nr+j] += a_ip * b_p[p*nr+j];
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t j = 0; j < nr; j++)
+      c[i*stride_c+j] += c_acc[i*nr+j];
+}
+
+//generic micro kernel with plain function signature
+template<typename T, size_t mr, size_t nr>
+  void __mm_block_kernel_generic(const size_t kc,
+                                 const T * const  __RESTRICT a_p,
+                                 const T * const  __RESTRICT b_p,
+                                       T * const  __RESTRICT c, const size_t stride_c)
+{
+  __mm_block_kernel<T,mr,nr>(kc, a_p, b_p, c, stride_c);
+}
+
+//micro kernel descriptor
+template<typename T> struct BlockKernel
+{
+  typedef void (*func_type)(const size_t kc, const T * const __RESTRICT a_p, const T * const __RESTRICT b_p,
+                            T * const __RESTRICT c, const size_t stride_c);
+  const char* name;
+  size_t mr;
+  size_t nr;
+  func_type func;
+};
+
+//upper bound for mr*nr of any registered micro kernel
+static constexpr inline size_t max_block_kernel_tile_size()
+{
+  return 12*32;
+}
+
+//generic micro kernel is 4 rows high and two hardware vectors(at least 2 columns) wide
+template<typename T> static constexpr inline size_t generic_block_kernel_nr()
+{
+  return ( 2 * default_max_hw_vector_size() / sizeof(T) > 2 ? 2 * default_max_hw_vector_size() / sizeof(T) : 2 );
+}
+
+//micro kernels supported by the cpu we're running on, fastest first
+template<typename T> const std::vector<BlockKernel<T>>& block_kernels()
+{
+  constexpr size_t nr = generic_block_kernel_nr<T>();
+  static_assert(4 * nr <= max_block_kernel_tile_size(), "generic micro kernel tile is too large");
+  static const std::vector<BlockKernel<T>> kernels = { { "generic", 4, nr, &__mm_block_kernel_generic<T,4,nr> } };
+  return kernels;
+}
+
+//simd kernels for float and double are selected by cpu features detected at runtime
+template<> const std::vector<BlockKernel<float>>& block_kernels<float>();
+template<> const std::vector<BlockKernel<double>>& block_kernels<double>();
+
+//find supported micro kernel by name, nullptr if there's none
+template<typename T> const BlockKernel<T>* find_block_kernel(const std::string& name)
+{
+  for(const BlockKernel<T>& kernel : block_kernels<T>())
+    if(name == kernel.name)
+      return &kernel;
+  return nullptr;
+}
+
+//block sizes for block matrix multiplication
+struct BlockSizes
+{
+  size_t mc;
+  size_t kc;
+  size_t nc;
+};
+
+//block sizes derived from cache sizes of the cpu we're running on:
+//kc x nr sliver of B should fit in half of L1, mc x kc block of A in half of L2, kc x nc panel of B in half of L3
+BlockSizes default_block_sizes(const size_t type_size, const size_t mr, const size_t nr);
+
+//tuning profile: text file with lines "<cpu model> <type> <mc> <kc> <nc> <kernel>", spaces in cpu model replaced by '_'
+//profile location is taken from CALC_BLOCK_PROFILE environment variable, $HOME/.calc_block_profile by default
+struct BlockProfileEntry
+{
+  std::string kernel;
+  BlockSizes sizes;
+};
+
+std::string block_profile_path();
+bool read_block_profile(const std::string& path, const std::string& type_name, BlockProfileEntry& entry);
+bool write_block_profile(const std::string& path, const std::string& type_name, const BlockProfileEntry& entry);
+
+//type names used in tuning profile, only types with simd kernels are tuned
+template<typename T> inline const char* block_profile_type_name() { return nullptr; }
+template<> inline const char* block_profile_type_name<float>() { return "float"; }
+template<> inline const char* block_profile_type_name<double>() { return "double"; }
+
+//micro kernel and block sizes used by block matrix multiplication
+template<typename T> struct BlockConfig
+{
+  const BlockKernel<T>* kernel;
+  BlockSizes sizes;
+};
+
+template<typename T> BlockConfig<T> make_block_config()
+{
+  const BlockKernel<T>& kernel = block_kernels<T>().front();
+  BlockConfig<T> config = { &kernel, default_block_sizes(sizeof(T), kernel.mr, kernel.nr) };
+  BlockProfileEntry entry;
+  const char* type_name = block_profile_type_name<T>();
+  if(type_name != nullptr && read_block_profile(block_profile_path(), type_name, entry))
+  {
+    const BlockKernel<T>* profile_kernel = find_block_kernel<T>(entry.kernel);
+    if(profile_kernel != nullptr)
+    {
+      config.kernel = profile_kernel;
+      config.sizes = entry.sizes;
+    }
+  }
+  return config;
+}
+
+//current configuration, loaded from tuning profile on first use. could be changed by tuner
+template<typename T> BlockConfig<T>& block_config()
+{
+  static BlockConfig<T> config = make_block_config<T>();
+  return config;
+}
+
+//micro kernel used by block matrix multiplication
+template<typename T> const BlockKernel<T>& block_kernel()
+{
+  return *block_config<T>().kernel;
+}
+
+}
+
+#endif /* _BLAS_BLOCK_KERNELS_HPP */
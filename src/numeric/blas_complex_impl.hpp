@@ -0,0 +1,182 @@
+#pragma once
+#ifndef _BLAS_COMPLEX_IMPL_HPP
+#define _BLAS_COMPLEX_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/complex.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_block_impl.hpp"
+#include "numeric/blas_complex_kernels.hpp"
+
+#include <cstddef>
+#include <complex>
+
+using std::size_t;
+
+namespace numeric {
+
+//complex matrix multiplication, C += alpha*op(A)*op(B) for interleaved std::complex<T> matrices
+//large products use 3M method: with A=Ar+i*Ai, B=Br+i*Bi
+//  P1 = Ar*Br, P2 = Ai*Bi, P3 = (Ar+Ai)*(Br+Bi), C = (P1-P2) + i*(P3-P1-P2)
+//so there are only three real products, all of them are done by block dgemm with simd micro kernels
+//NB: imaginary part of 3M product is slightly less accurate than of conventional one(4 real products)
+//small products use interleaved simd kernels(see blas_complex_kernels.hpp), which don't need splitting
+//and temporaries of size of C
+
+//products with less multiplications are done by interleaved simd kernels
+constexpr inline size_t default_complex_3m_cutoff()
+{
+  return 24*24*24;
+}
+
+//split op(X)[m x n] into row major real part, imaginary part and their sum
+template<typename T, bool t, bool c>
+  inline void __complex_split(const std::complex<T> * const __RESTRICT x, const size_t ld,
+    const size_t m, const size_t n,
+    T * const __RESTRICT re, T * const __RESTRICT im, T * const __RESTRICT sum)
+{
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+    {
+      const std::complex<T> v = __mm_block_op<std::complex<T>,t,c>(x,ld,i,j);
+      re[i*n+j] = v.real();
+      im[i*n+j] = v.imag();
+      sum[i*n+j] = v.real() + v.imag();
+    }
+}
+
+//real product of row major matrices, P[m x n] += X[m x k] * Y[k x n]
+template<typename T>
+  inline void __complex_3m_product(const TThreading threading_model, const size_t workers,
+    const T * const __RESTRICT x, const T * const __RESTRICT y, T * const __RESTRICT p,
+    const size_t m, const size_t k, const size_t n)
+{
+  if(workers <= 1)
+    return __block_matmul_serial<T>(x,k,y,n,p,n,m,k,n);
+  return __block_matmul_parallel<T>(threading_model,x,k,y,n,p,n,m,k,n);
+}
+
+//3M product, C[m x n] += alpha*op(A)[m x k]*op(B)[k x n]
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void __complex_3m(const TThreading threading_model, const size_t workers,
+    const size_t m, const size_t n, const size_t k,
+    const std::complex<T> alpha, const std::complex<T> * const __RESTRICT a, const size_t lda,
+    const std::complex<T> * const __RESTRICT b, const size_t ldb,
+    std::complex<T> * const __RESTRICT c, const size_t ldc)
+{
+  //allocate workspace once: split operands and three products
+  unique_aligned_buf_ptr ws_buf;
+  T* const ws = __mm_block_alloc<T>(3*m*k + 3*k*n + 3*m*n, ws_buf);
+  T* const ar = ws;
+  T* const ai = ar + m*k;
+  T* const as = ai + m*k;
+  T* const br = as + m*k;
+  T* const bi = br + k*n;
+  T* const bs = bi + k*n;
+  T* const p1 = bs + k*n;
+  T* const p2 = p1 + m*n;
+  T* const p3 = p2 + m*n;
+  __complex_split<T,tA,cA>(a,lda,m,k,ar,ai,as);
+  __complex_split<T,tB,cB>(b,ldb,k,n,br,bi,bs);
+  for(size_t i = 0; i < 3*m*n; i++)
+    p1[i] = T(0);
+  __complex_3m_product<T>(threading_model,workers,ar,br,p1,m,k,n);
+  __complex_3m_product<T>(threading_model,workers,ai,bi,p2,m,k,n);
+  __complex_3m_product<T>(threading_model,workers,as,bs,p3,m,k,n);
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+    {
+      const T p1_ij = p1[i*n+j];
+      const T p2_ij = p2[i*n+j];
+      c[i*ldc+j] += alpha * std::complex<T>(p1_ij - p2_ij, p3[i*n+j] - p1_ij - p2_ij);
+    }
+}
+
+//interleaved product, C[m x n] += alpha*op(A)[m x k]*op(B)[k x n]
+//complex values are treated as pairs of reals, so tiles of C are updated by real simd operations only:
+//  (ar+i*ai)*(br+i*bi) = ar*(br,bi) + ai*(-bi,br)
+//op(B) is packed once as is and with swapped parts, rows are padded with zeros to multiple of kernel width,
+//every worker packs mr rows of op(A) at a time and runs kernel over them, see blas_complex_kernels.hpp.
+//alpha is applied to finished tiles of product
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void __complex_interleaved(const TThreading threading_model, const size_t workers,
+    const size_t m, const size_t n, const size_t k,
+    const std::complex<T> alpha, const std::complex<T> * const __RESTRICT a, const size_t lda,
+    const std::complex<T> * const __RESTRICT b, const size_t ldb,
+    std::complex<T> * const __RESTRICT c, const size_t ldc)
+{
+  const ComplexKernel<T>& kernel = complex_kernels<T>().front();
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  const size_t n2 = ( 2*n + nr - 1 ) / nr * nr;
+  unique_aligned_buf_ptr b_buf;
+  T* const b_p = __mm_block_alloc<T>(2*k*n2, b_buf);
+  T* const b_s = b_p + k*n2;
+  for(size_t p = 0; p < k; p++)
+  {
+    for(size_t j = 0; j < n; j++)
+    {
+      const std::complex<T> v = __mm_block_op<std::complex<T>,tB,cB>(b,ldb,p,j);
+      b_p[p*n2+2*j] = v.real();
+      b_p[p*n2+2*j+1] = v.imag();
+      b_s[p*n2+2*j] = -v.imag();
+      b_s[p*n2+2*j+1] = v.real();
+    }
+    for(size_t x = 2*n; x < n2; x++)
+      b_p[p*n2+x] = b_s[p*n2+x] = T(0);
+  }
+  //blocks of mr rows of C are split between workers, every worker has its own packed A and tile accumulator
+  const size_t row_blocks = ( m + mr - 1 ) / mr;
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    unique_aligned_buf_ptr w_buf;
+    T* const a_p = __mm_block_alloc<T>(2*mr*k + mr*n2, w_buf);
+    T* const c_tile = a_p + 2*mr*k;
+    for(size_t ib = row_blocks * t / workers; ib < row_blocks * (t + 1) / workers; ib++)
+    {
+      const size_t i0 = ib*mr;
+      const size_t rows = ( m - i0 < mr ? m - i0 : mr );
+      for(size_t p = 0; p < k; p++)
+        for(size_t i = 0; i < mr; i++)
+        {
+          const std::complex<T> v = ( i < rows ? __mm_block_op<std::complex<T>,tA,cA>(a,lda,i0+i,p) : std::complex<T>(0) );
+          a_p[2*(p*mr+i)] = v.real();
+          a_p[2*(p*mr+i)+1] = v.imag();
+        }
+      for(size_t x = 0; x < mr*n2; x++)
+        c_tile[x] = T(0);
+      for(size_t x = 0; x < n2; x += nr)
+        kernel.func(k, a_p, b_p + x, b_s + x, n2, c_tile + x, n2);
+      for(size_t i = 0; i < rows; i++)
+        for(size_t j = 0; j < n; j++)
+          c[(i0+i)*ldc+j] += alpha * std::complex<T>(c_tile[i*n2+2*j], c_tile[i*n2+2*j+1]);
+    }
+  });
+}
+
+//complex product of gemm, C[m x n] += alpha*op(A)[m x k]*op(B)[k x n], 3M or interleaved one depending on size
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void __complex_gemm(const TThreading threading_model,
+    const size_t m, const size_t n, const size_t k,
+    const std::complex<T> alpha, const std::complex<T> * const __RESTRICT a, const size_t lda,
+    const std::complex<T> * const __RESTRICT b, const size_t ldb,
+    std::complex<T> * const __RESTRICT c, const size_t ldc)
+{
+  const size_t threads = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  const size_t max_workers = ( threads == 0 ? 1 : threads );
+  if(m*n*k < default_complex_3m_cutoff())
+  {
+    //don't bother with threads for less than 16 rows per worker
+    const size_t units = m / 16;
+    const size_t workers = ( max_workers < units ? max_workers : ( units == 0 ? 1 : units ) );
+    return __complex_interleaved<T,tA,tB,cA,cB>(threading_model,workers,m,n,k,alpha,a,lda,b,ldb,c,ldc);
+  }
+  const size_t workers = ( max_workers < m ? max_workers : m );
+  return __complex_3m<T,tA,tB,cA,cB>(threading_model,workers,m,n,k,alpha,a,lda,b,ldb,c,ldc);
+}
+
+}
+
+#endif /* _BLAS_COMPLEX_IMPL_HPP */
@@ -0,0 +1,258 @@
+#include "numeric/blas_complex_kernels.hpp"
+#include "numeric/cpu_features.hpp"
+
+//simd kernels are compiled for their own instruction sets regardless of compiler flags
+//and are registered only if cpu supports them, so the same binary runs on any x86 cpu
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define NUMERIC_COMPLEX_KERNELS_X86
+# define NUMERIC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace numeric {
+
+#ifdef NUMERIC_COMPLEX_KERNELS_X86
+
+//every kernel keeps mr x nr tile of C in registers: mr rows of nv vectors each,
+//rows of b_p and b_s are loaded once per iteration, real and imaginary parts of packed A are broadcasted
+
+NUMERIC_TARGET("sse2")
+static void complex_kernel_sse2_d4x4(const size_t k, const double * const __RESTRICT a_p,
+                                     const double * const __RESTRICT b_p, const double * const __RESTRICT b_s, const size_t ldb,
+                                     double * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 4, nv = 2, w = 2;
+  __m128d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm_setzero_pd();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m128d bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm_loadu_pd(&b_p[p*ldb+v*w]);
+      bs[v] = _mm_loadu_pd(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m128d ar = _mm_set1_pd(a_p[2*(p*mr+i)]);
+      const __m128d ai = _mm_set1_pd(a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm_add_pd(acc[i][v], _mm_add_pd(_mm_mul_pd(ar, bp[v]), _mm_mul_pd(ai, bs[v])));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm_storeu_pd(&c[i*ldc+v*w], _mm_add_pd(_mm_loadu_pd(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("sse2")
+static void complex_kernel_sse2_s4x8(const size_t k, const float * const __RESTRICT a_p,
+                                     const float * const __RESTRICT b_p, const float * const __RESTRICT b_s, const size_t ldb,
+                                     float * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 4, nv = 2, w = 4;
+  __m128 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm_setzero_ps();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m128 bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm_loadu_ps(&b_p[p*ldb+v*w]);
+      bs[v] = _mm_loadu_ps(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m128 ar = _mm_set1_ps(a_p[2*(p*mr+i)]);
+      const __m128 ai = _mm_set1_ps(a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm_add_ps(acc[i][v], _mm_add_ps(_mm_mul_ps(ar, bp[v]), _mm_mul_ps(ai, bs[v])));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm_storeu_ps(&c[i*ldc+v*w], _mm_add_ps(_mm_loadu_ps(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void complex_kernel_avx2_fma_d4x8(const size_t k, const double * const __RESTRICT a_p,
+                                         const double * const __RESTRICT b_p, const double * const __RESTRICT b_s, const size_t ldb,
+                                         double * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 4, nv = 2, w = 4;
+  __m256d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_pd();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m256d bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm256_loadu_pd(&b_p[p*ldb+v*w]);
+      bs[v] = _mm256_loadu_pd(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256d ar = _mm256_broadcast_sd(&a_p[2*(p*mr+i)]);
+      const __m256d ai = _mm256_broadcast_sd(&a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_fmadd_pd(ai, bs[v], _mm256_fmadd_pd(ar, bp[v], acc[i][v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_pd(&c[i*ldc+v*w], _mm256_add_pd(_mm256_loadu_pd(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void complex_kernel_avx2_fma_s4x16(const size_t k, const float * const __RESTRICT a_p,
+                                          const float * const __RESTRICT b_p, const float * const __RESTRICT b_s, const size_t ldb,
+                                          float * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 4, nv = 2, w = 8;
+  __m256 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm256_setzero_ps();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m256 bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm256_loadu_ps(&b_p[p*ldb+v*w]);
+      bs[v] = _mm256_loadu_ps(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m256 ar = _mm256_broadcast_ss(&a_p[2*(p*mr+i)]);
+      const __m256 ai = _mm256_broadcast_ss(&a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm256_fmadd_ps(ai, bs[v], _mm256_fmadd_ps(ar, bp[v], acc[i][v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm256_storeu_ps(&c[i*ldc+v*w], _mm256_add_ps(_mm256_loadu_ps(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx512f")
+static void complex_kernel_avx512_d8x16(const size_t k, const double * const __RESTRICT a_p,
+                                        const double * const __RESTRICT b_p, const double * const __RESTRICT b_s, const size_t ldb,
+                                        double * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 8, nv = 2, w = 8;
+  __m512d acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm512_setzero_pd();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m512d bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm512_loadu_pd(&b_p[p*ldb+v*w]);
+      bs[v] = _mm512_loadu_pd(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m512d ar = _mm512_set1_pd(a_p[2*(p*mr+i)]);
+      const __m512d ai = _mm512_set1_pd(a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm512_fmadd_pd(ai, bs[v], _mm512_fmadd_pd(ar, bp[v], acc[i][v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm512_storeu_pd(&c[i*ldc+v*w], _mm512_add_pd(_mm512_loadu_pd(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+NUMERIC_TARGET("avx512f")
+static void complex_kernel_avx512_s8x32(const size_t k, const float * const __RESTRICT a_p,
+                                        const float * const __RESTRICT b_p, const float * const __RESTRICT b_s, const size_t ldb,
+                                        float * const __RESTRICT c, const size_t ldc)
+{
+  constexpr size_t mr = 8, nv = 2, w = 16;
+  __m512 acc[mr][nv];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      acc[i][v] = _mm512_setzero_ps();
+  for(size_t p = 0; p < k; p++)
+  {
+    __m512 bp[nv], bs[nv];
+    for(size_t v = 0; v < nv; v++)
+    {
+      bp[v] = _mm512_loadu_ps(&b_p[p*ldb+v*w]);
+      bs[v] = _mm512_loadu_ps(&b_s[p*ldb+v*w]);
+    }
+    for(size_t i = 0; i < mr; i++)
+    {
+      const __m512 ar = _mm512_set1_ps(a_p[2*(p*mr+i)]);
+      const __m512 ai = _mm512_set1_ps(a_p[2*(p*mr+i)+1]);
+      for(size_t v = 0; v < nv; v++)
+        acc[i][v] = _mm512_fmadd_ps(ai, bs[v], _mm512_fmadd_ps(ar, bp[v], acc[i][v]));
+    }
+  }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t v = 0; v < nv; v++)
+      _mm512_storeu_ps(&c[i*ldc+v*w], _mm512_add_ps(_mm512_loadu_ps(&c[i*ldc+v*w]), acc[i][v]));
+}
+
+#endif
+
+template<typename T> static void register_generic_complex_kernel(std::vector<ComplexKernel<T>>& kernels)
+{
+  constexpr size_t nr = generic_complex_kernel_nr<T>();
+  static_assert(4 * nr <= max_complex_kernel_tile_size(), "generic complex kernel tile is too large");
+  kernels.push_back({ "generic", 4, nr, &__complex_kernel_generic<T,4,nr> });
+}
+
+static std::vector<ComplexKernel<double>> make_complex_kernels_double()
+{
+  std::vector<ComplexKernel<double>> kernels;
+#ifdef NUMERIC_COMPLEX_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-8x16", 8, 16, &complex_kernel_avx512_d8x16 });
+  if(cpu.avx2 && cpu.fma)
+    kernels.push_back({ "avx2-fma-4x8", 4, 8, &complex_kernel_avx2_fma_d4x8 });
+  if(cpu.sse2)
+    kernels.push_back({ "sse2-4x4", 4, 4, &complex_kernel_sse2_d4x4 });
+#endif
+  register_generic_complex_kernel<double>(kernels);
+  return kernels;
+}
+
+static std::vector<ComplexKernel<float>> make_complex_kernels_float()
+{
+  std::vector<ComplexKernel<float>> kernels;
+#ifdef NUMERIC_COMPLEX_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-8x32", 8, 32, &complex_kernel_avx512_s8x32 });
+  if(cpu.avx2 && cpu.fma)
+    kernels.push_back({ "avx2-fma-4x16", 4, 16, &complex_kernel_avx2_fma_s4x16 });
+  if(cpu.sse2)
+    kernels.push_back({ "sse2-4x8", 4, 8, &complex_kernel_sse2_s4x8 });
+#endif
+  register_generic_complex_kernel<float>(kernels);
+  return kernels;
+}
+
+template<> const std::vector<ComplexKernel<float>>& complex_kernels<float>()
+{
+  static const std::vector<ComplexKernel<float>> kernels = make_complex_kernels_float();
+  return kernels;
+}
+
+template<> const std::vector<ComplexKernel<double>>& complex_kernels<double>()
+{
+  static const std::vector<ComplexKernel<double>> kernels = make_complex_kernels_double();
+  return kernels;
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef _BLAS_COMPLEX_KERNELS_HPP
+#define _BLAS_COMPLEX_KERNELS_HPP
+#include "config.h"
+
+#include "numeric/cache.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//kernel of interleaved complex product, complex values are (re,im) pairs of reals:
+//  c[i*ldc+x] += sum a_p[2*(p*mr+i)] * b_p[p*ldb+x] + a_p[2*(p*mr+i)+1] * b_s[p*ldb+x], i < mr, x < nr, p < k
+//a_p is mr x k block of op(A) packed column by column, b_p is k x nr part of op(B) with interleaved parts,
+//b_s is the same part with (re,im) pairs replaced by (-im,re), so that (ar+i*ai)*(br+i*bi) = ar*(br,bi) + ai*(-bi,br)
+template<typename T, size_t mr, size_t nr>
+  void __complex_kernel_generic(const size_t k, const T * const __RESTRICT a_p,
+                                const T * const __RESTRICT b_p, const T * const __RESTRICT b_s, const size_t ldb,
+                                T * const __RESTRICT c, const size_t ldc)
+{
+  T acc[mr][nr];
+  for(size_t i = 0; i < mr; i++)
+    for(size_t x = 0; x < nr; x++)
+      acc[i][x] = T(0);
+  for(size_t p = 0; p < k; p++)
+    for(size_t i = 0; i < mr; i++)
+    {
+      const T ar = a_p[2*(p*mr+i)];
+      const T ai = a_p[2*(p*mr+i)+1];
+      for(size_t x = 0; x < nr; x++)
+        acc[i][x] += ar * b_p[p*ldb+x] + ai * b_s[p*ldb+x];
+    }
+  for(size_t i = 0; i < mr; i++)
+    for(size_t x = 0; x < nr; x++)
+      c[i*ldc+x] += acc[i][x];
+}
+
+//kernel descriptor: kernel updates mr x nr tile of reals(mr x nr/2 complex values)
+template<typename T> struct ComplexKernel
+{
+  typedef void (*func_type)(const size_t k, const T * const __RESTRICT a_p,
+                            const T * const __RESTRICT b_p, const T * const __RESTRICT b_s, const size_t ldb,
+                            T * const __RESTRICT c, const size_t ldc);
+  const char* name;
+  size_t mr;
+  size_t nr;
+  func_type func;
+};
+
+//upper bound for mr*nr of any registered kernel
+static constexpr inline size_t max_complex_kernel_tile_size()
+{
+  return 8*32;
+}
+
+//generic kernel is 4 rows high and two hardware vectors(at least 2 columns) wide
+template<typename T> static constexpr inline size_t generic_complex_kernel_nr()
+{
+  return ( 2 * default_max_hw_vector_size() / sizeof(T) > 2 ? 2 * default_max_hw_vector_size() / sizeof(T) : 2 );
+}
+
+//kernels supported by the cpu we're running on, fastest first
+template<typename T> const std::vector<ComplexKernel<T>>& complex_kernels()
+{
+  constexpr size_t nr = generic_complex_kernel_nr<T>();
+  static_assert(4 * nr <= max_complex_kernel_tile_size(), "generic complex kernel tile is too large");
+  static const std::vector<ComplexKernel<T>> kernels = { { "generic", 4, nr, &__complex_kernel_generic<T,4,nr> } };
+  return kernels;
+}
+
+//simd kernels for float and double are selected by cpu features detected at runtime
+template<> const std::vector<ComplexKernel<float>>& complex_kernels<float>();
+template<> const std::vector<ComplexKernel<double>>& complex_kernels<double>();
+
+}
+
+#endif /* _BLAS_COMPLEX_KERNELS_HPP */
@@ -0,0 +1,427 @@
+#pragma once
+#ifndef _BLAS_GEMM_IMPL_HPP
+#define _BLAS_GEMM_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/complex.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_block_impl.hpp"
+#include "numeric/blas_complex_impl.hpp"
+
+#include <cstddef>
+#include <utility>
+
+using std::size_t;
+
+namespace numeric {
+
+//BLAS-like interfaces working in place on submatrices: every matrix is given by pointer to its first element
+//and leading dimension(distance between starts of consecutive rows for row major storage, columns for column major)
+//column major problems are mapped to row major ones the same way as in dgemm: C'=(op(B))'*(op(A))'
+
+//number of workers for problem with given number of independent units of work
+inline size_t __gemm_workers(const TThreading threading_model, const size_t units)
+{
+  if(threading_model == T_Serial || threading_model == T_Undefined)
+    return 1;
+  const size_t max_workers = ParallelScheduler::getThreadsNumber();
+  if(max_workers == 0)
+    return 1;
+  return ( max_workers < units ? max_workers : ( units == 0 ? 1 : units ) );
+}
+
+//C = beta*C, C is never read if beta is zero
+template<typename T>
+  inline void __gemm_scale(const size_t m, const size_t n, const T beta, T* const __RESTRICT c, const size_t ldc)
+{
+  if(beta == T(1))
+    return;
+  for(size_t i = 0; i < m; i++)
+  {
+    if(beta == T(0))
+      for(size_t j = 0; j < n; j++)
+        c[i*ldc+j] = T(0);
+    else
+      for(size_t j = 0; j < n; j++)
+        c[i*ldc+j] *= beta;
+  }
+}
+
+//product of real matrices is done by block dgemm
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void __gemm_product(std::false_type, const size_t m, const size_t n, const size_t k,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const TThreading threading_model)
+{
+  if(__gemm_workers(threading_model, m) <= 1)
+    return __block_matmul_serial<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,m,k,n,alpha);
+  return __block_matmul_parallel<T,tA,tB,cA,cB>(threading_model,a,lda,b,ldb,c,ldc,m,k,n,alpha);
+}
+
+//product of complex matrices is done by 3M method or interleaved simd kernels, see blas_complex_impl.hpp
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void __gemm_product(std::true_type, const size_t m, const size_t n, const size_t k,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const TThreading threading_model)
+{
+  return __complex_gemm<typename T::value_type,tA,tB,cA,cB>(threading_model,m,n,k,alpha,a,lda,b,ldb,c,ldc);
+}
+
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void gemm_helper(const size_t m, const size_t n, const size_t k,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    const T beta, T* const __RESTRICT c, const size_t ldc,
+    const TThreading threading_model)
+{
+  if(m == 0 || n == 0)
+    return;
+  __gemm_scale<T>(m,n,beta,c,ldc);
+  if(k == 0 || alpha == T(0))
+    return;
+  return __gemm_product<T,tA,tB,cA,cB>(is_complex<T>(),m,n,k,alpha,a,lda,b,ldb,c,ldc,threading_model);
+}
+
+//conjugation is only meaningful for complex types, so it doesn't produce extra instances for real ones
+template<typename T, bool tA, bool tB>
+  inline void gemm_conj_helper(const bool cA, const bool cB,
+    const size_t m, const size_t n, const size_t k,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    const T beta, T* const __RESTRICT c, const size_t ldc,
+    const TThreading threading_model)
+{
+  constexpr bool cmplx = is_complex<T>::value;
+  if(cA && cB)
+    return gemm_helper<T,tA,tB,cmplx,cmplx>(m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+  else if(cA && !cB)
+    return gemm_helper<T,tA,tB,cmplx,false>(m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+  else if(!cA && cB)
+    return gemm_helper<T,tA,tB,false,cmplx>(m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+  else //if((!cA) && (!cB))
+    return gemm_helper<T,tA,tB,false,false>(m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+}
+
+//BLAS-like gemm, C = alpha*op(A)*op(B) + beta*C
+template<typename T>
+  void gemm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const size_t m, const size_t n, const size_t k,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      const T* const __RESTRICT b, const size_t ldb,
+      const T beta, T* const __RESTRICT c, const size_t ldc,
+      const TThreading threading_model)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate) ;
+  const bool cB = (transB == TMatrixTranspose::Conjugate) ;
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        if(tA && tB)
+          return gemm_conj_helper<T,true,true>(cA,cB,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+        else if(tA && !tB)
+          return gemm_conj_helper<T,true,false>(cA,cB,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+        else if(!tA && tB)
+          return gemm_conj_helper<T,false,true>(cA,cB,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+        else //if((!tA) && (!tB))
+          return gemm_conj_helper<T,false,false>(cA,cB,m,n,k,alpha,a,lda,b,ldb,beta,c,ldc,threading_model);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB, m<->n
+        if(tA && tB)
+          return gemm_conj_helper<T,true,true>(cB,cA,n,m,k,alpha,b,ldb,a,lda,beta,c,ldc,threading_model);
+        else if(tA && !tB)
+          return gemm_conj_helper<T,false,true>(cB,cA,n,m,k,alpha,b,ldb,a,lda,beta,c,ldc,threading_model);
+        else if(!tA && tB)
+          return gemm_conj_helper<T,true,false>(cB,cA,n,m,k,alpha,b,ldb,a,lda,beta,c,ldc,threading_model);
+        else //if((!tA) && (!tB))
+          return gemm_conj_helper<T,false,false>(cB,cA,n,m,k,alpha,b,ldb,a,lda,beta,c,ldc,threading_model);
+      }
+    case TMatrixStorage::Tiled:
+      //not supported, submatrices with leading dimensions make no sense for tiled storage
+      __storage_unsupported("gemm");
+  }
+}
+
+//y[0:m) = alpha*op(A)[0:m)*x + beta*y[0:m), op(A) is m x n, rows of op(A) are rows of A
+template<typename T, bool cA>
+  inline void __gemv_rows(const size_t m, const size_t n,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT x, const size_t incx,
+    const T beta, T* const __RESTRICT y, const size_t incy)
+{
+  for(size_t i = 0; i < m; i++)
+  {
+    T sum = T(0);
+    for(size_t j = 0; j < n; j++)
+      sum += __mm_block_op<T,false,cA>(a,lda,i,j) * x[j*incx];
+    y[i*incy] = ( beta == T(0) ? alpha * sum : alpha * sum + beta * y[i*incy] );
+  }
+}
+
+//y[0:m) = alpha*op(A)[0:m)*x + beta*y[0:m), op(A) is m x n, rows of op(A) are columns of A
+//A is traversed by rows, so y is updated by sequence of axpy
+template<typename T, bool cA>
+  inline void __gemv_columns(const size_t m, const size_t n,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT x, const size_t incx,
+    const T beta, T* const __RESTRICT y, const size_t incy)
+{
+  for(size_t i = 0; i < m; i++)
+    y[i*incy] = ( beta == T(0) ? T(0) : beta * y[i*incy] );
+  for(size_t j = 0; j < n; j++)
+  {
+    const T alpha_x = alpha * x[j*incx];
+    for(size_t i = 0; i < m; i++)
+      y[i*incy] += alpha_x * __mm_block_op<T,true,cA>(a,lda,i,j);
+  }
+}
+
+//rows of y are split between workers
+template<typename T, bool tA, bool cA>
+  inline void gemv_helper(const size_t m, const size_t n,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT x, const size_t incx,
+    const T beta, T* const __RESTRICT y, const size_t incy,
+    const TThreading threading_model)
+{
+  //don't bother with threads for less than 64 rows per worker
+  const size_t workers = __gemm_workers(threading_model, m / 64);
+  if(m == 0)
+    return;
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    const size_t i_begin = m * t / workers;
+    const size_t i_end = m * (t + 1) / workers;
+    if(tA)
+      __gemv_columns<T,cA>(i_end-i_begin,n,alpha,&a[i_begin],lda,x,incx,beta,&y[i_begin*incy],incy);
+    else
+      __gemv_rows<T,cA>(i_end-i_begin,n,alpha,&a[i_begin*lda],lda,x,incx,beta,&y[i_begin*incy],incy);
+  });
+}
+
+//BLAS-like gemv, y = alpha*op(A)*x + beta*y
+template<typename T>
+  void gemv(const TMatrixStorage stor, const TMatrixTranspose transA,
+      const size_t m, const size_t n,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      const T* const __RESTRICT x, const size_t incx,
+      const T beta, T* const __RESTRICT y, const size_t incy,
+      const TThreading threading_model)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  if(stor == TMatrixStorage::Tiled)
+    //not supported, submatrices with leading dimensions make no sense for tiled storage
+    __storage_unsupported("gemv");
+  //row major A is m x n, column major A is row major A' of size n x m
+  const bool rows = ( stor == TMatrixStorage::RowMajor ? !tA : tA );
+  const size_t nrows_op_a = ( tA ? n : m );
+  const size_t ncolumns_op_a = ( tA ? m : n );
+  if(rows) {
+    if(cA)
+      return gemv_helper<T,false,true>(nrows_op_a,ncolumns_op_a,alpha,a,lda,x,incx,beta,y,incy,threading_model);
+    else
+      return gemv_helper<T,false,false>(nrows_op_a,ncolumns_op_a,alpha,a,lda,x,incx,beta,y,incy,threading_model);
+  } else {
+    if(cA)
+      return gemv_helper<T,true,true>(nrows_op_a,ncolumns_op_a,alpha,a,lda,x,incx,beta,y,incy,threading_model);
+    else
+      return gemv_helper<T,true,false>(nrows_op_a,ncolumns_op_a,alpha,a,lda,x,incx,beta,y,incy,threading_model);
+  }
+}
+
+
+//rows(left side) or columns(right side) of X found by unblocked kernel before trailing gemm update
+constexpr inline size_t __trsm_block_size() { return 64; }
+
+//unblocked op(A)*X = B for m x n block, op(A) is lower(forward substitution) or upper(backward substitution) triangular
+template<typename T, bool tA, bool cA, bool lower, bool unit>
+  inline void __trsm_left_block(const size_t m, const size_t n,
+    const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb)
+{
+  for(size_t r = 0; r < m; r++)
+  {
+    const size_t i = ( lower ? r : m - 1 - r );
+    T* const __RESTRICT b_i = &b[i*ldb];
+    const size_t p_begin = ( lower ? 0 : i + 1 );
+    const size_t p_end = ( lower ? i : m );
+    for(size_t p = p_begin; p < p_end; p++)
+    {
+      const T a_ip = __mm_block_op<T,tA,cA>(a,lda,i,p);
+      const T* const __RESTRICT b_p = &b[p*ldb];
+      for(size_t j = 0; j < n; j++)
+        b_i[j] -= a_ip * b_p[j];
+    }
+    if(!unit)
+    {
+      const T inv = T(1) / __mm_block_op<T,tA,cA>(a,lda,i,i);
+      for(size_t j = 0; j < n; j++)
+        b_i[j] *= inv;
+    }
+  }
+}
+
+//unblocked X*op(A) = B for m x n block, op(A) is upper(forward substitution) or lower(backward substitution) triangular
+template<typename T, bool tA, bool cA, bool lower, bool unit>
+  inline void __trsm_right_block(const size_t m, const size_t n,
+    const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb)
+{
+  for(size_t i = 0; i < m; i++)
+  {
+    T* const __RESTRICT b_i = &b[i*ldb];
+    for(size_t c = 0; c < n; c++)
+    {
+      const size_t j = ( lower ? n - 1 - c : c );
+      const size_t p_begin = ( lower ? j + 1 : 0 );
+      const size_t p_end = ( lower ? n : j );
+      T sum = b_i[j];
+      for(size_t p = p_begin; p < p_end; p++)
+        sum -= b_i[p] * __mm_block_op<T,tA,cA>(a,lda,p,j);
+      b_i[j] = ( unit ? sum : sum / __mm_block_op<T,tA,cA>(a,lda,j,j) );
+    }
+  }
+}
+
+//blocked op(A)*X = B, diagonal blocks are solved by unblocked kernel, rows of B not solved yet are updated by gemm
+template<typename T, bool tA, bool cA, bool lower, bool unit>
+  inline void __trsm_left(const size_t m, const size_t n,
+    const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb)
+{
+  const size_t nb = __trsm_block_size();
+  for(size_t r = 0; r < m; r += nb)
+  {
+    const size_t kb = ( m - r < nb ? m - r : nb );
+    const size_t i0 = ( lower ? r : m - r - kb );
+    __trsm_left_block<T,tA,cA,lower,unit>(kb,n,&a[__mm_block_offset<tA>(lda,i0,i0)],lda,&b[i0*ldb],ldb);
+    const size_t rest_begin = ( lower ? i0 + kb : 0 );
+    const size_t rest = ( lower ? m - i0 - kb : i0 );
+    if(rest > 0)
+      gemm_helper<T,tA,false,cA,false>(rest,n,kb,T(-1),&a[__mm_block_offset<tA>(lda,rest_begin,i0)],lda,
+          &b[i0*ldb],ldb,T(1),&b[rest_begin*ldb],ldb,T_Serial);
+  }
+}
+
+//blocked X*op(A) = B, diagonal blocks are solved by unblocked kernel, columns of B not solved yet are updated by gemm
+template<typename T, bool tA, bool cA, bool lower, bool unit>
+  inline void __trsm_right(const size_t m, const size_t n,
+    const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb)
+{
+  const size_t nb = __trsm_block_size();
+  for(size_t c = 0; c < n; c += nb)
+  {
+    const size_t kb = ( n - c < nb ? n - c : nb );
+    const size_t j0 = ( lower ? n - c - kb : c );
+    __trsm_right_block<T,tA,cA,lower,unit>(m,kb,&a[__mm_block_offset<tA>(lda,j0,j0)],lda,&b[j0],ldb);
+    const size_t rest_begin = ( lower ? 0 : j0 + kb );
+    const size_t rest = ( lower ? j0 : n - j0 - kb );
+    if(rest > 0)
+      gemm_helper<T,false,tA,false,cA>(m,rest,kb,T(-1),&b[j0],ldb,
+          &a[__mm_block_offset<tA>(lda,j0,rest_begin)],lda,T(1),&b[rest_begin],ldb,T_Serial);
+  }
+}
+
+//columns(left side) or rows(right side) of B are independent, so they are split between workers
+template<typename T, bool tA, bool cA, bool lower, bool unit>
+  inline void trsm_helper(const bool left, const size_t m, const size_t n,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb,
+    const TThreading threading_model)
+{
+  if(m == 0 || n == 0)
+    return;
+  __gemm_scale<T>(m,n,alpha,b,ldb);
+  if(alpha == T(0))
+    return;
+  //don't bother with threads for less than ~64K multiplications per worker
+  const size_t sz_a = ( left ? m : n );
+  const size_t strips = ( left ? n : m );
+  const size_t units = sz_a * sz_a / 2 * strips / 65536;
+  const size_t workers = __gemm_workers(threading_model, ( units < strips ? units : strips ));
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    const size_t s_begin = strips * t / workers;
+    const size_t s_end = strips * (t + 1) / workers;
+    if(left)
+      __trsm_left<T,tA,cA,lower,unit>(m,s_end-s_begin,a,lda,&b[s_begin],ldb);
+    else
+      __trsm_right<T,tA,cA,lower,unit>(s_end-s_begin,n,a,lda,&b[s_begin*ldb],ldb);
+  });
+}
+
+template<typename T, bool tA, bool cA>
+  inline void trsm_triangle_helper(const bool left, const bool lower, const bool unit,
+    const size_t m, const size_t n,
+    const T alpha, const T* const __RESTRICT a, const size_t lda,
+    T* const __RESTRICT b, const size_t ldb,
+    const TThreading threading_model)
+{
+  if(lower && unit)
+    return trsm_helper<T,tA,cA,true,true>(left,m,n,alpha,a,lda,b,ldb,threading_model);
+  else if(lower && !unit)
+    return trsm_helper<T,tA,cA,true,false>(left,m,n,alpha,a,lda,b,ldb,threading_model);
+  else if(!lower && unit)
+    return trsm_helper<T,tA,cA,false,true>(left,m,n,alpha,a,lda,b,ldb,threading_model);
+  else //if((!lower) && (!unit))
+    return trsm_helper<T,tA,cA,false,false>(left,m,n,alpha,a,lda,b,ldb,threading_model);
+}
+
+//BLAS-like trsm, op(A)*X = alpha*B or X*op(A) = alpha*B
+template<typename T>
+  void trsm(const TMatrixStorage stor, const TMatrixSide side, const TMatrixTriangle uplo,
+      const TMatrixTranspose transA, const TMatrixDiagonal diag,
+      const size_t m, const size_t n,
+      const T alpha, const T* const __RESTRICT a, const size_t lda,
+      T* const __RESTRICT b, const size_t ldb,
+      const TThreading threading_model)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  const bool unit = (diag == TMatrixDiagonal::Unit) ;
+  bool left = (side == TMatrixSide::Left) ;
+  bool lower = (uplo == TMatrixTriangle::Lower) ;
+  size_t nrows_b = m;
+  size_t ncolumns_b = n;
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      break;
+    case TMatrixStorage::ColumnMajor:
+      //solve X'*(op(A))' = alpha*B' instead of op(A)*X = alpha*B and vice versa
+      //column major B is row major B', column major A is row major A', so op stays the same,
+      //while side and triangle are flipped and m<->n
+      left = !left;
+      lower = !lower;
+      std::swap(nrows_b, ncolumns_b);
+      break;
+    case TMatrixStorage::Tiled:
+      //not supported, submatrices with leading dimensions make no sense for tiled storage
+      __storage_unsupported("trsm");
+  }
+  //op(A) is lower triangular if A is lower and not transposed or A is upper and transposed
+  const bool lower_op_a = ( lower != tA );
+  if(tA && cA)
+    return trsm_triangle_helper<T,true,true>(left,lower_op_a,unit,nrows_b,ncolumns_b,alpha,a,lda,b,ldb,threading_model);
+  else if(tA && !cA)
+    return trsm_triangle_helper<T,true,false>(left,lower_op_a,unit,nrows_b,ncolumns_b,alpha,a,lda,b,ldb,threading_model);
+  else //if(!tA)
+    return trsm_triangle_helper<T,false,false>(left,lower_op_a,unit,nrows_b,ncolumns_b,alpha,a,lda,b,ldb,threading_model);
+}
+
+}
+
+#endif /* _BLAS_GEMM_IMPL_HPP */
@@ -367,6 +367,36 @@ template<typename T, TMM_Algo tAlgo, bool tA, bool tB, bool cA, bool cB>
   }
 }
 
+//real products are done by loop implementations below
+template<typename T>
+  inline bool __dgemm_complex(std::false_type, const TMatrixStorage, const TMatrixTranspose, const TMatrixTranspose,
+    const T* const __RESTRICT, const T* const __RESTRICT, T* const __RESTRICT,
+    const size_t, const size_t, const size_t, const size_t, const TThreading)
+{
+  return false;
+}
+
+//complex products are done by gemm, see blas_complex_impl.hpp
+template<typename T>
+  inline bool __dgemm_complex(std::true_type, const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_a, const size_t ncolumns_a,
+    const size_t nrows_b, const size_t ncolumns_b,
+    const TThreading threading_model)
+{
+  if(stor == TMatrixStorage::Tiled)
+    return false;
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const size_t m = ( tA ? ncolumns_a : nrows_a );
+  const size_t k = ( tA ? nrows_a : ncolumns_a );
+  const size_t n = ( tB ? nrows_b : ncolumns_b );
+  const bool row_major = ( stor == TMatrixStorage::RowMajor );
+  gemm<T>(stor,transA,transB,m,n,k,T(1),a,( row_major ? ncolumns_a : nrows_a ),b,( row_major ? ncolumns_b : nrows_b ),
+      T(1),c,( row_major ? n : m ),threading_model);
+  return true;
+}
+
 //generic version of dgemm, C=op(A)*op(B)
 template<typename T>
   void dgemm(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
@@ -379,6 +409,8 @@ template<typename T>
   const bool tB = (transB != TMatrixTranspose::No) ;
   const bool cA = (transA == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
   const bool cB = (transB == TMatrixTranspose::Conjugate && is_complex<T>::value) ;
+  if(__dgemm_complex<T>(is_complex<T>(),stor,transA,transB,a,b,c,nrows_a,ncolumns_a,nrows_b,ncolumns_b,threading_model))
+    return;
   switch(stor)
   {
     case TMatrixStorage::RowMajor:
@@ -447,6 +479,11 @@ template<typename T>
             return dgemm_helper<T,TMM_Algo::KIJ,true,true,false,false>(b,a,c,nrows_b,ncolumns_b,ncolumns_a,threading_model);
         }
       }
+    case TMatrixStorage::Tiled:
+      {
+        //tiled matrices are multiplied tile by tile by recursive implementation
+        return dgemm_recursive<T>(stor,transA,transB,a,b,c,nrows_a,ncolumns_a,nrows_b,ncolumns_b,threading_model);
+      }
   }
 }
 
@@ -563,6 +600,9 @@ template<typename T>
         else
           return dgemv_helper<T,false,false>(a, x, y, nrows_a, ncolumns_a, alpha, beta, threading_model);
       }
+    case TMatrixStorage::Tiled:
+      //not supported
+      __storage_unsupported("dgemv");
   }
 }
 
@@ -0,0 +1,328 @@
+#pragma once
+#ifndef _BLAS_RECURSIVE_IMPL_HPP
+#define _BLAS_RECURSIVE_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_block_impl.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//cache oblivious matrix multiplication: the largest of m, k and n is split in half until subproblem is small enough,
+//so every level of memory hierarchy ends up working on blocks fitting in it without knowing its size
+//subproblems are multiplied by block dgemm micro kernels, which don't need any tuning for such small sizes
+
+//tiled storage: matrix is split into square tiles of size tiled_tile_size(), every tile is stored in row major order,
+//tiles are stored one after another in the order of recursive bisection of the grid of tiles along its larger dimension,
+//it's Morton(Z) order for square grids of power of two size. tiles on right and bottom edges are zero padded
+
+//number of tiles covering n rows or columns
+inline size_t tiled_tiles_num(const size_t n)
+{
+  return ( n + tiled_tile_size() - 1 ) / tiled_tile_size();
+}
+
+//number of elements of matrix in tiled storage, padding included
+inline size_t tiled_stored_size(const size_t nrows, const size_t ncolumns)
+{
+  return tiled_tiles_num(nrows) * tiled_tiles_num(ncolumns) * tiled_tile_size() * tiled_tile_size();
+}
+
+//offset of tile (ti,tj) in grid of ntr x ntc tiles, in tiles
+inline size_t tiled_tile_offset(const size_t ntr, const size_t ntc, const size_t ti, const size_t tj)
+{
+  size_t offset = 0;
+  size_t r0 = 0, nr = ntr, c0 = 0, nc = ntc;
+  while(nr > 1 || nc > 1)
+  {
+    if(nr >= nc)
+    {
+      const size_t h = nr / 2;
+      if(ti < r0 + h) {
+        nr = h;
+      } else {
+        offset += h * nc;
+        r0 += h;
+        nr -= h;
+      }
+    } else {
+      const size_t h = nc / 2;
+      if(tj < c0 + h) {
+        nc = h;
+      } else {
+        offset += nr * h;
+        c0 += h;
+        nc -= h;
+      }
+    }
+  }
+  return offset;
+}
+
+//index of element (i,j) of nrows x ncolumns matrix in tiled storage
+inline size_t tiled_index(const size_t nrows, const size_t ncolumns, const size_t i, const size_t j)
+{
+  const size_t ts = tiled_tile_size();
+  return tiled_tile_offset(tiled_tiles_num(nrows), tiled_tiles_num(ncolumns), i / ts, j / ts) * ts * ts + (i % ts) * ts + j % ts;
+}
+
+//subproblems with all dimensions not greater than this are multiplied directly
+constexpr inline size_t __recursive_leaf_size()
+{
+  return 128;
+}
+
+//split point of dimension, multiple of 8 for large ones to keep subproblems friendly to micro kernels
+constexpr inline size_t __recursive_half(const size_t n)
+{
+  return ( n > 16 ? ( n / 2 + 7 ) / 8 * 8 : n / 2 );
+}
+
+//C[m x n] += op(A)[m x k] * op(B)[k x n] for row major submatrices with leading dimensions
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  void __recursive_matmul(const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t m, const size_t k, const size_t n)
+{
+  const size_t leaf = __recursive_leaf_size();
+  if(m <= leaf && k <= leaf && n <= leaf)
+    return __block_matmul_serial<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,m,k,n);
+  if(m >= k && m >= n)
+  {
+    const size_t h = __recursive_half(m);
+    __recursive_matmul<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,h,k,n);
+    __recursive_matmul<T,tA,tB,cA,cB>(&a[__mm_block_offset<tA>(lda,h,0)],lda,b,ldb,&c[h*ldc],ldc,m-h,k,n);
+  } else if(n >= k) {
+    const size_t h = __recursive_half(n);
+    __recursive_matmul<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,m,k,h);
+    __recursive_matmul<T,tA,tB,cA,cB>(a,lda,&b[__mm_block_offset<tB>(ldb,0,h)],ldb,&c[h],ldc,m,k,n-h);
+  } else {
+    const size_t h = __recursive_half(k);
+    __recursive_matmul<T,tA,tB,cA,cB>(a,lda,b,ldb,c,ldc,m,h,n);
+    __recursive_matmul<T,tA,tB,cA,cB>(&a[__mm_block_offset<tA>(lda,0,h)],lda,&b[__mm_block_offset<tB>(ldb,h,0)],ldb,c,ldc,m,k-h,n);
+  }
+}
+
+//grid of tiles of matrix in tiled storage, op(X) tile (i,j) is X tile (j,i) if X is transposed
+template<typename T> struct __tiled_grid
+{
+  T* data;
+  size_t ntr;
+  size_t ntc;
+  T* tile(const bool t, const size_t i, const size_t j) const
+  {
+    const size_t ts = tiled_tile_size();
+    return data + ( t ? tiled_tile_offset(ntr,ntc,j,i) : tiled_tile_offset(ntr,ntc,i,j) ) * ts * ts;
+  }
+};
+
+//C += op(A) * op(B) for ranges of tiles: [ti, ti+mt) rows of C, [tp, tp+kt) columns of op(A), [tj, tj+nt) columns of C
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  void __recursive_matmul_tiled(const __tiled_grid<const T>& a, const __tiled_grid<const T>& b, const __tiled_grid<T>& c,
+    const size_t ti, const size_t tp, const size_t tj,
+    const size_t mt, const size_t kt, const size_t nt)
+{
+  const size_t ts = tiled_tile_size();
+  if(mt == 1 && kt == 1 && nt == 1)
+    return __block_matmul_serial<T,tA,tB,cA,cB>(a.tile(tA,ti,tp),ts,b.tile(tB,tp,tj),ts,c.tile(false,ti,tj),ts,ts,ts,ts);
+  if(mt >= kt && mt >= nt)
+  {
+    const size_t h = mt / 2;
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti,tp,tj,h,kt,nt);
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti+h,tp,tj,mt-h,kt,nt);
+  } else if(nt >= kt) {
+    const size_t h = nt / 2;
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti,tp,tj,mt,kt,h);
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti,tp,tj+h,mt,kt,nt-h);
+  } else {
+    const size_t h = kt / 2;
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti,tp,tj,mt,h,nt);
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a,b,c,ti,tp+h,tj,mt,kt-h,nt);
+  }
+}
+
+//independent subproblem of parallel version: block of rows [i, i+m) and columns [j, j+n) of C
+struct __recursive_task
+{
+  size_t i;
+  size_t m;
+  size_t j;
+  size_t n;
+};
+
+//split C into at least workers blocks by the same bisection as in serial version,
+//blocks are never split below min_size rows or columns
+inline std::vector<__recursive_task> __recursive_tasks(const size_t m, const size_t n, const size_t workers, const size_t min_size)
+{
+  std::vector<__recursive_task> tasks(1, __recursive_task{0,m,0,n});
+  while(tasks.size() < workers)
+  {
+    //split the largest block
+    size_t largest = 0;
+    for(size_t t = 1; t < tasks.size(); t++)
+      if(tasks[t].m * tasks[t].n > tasks[largest].m * tasks[largest].n)
+        largest = t;
+    const __recursive_task task = tasks[largest];
+    if(task.m >= task.n && task.m >= 2 * min_size)
+    {
+      const size_t h = task.m / 2;
+      tasks[largest].m = h;
+      tasks.push_back(__recursive_task{task.i+h,task.m-h,task.j,task.n});
+    } else if(task.n >= 2 * min_size) {
+      const size_t h = task.n / 2;
+      tasks[largest].n = h;
+      tasks.push_back(__recursive_task{task.i,task.m,task.j+h,task.n-h});
+    } else {
+      break;
+    }
+  }
+  return tasks;
+}
+
+//number of workers for parallel version
+inline size_t __recursive_workers(const TThreading threading_model)
+{
+  if(threading_model == T_Serial || threading_model == T_Undefined)
+    return 1;
+  const size_t threads = ParallelScheduler::getThreadsNumber();
+  return ( threads == 0 ? 1 : threads );
+}
+
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void recursive_matmul_helper(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const TThreading threading_model)
+{
+  const size_t lda = ( tA ? nrows_op_a : ncolumns_op_a );
+  const size_t ldb = ( tB ? ncolumns_op_a : ncolumns_op_b );
+  const size_t ldc = ncolumns_op_b;
+  const std::vector<__recursive_task> tasks = __recursive_tasks(nrows_op_a, ncolumns_op_b,
+      __recursive_workers(threading_model), __recursive_leaf_size());
+  run_workers(( tasks.size() > 1 ? threading_model : T_Serial ), tasks.size(), [&](const size_t t)
+  {
+    const __recursive_task& task = tasks[t];
+    __recursive_matmul<T,tA,tB,cA,cB>(&a[__mm_block_offset<tA>(lda,task.i,0)],lda,&b[__mm_block_offset<tB>(ldb,0,task.j)],ldb,
+        &c[task.i*ldc+task.j],ldc,task.m,ncolumns_op_a,task.n);
+  });
+}
+
+template<typename T, bool tA, bool tB, bool cA, bool cB>
+  inline void recursive_matmul_tiled_helper(const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const TThreading threading_model)
+{
+  const size_t mt = tiled_tiles_num(nrows_op_a);
+  const size_t kt = tiled_tiles_num(ncolumns_op_a);
+  const size_t nt = tiled_tiles_num(ncolumns_op_b);
+  const __tiled_grid<const T> a_grid{a, ( tA ? kt : mt ), ( tA ? mt : kt )};
+  const __tiled_grid<const T> b_grid{b, ( tB ? nt : kt ), ( tB ? kt : nt )};
+  const __tiled_grid<T> c_grid{c, mt, nt};
+  const std::vector<__recursive_task> tasks = __recursive_tasks(mt, nt, __recursive_workers(threading_model), 1);
+  run_workers(( tasks.size() > 1 ? threading_model : T_Serial ), tasks.size(), [&](const size_t t)
+  {
+    const __recursive_task& task = tasks[t];
+    __recursive_matmul_tiled<T,tA,tB,cA,cB>(a_grid,b_grid,c_grid,task.i,0,task.j,task.m,kt,task.n);
+  });
+}
+
+//runtime transposition flags to template parameters
+template<typename T, bool tiled>
+  inline void recursive_matmul_dispatch(const bool tA, const bool tB, const bool cA, const bool cB,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const TThreading threading_model)
+{
+  if(nrows_op_a == 0 || ncolumns_op_a == 0 || ncolumns_op_b == 0)
+    return;
+#define _RECURSIVE_HELPER(tA,tB,cA,cB) ( tiled ?\
+    recursive_matmul_tiled_helper<T,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,threading_model) :\
+    recursive_matmul_helper<T,tA,tB,cA,cB>(a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,threading_model) )
+  constexpr bool cmplx = is_complex<T>::value;
+  if(tA && tB)
+  {
+    if(cA && cB)
+      return _RECURSIVE_HELPER(true,true,cmplx,cmplx);
+    else if(cA && !cB)
+      return _RECURSIVE_HELPER(true,true,cmplx,false);
+    else if(!cA && cB)
+      return _RECURSIVE_HELPER(true,true,false,cmplx);
+    else //if((!cA) && (!cB))
+      return _RECURSIVE_HELPER(true,true,false,false);
+  }
+  else if(tA && !tB)
+  {
+    if(cA)
+      return _RECURSIVE_HELPER(true,false,cmplx,false);
+    else
+      return _RECURSIVE_HELPER(true,false,false,false);
+  }
+  else if(!tA && tB)
+  {
+    if(cB)
+      return _RECURSIVE_HELPER(false,true,false,cmplx);
+    else
+      return _RECURSIVE_HELPER(false,true,false,false);
+  }
+  else //if((!tA) && (!tB))
+  {
+    return _RECURSIVE_HELPER(false,false,false,false);
+  }
+#undef _RECURSIVE_HELPER
+}
+
+//cache oblivious recursive version of dgemm, C+=op(A)*op(B)
+//column major problems are mapped to row major ones as in dgemm, tiled operands are multiplied tile by tile
+template<typename T>
+  void dgemm_recursive(const TMatrixStorage stor, const TMatrixTranspose transA, const TMatrixTranspose transB,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model)
+{
+  const bool tA = (transA != TMatrixTranspose::No) ;
+  const bool tB = (transB != TMatrixTranspose::No) ;
+  const bool cA = (transA == TMatrixTranspose::Conjugate) ;
+  const bool cB = (transB == TMatrixTranspose::Conjugate) ;
+  const size_t nrows_op_a = ( tA ? ncolumns_a : nrows_a );
+  const size_t ncolumns_op_a = ( tA ? nrows_a : ncolumns_a );
+  const size_t ncolumns_op_b = ( tB ? nrows_b : ncolumns_b );
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        return recursive_matmul_dispatch<T,false>(tA,tB,cA,cB,a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,threading_model);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return recursive_matmul_dispatch<T,false>(tB,tA,cB,cA,b,a,c,ncolumns_op_b,ncolumns_op_a,nrows_op_a,threading_model);
+      }
+    case TMatrixStorage::Tiled:
+      {
+        return recursive_matmul_dispatch<T,true>(tA,tB,cA,cB,a,b,c,nrows_op_a,ncolumns_op_a,ncolumns_op_b,threading_model);
+      }
+  }
+}
+
+//cache oblivious recursive version of reduced dgemm for square matrices, C+=A*B
+template<typename T>
+  void dgemm_recursive(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t sz,
+      const TThreading threading_model)
+{
+  return dgemm_recursive<T>(stor,TMatrixTranspose::No,TMatrixTranspose::No,a,b,c,sz,sz,sz,sz,threading_model);
+}
+
+}
+
+#endif /* _BLAS_RECURSIVE_IMPL_HPP */
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _BLAS_SPARSE_IMPL_HPP
+#define _BLAS_SPARSE_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_sparse_kernels.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace numeric
+{
+
+//first and last+1 rows for every worker, so that workers get nearly equal numbers of nonzeros
+inline std::vector<size_t> __csr_split(const size_t* const __RESTRICT row_ptr, const size_t nrows, const size_t workers)
+{
+  std::vector<size_t> bounds(workers + 1, nrows);
+  bounds[0] = 0;
+  const size_t nnz = row_ptr[nrows] - row_ptr[0];
+  for(size_t t = 1; t < workers; t++)
+    bounds[t] = std::max(bounds[t-1], size_t(std::upper_bound(row_ptr, row_ptr + nrows, row_ptr[0] + nnz*t/workers) - row_ptr) - 1);
+  return bounds;
+}
+
+//number of workers for sparse product, don't bother with threads for less than ~64K multiplications per worker
+inline size_t __csr_workers(const size_t flops, const size_t nrows, const TThreading threading_model)
+{
+  const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+  return std::max(size_t(1), std::min(std::min(max_workers, nrows), flops / 65536));
+}
+
+template<typename T>
+  void dcsrmv(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT row_ptr,
+      const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t nrows_a,
+      const T alpha,
+      const TThreading threading_model)
+{
+  if(nrows_a == 0)
+    return;
+  const size_t workers = __csr_workers(row_ptr[nrows_a] - row_ptr[0], nrows_a, threading_model);
+  const std::vector<size_t> bounds = __csr_split(row_ptr, nrows_a, workers);
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    for(size_t i = bounds[t]; i < bounds[t+1]; i++)
+    {
+      T sum = T(0);
+      for(size_t k = row_ptr[i]; k < row_ptr[i+1]; k++)
+        sum += a[k] * x[column_indices[k]];
+      y[i] += alpha * sum;
+    }
+  });
+}
+
+template<typename T>
+  void dcsrmm(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT row_ptr,
+      const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_b,
+      const T alpha,
+      const TThreading threading_model)
+{
+  if(nrows_a == 0 || ncolumns_b == 0)
+    return;
+  const size_t workers = __csr_workers((row_ptr[nrows_a] - row_ptr[0]) * ncolumns_b, nrows_a, threading_model);
+  const std::vector<size_t> bounds = __csr_split(row_ptr, nrows_a, workers);
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    //every nonzero of row of A scales contiguous row of B, so inner loop is stride-1 over right hand sides
+    for(size_t i = bounds[t]; i < bounds[t+1]; i++)
+    {
+      T* const __RESTRICT c_i = c + i*ncolumns_b;
+      for(size_t k = row_ptr[i]; k < row_ptr[i+1]; k++)
+      {
+        const T a_k = alpha * a[k];
+        const T* const __RESTRICT b_j = b + column_indices[k]*ncolumns_b;
+        for(size_t j = 0; j < ncolumns_b; j++)
+          c_i[j] += a_k * b_j[j];
+      }
+    }
+  });
+}
+
+template<typename T>
+  void dsellmv(const T* const __RESTRICT a, const size_t* const __RESTRICT column_indices, const size_t* const __RESTRICT chunk_ptr,
+      const size_t* const __RESTRICT permutation,
+      const T* const __RESTRICT x, T* const __RESTRICT y,
+      const size_t nrows_a, const size_t chunk_height,
+      const T alpha,
+      const TThreading threading_model)
+{
+  if(nrows_a == 0)
+    return;
+  const size_t nchunks = (nrows_a + chunk_height - 1) / chunk_height;
+  const typename SellKernel<T>::func_type kernel = sell_kernel<T>(chunk_height);
+  //chunk pointers are split the same way as row pointers of CSR
+  const size_t workers = __csr_workers(chunk_ptr[nchunks] - chunk_ptr[0], nchunks, threading_model);
+  const std::vector<size_t> bounds = __csr_split(chunk_ptr, nchunks, workers);
+  run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+  {
+    std::vector<T> acc(chunk_height);
+    for(size_t k = bounds[t]; k < bounds[t+1]; k++)
+    {
+      kernel((chunk_ptr[k+1] - chunk_ptr[k]) / chunk_height, chunk_height,
+        a + chunk_ptr[k], column_indices + chunk_ptr[k], x, acc.data());
+      const size_t r_end = std::min(chunk_height, nrows_a - k*chunk_height);
+      for(size_t r = 0; r < r_end; r++)
+        y[permutation[k*chunk_height + r]] += alpha * acc[r];
+    }
+  });
+}
+
+}
+
+#endif /* _BLAS_SPARSE_IMPL_HPP */
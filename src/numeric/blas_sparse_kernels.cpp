@@ -0,0 +1,150 @@
+#include "numeric/blas_sparse_kernels.hpp"
+#include "numeric/cpu_features.hpp"
+
+//simd kernels are compiled for their own instruction sets regardless of compiler flags
+//and are registered only if cpu supports them, so the same binary runs on any x86 cpu
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define NUMERIC_SPARSE_KERNELS_X86
+# define NUMERIC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace numeric {
+
+#ifdef NUMERIC_SPARSE_KERNELS_X86
+
+//every kernel keeps accumulators of the whole chunk in registers, column of chunk is loaded with stride-1 loads
+//of values and 64-bit column indices, elements of x are gathered
+
+NUMERIC_TARGET("avx2,fma")
+static void sell_kernel_avx2_d4(const size_t width, const size_t,
+                                const double * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                                const double * const __RESTRICT x, double * const __RESTRICT acc)
+{
+  __m256d sum = _mm256_setzero_pd();
+  for(size_t j = 0; j < width; j++)
+  {
+    const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&column_indices_k[j*4]));
+    sum = _mm256_fmadd_pd(_mm256_loadu_pd(&a_k[j*4]), _mm256_i64gather_pd(x, idx, 8), sum);
+  }
+  _mm256_storeu_pd(acc, sum);
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void sell_kernel_avx2_d8(const size_t width, const size_t,
+                                const double * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                                const double * const __RESTRICT x, double * const __RESTRICT acc)
+{
+  __m256d sum[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+  for(size_t j = 0; j < width; j++)
+  {
+    for(size_t v = 0; v < 2; v++)
+    {
+      const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&column_indices_k[j*8+v*4]));
+      sum[v] = _mm256_fmadd_pd(_mm256_loadu_pd(&a_k[j*8+v*4]), _mm256_i64gather_pd(x, idx, 8), sum[v]);
+    }
+  }
+  _mm256_storeu_pd(acc, sum[0]);
+  _mm256_storeu_pd(acc+4, sum[1]);
+}
+
+NUMERIC_TARGET("avx2,fma")
+static void sell_kernel_avx2_s8(const size_t width, const size_t,
+                                const float * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                                const float * const __RESTRICT x, float * const __RESTRICT acc)
+{
+  __m256 sum = _mm256_setzero_ps();
+  for(size_t j = 0; j < width; j++)
+  {
+    const __m256i idx_lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&column_indices_k[j*8]));
+    const __m256i idx_hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&column_indices_k[j*8+4]));
+    const __m256 x_j = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_i64gather_ps(x, idx_lo, 4)),
+                                            _mm256_i64gather_ps(x, idx_hi, 4), 1);
+    sum = _mm256_fmadd_ps(_mm256_loadu_ps(&a_k[j*8]), x_j, sum);
+  }
+  _mm256_storeu_ps(acc, sum);
+}
+
+NUMERIC_TARGET("avx512f")
+static void sell_kernel_avx512_d8(const size_t width, const size_t,
+                                  const double * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                                  const double * const __RESTRICT x, double * const __RESTRICT acc)
+{
+  __m512d sum = _mm512_setzero_pd();
+  for(size_t j = 0; j < width; j++)
+  {
+    const __m512i idx = _mm512_loadu_si512(reinterpret_cast<const void*>(&column_indices_k[j*8]));
+    //masked gather with explicit zero source, see s16 kernel
+    const __m512d x_j = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, idx, x, 8);
+    sum = _mm512_fmadd_pd(_mm512_loadu_pd(&a_k[j*8]), x_j, sum);
+  }
+  _mm512_storeu_pd(acc, sum);
+}
+
+NUMERIC_TARGET("avx512f")
+static void sell_kernel_avx512_s16(const size_t width, const size_t,
+                                   const float * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                                   const float * const __RESTRICT x, float * const __RESTRICT acc)
+{
+  __m512 sum = _mm512_setzero_ps();
+  for(size_t j = 0; j < width; j++)
+  {
+    const __m512i idx_lo = _mm512_loadu_si512(reinterpret_cast<const void*>(&column_indices_k[j*16]));
+    const __m512i idx_hi = _mm512_loadu_si512(reinterpret_cast<const void*>(&column_indices_k[j*16+8]));
+    //gathers are masked with explicit zero source, unmasked ones leave it undefined and trip -Wmaybe-uninitialized
+    const __m256 x_lo = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), 0xFF, idx_lo, x, 4);
+    const __m256 x_hi = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), 0xFF, idx_hi, x, 4);
+    //avx512f has no 256-bit float insert, halves are combined as doubles. zero-masked inserts for the same reason
+    const __m512d x_wide = _mm512_maskz_insertf64x4(0xFF, _mm512_setzero_pd(), _mm256_castps_pd(x_lo), 0);
+    const __m512 x_j = _mm512_castpd_ps(_mm512_maskz_insertf64x4(0xFF, x_wide, _mm256_castps_pd(x_hi), 1));
+    sum = _mm512_fmadd_ps(_mm512_loadu_ps(&a_k[j*16]), x_j, sum);
+  }
+  _mm512_storeu_ps(acc, sum);
+}
+
+#endif
+
+static std::vector<SellKernel<double>> make_sell_kernels_double()
+{
+  std::vector<SellKernel<double>> kernels;
+#ifdef NUMERIC_SPARSE_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-8", 8, &sell_kernel_avx512_d8 });
+  if(cpu.avx2 && cpu.fma)
+  {
+    kernels.push_back({ "avx2-fma-8", 8, &sell_kernel_avx2_d8 });
+    kernels.push_back({ "avx2-fma-4", 4, &sell_kernel_avx2_d4 });
+  }
+#endif
+  kernels.push_back({ "generic", 4, &__sell_kernel_generic<double> });
+  return kernels;
+}
+
+static std::vector<SellKernel<float>> make_sell_kernels_float()
+{
+  std::vector<SellKernel<float>> kernels;
+#ifdef NUMERIC_SPARSE_KERNELS_X86
+  const CpuFeatures& cpu = cpu_features();
+  if(cpu.avx512f)
+    kernels.push_back({ "avx512-16", 16, &sell_kernel_avx512_s16 });
+  if(cpu.avx2 && cpu.fma)
+    kernels.push_back({ "avx2-fma-8", 8, &sell_kernel_avx2_s8 });
+#endif
+  kernels.push_back({ "generic", 8, &__sell_kernel_generic<float> });
+  return kernels;
+}
+
+template<> const std::vector<SellKernel<float>>& sell_kernels<float>()
+{
+  static const std::vector<SellKernel<float>> kernels = make_sell_kernels_float();
+  return kernels;
+}
+
+template<> const std::vector<SellKernel<double>>& sell_kernels<double>()
+{
+  static const std::vector<SellKernel<double>> kernels = make_sell_kernels_double();
+  return kernels;
+}
+
+}
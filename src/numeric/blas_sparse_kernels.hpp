@@ -0,0 +1,69 @@
+#pragma once
+#ifndef _BLAS_SPARSE_KERNELS_HPP
+#define _BLAS_SPARSE_KERNELS_HPP
+#include "config.h"
+
+#include "numeric/cache.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//kernel for one chunk of matrix in SELL-C-sigma format, acc[r] = sum a_k[j*C+r] * x[column_indices_k[j*C+r]], j < width
+//chunk is stored column by column, C values per column, padding has zero values and valid column indices
+template<typename T>
+  void __sell_kernel_generic(const size_t width, const size_t chunk_height,
+                             const T * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                             const T * const __RESTRICT x, T * const __RESTRICT acc)
+{
+  for(size_t r = 0; r < chunk_height; r++)
+    acc[r] = T(0);
+  for(size_t j = 0; j < width; j++)
+    for(size_t r = 0; r < chunk_height; r++)
+      acc[r] += a_k[j*chunk_height+r] * x[column_indices_k[j*chunk_height+r]];
+}
+
+//kernel descriptor, simd kernels support only chunk height they are registered with
+template<typename T> struct SellKernel
+{
+  typedef void (*func_type)(const size_t width, const size_t chunk_height,
+                            const T * const __RESTRICT a_k, const size_t * const __RESTRICT column_indices_k,
+                            const T * const __RESTRICT x, T * const __RESTRICT acc);
+  const char* name;
+  size_t chunk_height;
+  func_type func;
+};
+
+//kernels supported by the cpu we're running on, fastest first, the last one is generic and supports any chunk height
+template<typename T> const std::vector<SellKernel<T>>& sell_kernels()
+{
+  constexpr size_t c = ( default_max_hw_vector_size() / sizeof(T) > 4 ? default_max_hw_vector_size() / sizeof(T) : 4 );
+  static const std::vector<SellKernel<T>> kernels = { { "generic", c, &__sell_kernel_generic<T> } };
+  return kernels;
+}
+
+//gather based simd kernels for float and double are selected by cpu features detected at runtime
+template<> const std::vector<SellKernel<float>>& sell_kernels<float>();
+template<> const std::vector<SellKernel<double>>& sell_kernels<double>();
+
+//chunk height matched to the fastest kernel
+template<typename T> inline size_t sell_chunk_height()
+{
+  return sell_kernels<T>().front().chunk_height;
+}
+
+//fastest kernel for given chunk height
+template<typename T> inline typename SellKernel<T>::func_type sell_kernel(const size_t chunk_height)
+{
+  for(const SellKernel<T>& kernel : sell_kernels<T>())
+    if(kernel.chunk_height == chunk_height)
+      return kernel.func;
+  return &__sell_kernel_generic<T>;
+}
+
+}
+
+#endif /* _BLAS_SPARSE_KERNELS_HPP */
@@ -0,0 +1,348 @@
+#pragma once
+#ifndef _BLAS_STRASSEN_IMPL_HPP
+#define _BLAS_STRASSEN_IMPL_HPP
+#include "config.h"
+
+#include "numeric/blas.hpp"
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/blas_block_impl.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+using std::size_t;
+
+namespace numeric {
+
+//helper for Strassen-Winograd matrix multiplication
+//every level splits even parts of A(m x k), B(k x n) and C(m x n) into 2x2 quadrants and computes
+//7 products of quadrant combinations instead of 8, using the Winograd variant of Strassen's scheme (15 additions):
+//  S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+//  T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+//  M1 = A11*B11, M2 = A12*B21, M3 = S4*B22, M4 = A22*T4, M5 = S1*T1, M6 = S2*T2, M7 = S3*T3
+//  U2 = M1 + M6, U3 = U2 + M7, U4 = U2 + M5
+//  C11 = M1 + M2, C12 = U4 + M3, C21 = U3 - M4, C22 = U3 + M5
+//odd last row/column of A, B and C are peeled off and handled by rank-1 and matrix-vector updates,
+//recursion stops when any dimension is below cutoff, remaining products are computed by block dgemm
+//all temporaries are carved from single workspace preallocated before recursion
+
+//c = a + b
+template<typename T>
+  inline void __strassen_add(const size_t m, const size_t n,
+    const T* const a, const size_t lda, const T* const b, const size_t ldb, T* const c, const size_t ldc)
+{
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+      c[i*ldc+j] = a[i*lda+j] + b[i*ldb+j];
+}
+
+//c = a - b
+template<typename T>
+  inline void __strassen_sub(const size_t m, const size_t n,
+    const T* const a, const size_t lda, const T* const b, const size_t ldb, T* const c, const size_t ldc)
+{
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+      c[i*ldc+j] = a[i*lda+j] - b[i*ldb+j];
+}
+
+//c += a
+template<typename T>
+  inline void __strassen_acc(const size_t m, const size_t n,
+    const T* const a, const size_t lda, T* const c, const size_t ldc)
+{
+  for(size_t i = 0; i < m; i++)
+    for(size_t j = 0; j < n; j++)
+      c[i*ldc+j] += a[i*lda+j];
+}
+
+//default cutoff, below it block dgemm is faster than another level of recursion
+inline size_t default_strassen_cutoff()
+{
+  return 512;
+}
+
+//recursion stops if any dimension is below cutoff or there's nothing to split
+inline bool __strassen_is_leaf(const size_t m, const size_t k, const size_t n, const size_t cutoff)
+{
+  return m <= cutoff || k <= cutoff || n <= cutoff || m < 2 || k < 2 || n < 2;
+}
+
+//size of workspace (in elements) needed by serial recursion for m x k by k x n product
+inline size_t __strassen_workspace_size(const size_t m, const size_t k, const size_t n, const size_t cutoff)
+{
+  if(__strassen_is_leaf(m, k, n, cutoff))
+    return 0;
+  const size_t m2 = m / 2, k2 = k / 2, n2 = n / 2;
+  return m2 * k2 + k2 * n2 + m2 * n2 + __strassen_workspace_size(m2, k2, n2, cutoff);
+}
+
+//fix up C for odd dimensions: even part C[0:m',0:n'] = A[0:m',0:k']*B[0:k',0:n'] is computed already
+template<typename T>
+  inline void __strassen_peel(const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t m, const size_t k, const size_t n)
+{
+  const size_t me = m & ~size_t(1), ke = k & ~size_t(1), ne = n & ~size_t(1);
+  //rank-1 update with last column of A and last row of B
+  if(ke != k)
+  {
+    const T* const b_row = &b[(k-1)*ldb];
+    for(size_t i = 0; i < me; i++)
+    {
+      const T a_ik = a[i*lda+k-1];
+      for(size_t j = 0; j < ne; j++)
+        c[i*ldc+j] += a_ik * b_row[j];
+    }
+  }
+  //last column of C
+  if(ne != n)
+  {
+    for(size_t i = 0; i < m; i++)
+    {
+      T sum = T(0);
+      for(size_t p = 0; p < k; p++)
+        sum += a[i*lda+p] * b[p*ldb+n-1];
+      c[i*ldc+n-1] = sum;
+    }
+  }
+  //last row of C
+  if(me != m)
+  {
+    T* const c_row = &c[(m-1)*ldc];
+    for(size_t j = 0; j < ne; j++)
+      c_row[j] = T(0);
+    for(size_t p = 0; p < k; p++)
+    {
+      const T a_mp = a[(m-1)*lda+p];
+      const T* const b_row = &b[p*ldb];
+      for(size_t j = 0; j < ne; j++)
+        c_row[j] += a_mp * b_row[j];
+    }
+  }
+}
+
+//leaf of recursion, C = A*B
+template<typename T>
+  inline void __strassen_leaf(const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t m, const size_t k, const size_t n)
+{
+  for(size_t i = 0; i < m; i++)
+    std::memset(&c[i*ldc], 0, n * sizeof(T));
+  __block_matmul_serial<T>(a,lda,b,ldb,c,ldc,m,k,n);
+}
+
+//serial recursion, C = A*B, ws should hold at least __strassen_workspace_size(m,k,n,cutoff) elements
+template<typename T>
+  void __strassen_serial(const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t m, const size_t k, const size_t n,
+    const size_t cutoff, T* const __RESTRICT ws)
+{
+  if(__strassen_is_leaf(m, k, n, cutoff))
+    return __strassen_leaf<T>(a,lda,b,ldb,c,ldc,m,k,n);
+  const size_t m2 = m / 2, k2 = k / 2, n2 = n / 2;
+  const T* const a11 = a;
+  const T* const a12 = a + k2;
+  const T* const a21 = a + m2*lda;
+  const T* const a22 = a + m2*lda + k2;
+  const T* const b11 = b;
+  const T* const b12 = b + n2;
+  const T* const b21 = b + k2*ldb;
+  const T* const b22 = b + k2*ldb + n2;
+  T* const c11 = c;
+  T* const c12 = c + n2;
+  T* const c21 = c + m2*ldc;
+  T* const c22 = c + m2*ldc + n2;
+  //temporaries: X(m2 x k2), Y(k2 x n2), Z(m2 x n2), the rest is reused by every child
+  T* const x = ws;
+  T* const y = x + m2*k2;
+  T* const z = y + k2*n2;
+  T* const child_ws = z + m2*n2;
+  //C21 = M7 = S3*T3
+  __strassen_sub<T>(m2,k2,a11,lda,a21,lda,x,k2);
+  __strassen_sub<T>(k2,n2,b22,ldb,b12,ldb,y,n2);
+  __strassen_serial<T>(x,k2,y,n2,c21,ldc,m2,k2,n2,cutoff,child_ws);
+  //C22 = M5 = S1*T1
+  __strassen_add<T>(m2,k2,a21,lda,a22,lda,x,k2);
+  __strassen_sub<T>(k2,n2,b12,ldb,b11,ldb,y,n2);
+  __strassen_serial<T>(x,k2,y,n2,c22,ldc,m2,k2,n2,cutoff,child_ws);
+  //C12 = M6 = S2*T2
+  __strassen_sub<T>(m2,k2,x,k2,a11,lda,x,k2);
+  __strassen_sub<T>(k2,n2,b22,ldb,y,n2,y,n2);
+  __strassen_serial<T>(x,k2,y,n2,c12,ldc,m2,k2,n2,cutoff,child_ws);
+  //C11 = M3 = S4*B22
+  __strassen_sub<T>(m2,k2,a12,lda,x,k2,x,k2);
+  __strassen_serial<T>(x,k2,b22,ldb,c11,ldc,m2,k2,n2,cutoff,child_ws);
+  //Z = M1 = A11*B11
+  __strassen_serial<T>(a11,lda,b11,ldb,z,n2,m2,k2,n2,cutoff,child_ws);
+  //C12 = U2 = M1 + M6, C21 = U3 = U2 + M7, C12 = U4 = U2 + M5, C22 = U3 + M5, C12 = U4 + M3
+  __strassen_acc<T>(m2,n2,z,n2,c12,ldc);
+  __strassen_acc<T>(m2,n2,c12,ldc,c21,ldc);
+  __strassen_acc<T>(m2,n2,c22,ldc,c12,ldc);
+  __strassen_acc<T>(m2,n2,c21,ldc,c22,ldc);
+  __strassen_acc<T>(m2,n2,c11,ldc,c12,ldc);
+  //C11 = M4 = A22*T4, C21 = U3 - M4
+  __strassen_sub<T>(k2,n2,y,n2,b21,ldb,y,n2);
+  __strassen_serial<T>(a22,lda,y,n2,c11,ldc,m2,k2,n2,cutoff,child_ws);
+  __strassen_sub<T>(m2,n2,c21,ldc,c11,ldc,c21,ldc);
+  //C11 = M2 + M1 = A12*B21 + Z
+  __strassen_serial<T>(a12,lda,b21,ldb,c11,ldc,m2,k2,n2,cutoff,child_ws);
+  __strassen_acc<T>(m2,n2,z,n2,c11,ldc);
+  __strassen_peel<T>(a,lda,b,ldb,c,ldc,m,k,n);
+}
+
+//top level of recursion with 7 products computed concurrently, every product recurses serially
+//needs separate S1-S4, T1-T4 and 3 more temporaries for products, plus workspace for every product
+template<typename T>
+  void __strassen_parallel(const TThreading threading_model,
+    const T* const __RESTRICT a, const size_t lda,
+    const T* const __RESTRICT b, const size_t ldb,
+    T* const __RESTRICT c, const size_t ldc,
+    const size_t m, const size_t k, const size_t n,
+    const size_t cutoff)
+{
+  const size_t m2 = m / 2, k2 = k / 2, n2 = n / 2;
+  const T* const a11 = a;
+  const T* const a12 = a + k2;
+  const T* const a21 = a + m2*lda;
+  const T* const a22 = a + m2*lda + k2;
+  const T* const b11 = b;
+  const T* const b12 = b + n2;
+  const T* const b21 = b + k2*ldb;
+  const T* const b22 = b + k2*ldb + n2;
+  T* const c11 = c;
+  T* const c12 = c + n2;
+  T* const c21 = c + m2*ldc;
+  T* const c22 = c + m2*ldc + n2;
+  //allocate workspace once
+  const size_t child_ws_sz = __strassen_workspace_size(m2, k2, n2, cutoff);
+  unique_aligned_buf_ptr ws_buf;
+  T* const ws = __mm_block_alloc<T>(4*m2*k2 + 4*k2*n2 + 3*m2*n2 + 7*child_ws_sz, ws_buf);
+  T* const s1 = ws;
+  T* const s2 = s1 + m2*k2;
+  T* const s3 = s2 + m2*k2;
+  T* const s4 = s3 + m2*k2;
+  T* const t1 = s4 + m2*k2;
+  T* const t2 = t1 + k2*n2;
+  T* const t3 = t2 + k2*n2;
+  T* const t4 = t3 + k2*n2;
+  T* const z1 = t4 + k2*n2;
+  T* const z2 = z1 + m2*n2;
+  T* const z3 = z2 + m2*n2;
+  T* const child_ws = z3 + m2*n2;
+  //operands of products
+  __strassen_add<T>(m2,k2,a21,lda,a22,lda,s1,k2);
+  __strassen_sub<T>(m2,k2,s1,k2,a11,lda,s2,k2);
+  __strassen_sub<T>(m2,k2,a11,lda,a21,lda,s3,k2);
+  __strassen_sub<T>(m2,k2,a12,lda,s2,k2,s4,k2);
+  __strassen_sub<T>(k2,n2,b12,ldb,b11,ldb,t1,n2);
+  __strassen_sub<T>(k2,n2,b22,ldb,t1,n2,t2,n2);
+  __strassen_sub<T>(k2,n2,b22,ldb,b12,ldb,t3,n2);
+  __strassen_sub<T>(k2,n2,t2,n2,b21,ldb,t4,n2);
+  //M1 -> Z1, M2 -> C11, M3 -> C12, M4 -> C21, M5 -> C22, M6 -> Z2, M7 -> Z3
+  struct product { const T* a; size_t lda; const T* b; size_t ldb; T* c; size_t ldc; };
+  const product products[7] = {
+    { a11, lda, b11, ldb, z1, n2 },
+    { a12, lda, b21, ldb, c11, ldc },
+    { s4, k2, b22, ldb, c12, ldc },
+    { a22, lda, t4, n2, c21, ldc },
+    { s1, k2, t1, n2, c22, ldc },
+    { s2, k2, t2, n2, z2, n2 },
+    { s3, k2, t3, n2, z3, n2 },
+  };
+  const size_t max_workers = ParallelScheduler::getThreadsNumber();
+  const size_t workers = ( max_workers == 0 ? 1 : ( max_workers < 7 ? max_workers : 7 ) );
+  run_workers(threading_model, workers, [&](const size_t t)
+  {
+    for(size_t i = t; i < 7; i += workers)
+    {
+      const product& p = products[i];
+      __strassen_serial<T>(p.a,p.lda,p.b,p.ldb,p.c,p.ldc,m2,k2,n2,cutoff,child_ws + i*child_ws_sz);
+    }
+  });
+  //Z2 = U2 = M1 + M6, Z3 = U3 = U2 + M7, C11 = M2 + M1, Z2 = U4 = U2 + M5, C22 = U3 + M5, C12 = U4 + M3, C21 = U3 - M4
+  __strassen_acc<T>(m2,n2,z1,n2,z2,n2);
+  __strassen_acc<T>(m2,n2,z2,n2,z3,n2);
+  __strassen_acc<T>(m2,n2,z1,n2,c11,ldc);
+  __strassen_acc<T>(m2,n2,c22,ldc,z2,n2);
+  __strassen_acc<T>(m2,n2,z3,n2,c22,ldc);
+  __strassen_acc<T>(m2,n2,z2,n2,c12,ldc);
+  __strassen_sub<T>(m2,n2,z3,n2,c21,ldc,c21,ldc);
+  __strassen_peel<T>(a,lda,b,ldb,c,ldc,m,k,n);
+}
+
+template<typename T>
+  inline void dgemm_strassen_helper(const T* const  __RESTRICT a, const T* const  __RESTRICT b, T* const __RESTRICT c,
+    const size_t nrows_op_a, const size_t ncolumns_op_a, const size_t ncolumns_op_b,
+    const TThreading threading_model, const size_t cutoff)
+{
+  const size_t m = nrows_op_a, k = ncolumns_op_a, n = ncolumns_op_b;
+  const size_t min_sz = ( cutoff == 0 ? default_strassen_cutoff() : cutoff );
+  if(m == 0 || n == 0)
+    return;
+  //small problem, block dgemm does better job
+  if(__strassen_is_leaf(m, k, n, min_sz))
+  {
+    for(size_t i = 0; i < m; i++)
+      std::memset(&c[i*n], 0, n * sizeof(T));
+    return dgemm_block_helper<T>(a,b,c,m,k,n,threading_model);
+  }
+  if(threading_model != T_Serial && threading_model != T_Undefined && ParallelScheduler::getThreadsNumber() > 1)
+    return __strassen_parallel<T>(threading_model,a,k,b,n,c,n,m,k,n,min_sz);
+  unique_aligned_buf_ptr ws_buf;
+  T* const ws = __mm_block_alloc<T>(__strassen_workspace_size(m, k, n, min_sz), ws_buf);
+  __strassen_serial<T>(a,k,b,n,c,n,m,k,n,min_sz,ws);
+}
+
+//generic version of Strassen-Winograd dgemm, C=op(A)*op(B)
+template<typename T>
+  void dgemm_strassen(const TMatrixStorage stor,
+      const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+      const size_t nrows_a, const size_t ncolumns_a,
+      const size_t nrows_b, const size_t ncolumns_b,
+      const TThreading threading_model,
+      const size_t cutoff)
+{
+  switch(stor)
+  {
+    case TMatrixStorage::RowMajor:
+      {
+        return dgemm_strassen_helper<T>(a,b,c,nrows_a,ncolumns_a,ncolumns_b,threading_model,cutoff);
+      }
+    case TMatrixStorage::ColumnMajor:
+      {
+        //calculate C'=(op(B))'*(op(A))' instead of C=op(A)*op(B)
+        //column major C is row major C', so corresponing mappings are: A<->B, tA<->tB, cA<->cB
+        return dgemm_strassen_helper<T>(b,a,c,ncolumns_b,nrows_b,nrows_a,threading_model,cutoff);
+      }
+    case TMatrixStorage::Tiled:
+      {
+        //tiled matrices are multiplied tile by tile by recursive implementation, which accumulates into C
+        const size_t sz = tiled_stored_size(nrows_a,ncolumns_b);
+        for(size_t i = 0; i < sz; i++)
+          c[i] = T(0);
+        return dgemm_recursive<T>(stor,TMatrixTranspose::No,TMatrixTranspose::No,a,b,c,nrows_a,ncolumns_a,nrows_b,ncolumns_b,threading_model);
+      }
+  }
+}
+
+//generic version of Strassen-Winograd dgemm for square matrices
+template<typename T>
+  void dgemm_strassen(const TMatrixStorage stor,
+    const T* const __RESTRICT a, const T* const __RESTRICT b, T* const __RESTRICT c,
+    const size_t sz,
+    const TThreading threading_model,
+    const size_t cutoff)
+{
+    return dgemm_strassen<T>(stor,a,b,c,sz,sz,sz,sz,threading_model,cutoff);
+}
+
+}
+
+#endif /* _BLAS_STRASSEN_IMPL_HPP */
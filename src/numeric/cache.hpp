@@ -158,6 +158,31 @@ namespace numeric {
       return default_cache_line_size();
   }
 
+  //size of data(or unified) cache of given level in bytes, 0 if it can't be detected
+  inline std::size_t cache_size(const unsigned level) noexcept
+  {
+    long sysconf_cache_size = -1;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    switch(level)
+    {
+      case 1:
+        sysconf_cache_size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        break;
+      case 2:
+        sysconf_cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        break;
+      case 3:
+        sysconf_cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        break;
+      default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return ( sysconf_cache_size > 0 ? std::size_t(sysconf_cache_size) : 0 );
+  }
+
   inline std::size_t gcd_size(size_t a, size_t b) noexcept
   {
     size_t c;
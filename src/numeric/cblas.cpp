@@ -0,0 +1,239 @@
+#include "numeric/cblas.h"
+#include "numeric/blas.hpp"
+#include "numeric/parallel.hpp"
+
+#include <new>
+#include <memory>
+
+//cblas routines use threading backend of global ParallelScheduler, if there's any
+//invalid arguments are silently ignored, as we can't throw through C interface
+
+namespace {
+
+using numeric::TMatrixStorage;
+using numeric::TMatrixTranspose;
+using numeric::TMatrixSide;
+using numeric::TMatrixTriangle;
+using numeric::TMatrixDiagonal;
+
+inline bool cblas_order(const enum CBLAS_ORDER order, TMatrixStorage& stor)
+{
+  switch(order)
+  {
+    case CblasRowMajor:
+      stor = TMatrixStorage::RowMajor;
+      return true;
+    case CblasColMajor:
+      stor = TMatrixStorage::ColumnMajor;
+      return true;
+  }
+  return false;
+}
+
+inline bool cblas_transpose(const enum CBLAS_TRANSPOSE trans, TMatrixTranspose& op)
+{
+  switch(trans)
+  {
+    case CblasNoTrans:
+      op = TMatrixTranspose::No;
+      return true;
+    case CblasTrans:
+      op = TMatrixTranspose::Transpose;
+      return true;
+    case CblasConjTrans:
+      op = TMatrixTranspose::Conjugate;
+      return true;
+  }
+  return false;
+}
+
+inline bool cblas_trsm_flags(const enum CBLAS_SIDE side, const enum CBLAS_UPLO uplo, const enum CBLAS_DIAG diag,
+    TMatrixSide& s, TMatrixTriangle& t, TMatrixDiagonal& d)
+{
+  if(side != CblasLeft && side != CblasRight)
+    return false;
+  if(uplo != CblasUpper && uplo != CblasLower)
+    return false;
+  if(diag != CblasNonUnit && diag != CblasUnit)
+    return false;
+  s = ( side == CblasLeft ? TMatrixSide::Left : TMatrixSide::Right );
+  t = ( uplo == CblasUpper ? TMatrixTriangle::Upper : TMatrixTriangle::Lower );
+  d = ( diag == CblasUnit ? TMatrixDiagonal::Unit : TMatrixDiagonal::NonUnit );
+  return true;
+}
+
+//check dimensions the way reference blas does, leading dimension is at least number of stored columns(rows for column major)
+template<typename T>
+  void cblas_gemm(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRANSPOSE TransB,
+                  const int M, const int N, const int K,
+                  const T alpha, const T *A, const int lda,
+                  const T *B, const int ldb,
+                  const T beta, T *C, const int ldc)
+{
+  TMatrixStorage stor;
+  TMatrixTranspose transA, transB;
+  if(!cblas_order(Order, stor) || !cblas_transpose(TransA, transA) || !cblas_transpose(TransB, transB))
+    return;
+  if(M < 0 || N < 0 || K < 0)
+    return;
+  const bool row_major = ( stor == TMatrixStorage::RowMajor );
+  const bool tA = ( transA != TMatrixTranspose::No );
+  const bool tB = ( transB != TMatrixTranspose::No );
+  //stored A is M x K or K x M, stored B is K x N or N x K
+  const int min_lda = ( row_major != tA ? K : M );
+  const int min_ldb = ( row_major != tB ? N : K );
+  const int min_ldc = ( row_major ? N : M );
+  if(lda < 1 || lda < min_lda || ldb < 1 || ldb < min_ldb || ldc < 1 || ldc < min_ldc)
+    return;
+  numeric::gemm<T>(stor, transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+      numeric::ParallelScheduler::getThreadingBackend());
+}
+
+template<typename T>
+  void cblas_gemv(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA,
+                  const int M, const int N,
+                  const T alpha, const T *A, const int lda,
+                  const T *X, const int incX,
+                  const T beta, T *Y, const int incY)
+{
+  TMatrixStorage stor;
+  TMatrixTranspose transA;
+  if(!cblas_order(Order, stor) || !cblas_transpose(TransA, transA))
+    return;
+  if(M < 0 || N < 0 || incX == 0 || incY == 0)
+    return;
+  const int min_lda = ( stor == TMatrixStorage::RowMajor ? N : M );
+  if(lda < 1 || lda < min_lda)
+    return;
+  if(incX > 0 && incY > 0)
+  {
+    numeric::gemv<T>(stor, transA, M, N, alpha, A, lda, X, incX, beta, Y, incY,
+        numeric::ParallelScheduler::getThreadingBackend());
+    return;
+  }
+  //negative increment means vector is stored backwards starting at x + (1 - len)*inc, as in reference blas.
+  //such vectors are packed into contiguous buffers, it costs O(M+N) next to O(M*N) of gemv itself
+  const int lenX = ( transA == TMatrixTranspose::No ? N : M );
+  const int lenY = ( transA == TMatrixTranspose::No ? M : N );
+  if(lenX == 0 || lenY == 0)
+    return;
+  std::unique_ptr<T[]> x_buf, y_buf;
+  const T* x = X;
+  T* y = Y;
+  int inc_x = incX, inc_y = incY;
+  if(incX < 0)
+  {
+    x_buf.reset(new (std::nothrow) T[lenX]);
+    if(!x_buf)
+      return;
+    const T* const xs = X + std::ptrdiff_t(1 - lenX)*incX;
+    for (int i = 0; i < lenX; ++i)
+      x_buf[i] = xs[std::ptrdiff_t(i)*incX];
+    x = x_buf.get();
+    inc_x = 1;
+  }
+  if(incY < 0)
+  {
+    y_buf.reset(new (std::nothrow) T[lenY]);
+    if(!y_buf)
+      return;
+    const T* const ys = Y + std::ptrdiff_t(1 - lenY)*incY;
+    for (int i = 0; i < lenY; ++i)
+      y_buf[i] = ys[std::ptrdiff_t(i)*incY];
+    y = y_buf.get();
+    inc_y = 1;
+  }
+  numeric::gemv<T>(stor, transA, M, N, alpha, A, lda, x, inc_x, beta, y, inc_y,
+      numeric::ParallelScheduler::getThreadingBackend());
+  if(incY < 0)
+  {
+    T* const ys = Y + std::ptrdiff_t(1 - lenY)*incY;
+    for (int i = 0; i < lenY; ++i)
+      ys[std::ptrdiff_t(i)*incY] = y_buf[i];
+  }
+}
+
+template<typename T>
+  void cblas_trsm(const enum CBLAS_ORDER Order, const enum CBLAS_SIDE Side, const enum CBLAS_UPLO Uplo,
+                  const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_DIAG Diag,
+                  const int M, const int N,
+                  const T alpha, const T *A, const int lda,
+                  T *B, const int ldb)
+{
+  TMatrixStorage stor;
+  TMatrixTranspose transA;
+  TMatrixSide side;
+  TMatrixTriangle uplo;
+  TMatrixDiagonal diag;
+  if(!cblas_order(Order, stor) || !cblas_transpose(TransA, transA) || !cblas_trsm_flags(Side, Uplo, Diag, side, uplo, diag))
+    return;
+  if(M < 0 || N < 0)
+    return;
+  //A is M x M or N x N, B is M x N
+  const int min_lda = ( side == TMatrixSide::Left ? M : N );
+  const int min_ldb = ( stor == TMatrixStorage::RowMajor ? N : M );
+  if(lda < 1 || lda < min_lda || ldb < 1 || ldb < min_ldb)
+    return;
+  numeric::trsm<T>(stor, side, uplo, transA, diag, M, N, alpha, A, lda, B, ldb,
+      numeric::ParallelScheduler::getThreadingBackend());
+}
+
+}
+
+extern "C" {
+
+void cblas_sgemm(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRANSPOSE TransB,
+                 const int M, const int N, const int K,
+                 const float alpha, const float *A, const int lda,
+                 const float *B, const int ldb,
+                 const float beta, float *C, const int ldc)
+{
+  cblas_gemm<float>(Order, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void cblas_dgemm(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRANSPOSE TransB,
+                 const int M, const int N, const int K,
+                 const double alpha, const double *A, const int lda,
+                 const double *B, const int ldb,
+                 const double beta, double *C, const int ldc)
+{
+  cblas_gemm<double>(Order, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void cblas_sgemv(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA,
+                 const int M, const int N,
+                 const float alpha, const float *A, const int lda,
+                 const float *X, const int incX,
+                 const float beta, float *Y, const int incY)
+{
+  cblas_gemv<float>(Order, TransA, M, N, alpha, A, lda, X, incX, beta, Y, incY);
+}
+
+void cblas_dgemv(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE TransA,
+                 const int M, const int N,
+                 const double alpha, const double *A, const int lda,
+                 const double *X, const int incX,
+                 const double beta, double *Y, const int incY)
+{
+  cblas_gemv<double>(Order, TransA, M, N, alpha, A, lda, X, incX, beta, Y, incY);
+}
+
+void cblas_strsm(const enum CBLAS_ORDER Order, const enum CBLAS_SIDE Side, const enum CBLAS_UPLO Uplo,
+                 const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_DIAG Diag,
+                 const int M, const int N,
+                 const float alpha, const float *A, const int lda,
+                 float *B, const int ldb)
+{
+  cblas_trsm<float>(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, B, ldb);
+}
+
+void cblas_dtrsm(const enum CBLAS_ORDER Order, const enum CBLAS_SIDE Side, const enum CBLAS_UPLO Uplo,
+                 const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_DIAG Diag,
+                 const int M, const int N,
+                 const double alpha, const double *A, const int lda,
+                 double *B, const int ldb)
+{
+  cblas_trsm<double>(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, B, ldb);
+}
+
+}
@@ -11,10 +11,13 @@ template<typename T> struct is_complex<std::complex<T>> : std::true_type {};
 namespace numeric
 {
 
-template<typename T> inline T conj(const T& c)
+template<typename T> inline T conj(const T& c, std::false_type)
 { return c; }
-template<typename T> inline std::complex<T> conj(const std::complex<T>& c)
-{ return std::conj<T>(c); }
+template<typename T> inline T conj(const T& c, std::true_type)
+{ return std::conj(c); }
+//dispatched by type, so that conj<T> with explicit complex T isn't a no-op
+template<typename T> inline T conj(const T& c)
+{ return conj<T>(c, is_complex<T>()); }
 
 }
 
@@ -0,0 +1,112 @@
+#include "numeric/cpu_features.hpp"
+
+//headers for cpuid
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define NUMERIC_CPUID_X86
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <cpuid.h>
+# define NUMERIC_CPUID_X86
+#endif
+
+namespace numeric {
+
+#ifdef NUMERIC_CPUID_X86
+static void cpuid(const unsigned leaf, const unsigned subleaf, unsigned regs[4])
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, leaf, subleaf);
+  for(int i = 0; i < 4; i++)
+    regs[i] = unsigned(info[i]);
+#else
+  regs[0] = regs[1] = regs[2] = regs[3] = 0;
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//extended control register 0, tells which register states are saved by os on context switch
+static unsigned long long xgetbv0()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned eax, edx;
+  __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ( (unsigned long long)edx << 32 ) | eax;
+#endif
+}
+#endif
+
+static CpuFeatures detect_cpu_features()
+{
+  CpuFeatures f = { false, false, false, false, false };
+#ifdef NUMERIC_CPUID_X86
+  unsigned regs[4];
+  cpuid(0, 0, regs);
+  const unsigned max_leaf = regs[0];
+  if(max_leaf < 1)
+    return f;
+  cpuid(1, 0, regs);
+  f.sse2 = ( regs[3] & (1u << 26) ) != 0;
+  const bool osxsave = ( regs[2] & (1u << 27) ) != 0;
+  const bool cpu_avx = ( regs[2] & (1u << 28) ) != 0;
+  const bool cpu_fma = ( regs[2] & (1u << 12) ) != 0;
+  if(!osxsave || !cpu_avx)
+    return f;
+  const unsigned long long xcr0 = xgetbv0();
+  //xmm and ymm states
+  if(( xcr0 & 0x6 ) != 0x6)
+    return f;
+  f.avx = true;
+  f.fma = cpu_fma;
+  if(max_leaf < 7)
+    return f;
+  cpuid(7, 0, regs);
+  f.avx2 = ( regs[1] & (1u << 5) ) != 0;
+  //opmask and zmm states
+  f.avx512f = ( regs[1] & (1u << 16) ) != 0 && ( xcr0 & 0xe6 ) == 0xe6;
+#endif
+  return f;
+}
+
+static std::string detect_cpu_model_name()
+{
+  std::string name;
+#ifdef NUMERIC_CPUID_X86
+  unsigned regs[4];
+  cpuid(0x80000000u, 0, regs);
+  if(regs[0] >= 0x80000004u)
+  {
+    char brand[49] = { 0 };
+    for(unsigned leaf = 0; leaf < 3; leaf++)
+    {
+      cpuid(0x80000002u + leaf, 0, regs);
+      for(unsigned r = 0; r < 4; r++)
+        for(unsigned b = 0; b < 4; b++)
+          brand[leaf*16+r*4+b] = char( ( regs[r] >> (8*b) ) & 0xff );
+    }
+    name = brand;
+    const size_t first = name.find_first_not_of(' ');
+    const size_t last = name.find_last_not_of(' ');
+    name = ( first == std::string::npos ? std::string() : name.substr(first, last - first + 1) );
+  }
+#endif
+  if(name.empty())
+    name = "unknown";
+  return name;
+}
+
+const CpuFeatures& cpu_features()
+{
+  static const CpuFeatures features = detect_cpu_features();
+  return features;
+}
+
+const std::string& cpu_model_name()
+{
+  static const std::string name = detect_cpu_model_name();
+  return name;
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#ifndef _CPU_FEATURES_HPP
+#define _CPU_FEATURES_HPP
+#include "config.h"
+
+#include <string>
+
+namespace numeric {
+
+//instruction set extensions supported by both cpu and os, detected once at runtime via cpuid
+struct CpuFeatures
+{
+  bool sse2;
+  bool avx;
+  bool fma;
+  bool avx2;
+  bool avx512f;
+};
+
+const CpuFeatures& cpu_features();
+
+//cpu brand string, "unknown" if it can't be detected
+const std::string& cpu_model_name();
+
+}
+
+#endif /* _CPU_FEATURES_HPP */
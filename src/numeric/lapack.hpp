@@ -3,31 +3,235 @@
 #define _LAPACK_HPP
 #include "config.h"
 
+#include "numeric/parallel.hpp"
+
 #include <cstddef>
 
 namespace numeric
 {
     //banded matrices are assumed to be in CDS format
+    //large systems are solved by spike_solve if threading model is not serial, if it meets zero pivot
+    //tridiagonal systems are solved by cyclic_reduction_tridiagonal_solve, then by serial Thomas algorithm.
+    //no pivoting is done, all solvers return false if zero pivot is met
     template<typename T>
-      inline void thomas_solve(
+      inline bool thomas_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
-        const size_t sz, const size_t band, const bool reuse_storage);
+        const size_t sz, const size_t band, const bool reuse_storage,
+        const TThreading threading_model = T_Serial);
 
     template<typename T>
-      inline void thomas_diagonal_solve(
+      inline bool thomas_diagonal_solve(
         const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage);
 
     template<typename T>
-      inline void thomas_tridiagonal_solve(
+      inline bool thomas_tridiagonal_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage);
 
     template<typename T>
-      inline void thomas_fivediagonal_solve(
+      inline bool thomas_fivediagonal_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage);
 
+    //banded LU factorization of sz x sz matrix in CDS format with optional partial pivoting, lhs is left intact
+    //factor lu is in CDS-like format with stride returned by banded_lu_stride, see lapack_impl.hpp for details
+    //pivoting is disabled if pivots == nullptr, returns false if zero pivot is met
+    inline size_t banded_lu_stride(const size_t upper_band, const size_t lower_band, const bool pivoting);
+
+    template<typename T>
+      inline bool banded_lu_factor(
+        const T* const __RESTRICT lhs, T* const __RESTRICT lu, size_t* const __RESTRICT pivots,
+        const size_t sz, const size_t upper_band, const size_t lower_band);
+
+    //solve system using factor computed by banded_lu_factor, x and rhs may be the same array
+    template<typename T>
+      inline void banded_lu_solve(
+        const T* const __RESTRICT lu, const size_t* const __RESTRICT pivots, T* const x, const T* const rhs,
+        const size_t sz, const size_t upper_band, const size_t lower_band);
+
+    //factor and solve in one go, lhs and rhs are left intact, returns false if zero pivot is met
+    template<typename T>
+      inline bool banded_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t upper_band, const size_t lower_band, const bool pivoting = true);
+
+    //banded LDL' factorization of symmetric sz x sz matrix in symmetric CDS format(diagonal and upper bands only),
+    //without pivoting, so matrix is expected to be positive definite(or diagonally dominant). ld has the same layout:
+    //row i holds D(i) followed by L(i+1,i)..L(i+band,i), lhs and ld may be the same array. returns false if zero pivot is met
+    template<typename T>
+      inline bool symmetric_banded_ldlt_factor(
+        const T* const lhs, T* const ld,
+        const size_t sz, const size_t band);
+
+    //solve system using factor computed by symmetric_banded_ldlt_factor, x and rhs may be the same array
+    template<typename T>
+      inline void symmetric_banded_ldlt_solve(
+        const T* const __RESTRICT ld, T* const x, const T* const rhs,
+        const size_t sz, const size_t band);
+
+    //factor and solve in one go, lhs is replaced by its factor if reuse_storage is set, returns false if zero pivot is met.
+    //large systems are expanded to CDS format and solved by spike_solve if threading model is not serial, as in thomas_solve,
+    //LDL' factorization is used if spike_solve meets zero pivot
+    template<typename T>
+      inline bool symmetric_banded_solve(
+        T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t band, const bool reuse_storage,
+        const TThreading threading_model = T_Serial);
+
+    //parallel cyclic reduction for tridiagonal system, lhs and rhs are left intact, returns false if zero pivot is met
+    template<typename T>
+      inline bool cyclic_reduction_tridiagonal_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const TThreading threading_model = T_Serial);
+
+    //partitioned(SPIKE) solver for system with band matrix, lhs and rhs are left intact
+    //partitions are factored without pivoting, so matrix is expected to be diagonally dominant
+    template<typename T>
+      inline bool spike_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t band, const TThreading threading_model = T_Serial);
+
+    //many independent tridiagonal systems of the same size stored interleaved: element j of system s is at [j*batch + s],
+    //so row r of CDS matrix of system s is lhs[(3*r + p)*batch + s]. lhs and rhs are left intact
+    template<typename T>
+      inline void batched_tridiagonal_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t batch, const TThreading threading_model = T_Serial);
+
+    //convert batch of contiguous arrays of length len to interleaved layout and back
+    template<typename T>
+      inline void batched_interleave(const T* const __RESTRICT src, T* const __RESTRICT dst, const size_t len, const size_t batch);
+
+    template<typename T>
+      inline void batched_deinterleave(const T* const __RESTRICT src, T* const __RESTRICT dst, const size_t len, const size_t batch);
+
+    //reverse Cuthill-McKee ordering of square sparse matrix in CSR format with column indices sorted within rows,
+    //see E. Cuthill and J. McKee, "Reducing the bandwidth of sparse symmetric matrices", 1969.
+    //structure of A+A^T is used, permutation[i] is the row(and column) of matrix moved to position i
+    inline void rcm_ordering(
+        const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices, const size_t sz,
+        size_t* const __RESTRICT permutation);
+
+    //bandwidth of CSR matrix with rows and columns permuted, permutation == nullptr means no permutation
+    inline void csr_bandwidth(
+        const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices, const size_t sz,
+        const size_t* const __RESTRICT permutation, size_t& upper_band, size_t& lower_band);
+
+    //gather CSR matrix with rows and columns permuted into CDS format, duplicates are summed up,
+    //returns false if some elements don't fit into given bands
+    template<typename T>
+      inline bool csr_to_cds(
+        const T* const __RESTRICT a, const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices,
+        const size_t sz, const size_t* const __RESTRICT permutation,
+        T* const __RESTRICT cds, const size_t upper_band, const size_t lower_band);
+
+    //sparse system in CSR format is reordered by rcm_ordering into banded one, solved by banded_solve
+    //(or by spike_solve if pivoting is not required and threading model is not serial, banded_solve is tried if it fails),
+    //and solution is permuted back.
+    //storage of band is sz*(upper_band+lower_band+1), so it pays off for matrices narrow banded after reordering only
+    template<typename T>
+      inline bool sparse_banded_solve(
+        const T* const __RESTRICT a, const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices,
+        T* const __RESTRICT x, const T* const __RESTRICT rhs, const size_t sz,
+        const bool pivoting = true, const TThreading threading_model = T_Serial);
+
+    //blocked right-looking LU factorization with partial pivoting of sz x sz row major matrix with leading dimension lda,
+    //done in place: a is replaced by L(unit diagonal is not stored) and U. pivots[k] is row swapped with row k before step k.
+    //panels of block_size columns(0 selects default value) are factored recursively, the rest of the work is done by trsm and gemm.
+    //returns false if zero pivot is met
+    template<typename T>
+      inline bool dense_lu_factor(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t block_size = 0, const TThreading threading_model = T_Serial);
+
+    //solve system using factor computed by dense_lu_factor, x and rhs may be the same array
+    template<typename T>
+      inline void dense_lu_solve(
+        const T* const __RESTRICT lu, const size_t lda, const size_t* const __RESTRICT pivots,
+        T* const x, const T* const rhs, const size_t sz);
+
+    //tiled LU factorization with partial pivoting, result is the same as of dense_lu_factor(and is used by dense_lu_solve),
+    //but every tile operation is a task of dependency graph, so that panels overlap with trailing updates instead of
+    //being separated by fork-join barriers. tiles are tile_size x tile_size(0 selects default value) submatrices of
+    //row major matrix with leading dimension lda, see lapack_impl.hpp for details. returns false if zero pivot is met.
+    //whole graph is built up front, so tile_size is raised to at least 8 and to at least sz/64, which keeps
+    //graph within ~90K tasks whatever is asked for
+    template<typename T>
+      inline bool tiled_lu_factor(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t tile_size = 0, const TThreading threading_model = T_Serial);
+
+    //blocked right-looking Cholesky factorization A = LL' of symmetric positive definite sz x sz row major matrix,
+    //done in place: only lower triangle of a is referenced and it is replaced by L, upper one is left intact.
+    //diagonal blocks of block_size columns(0 selects default value) are factored by unblocked algorithm,
+    //the rest of the work is done by trsm and gemm. factorization stops at the first non-positive pivot and
+    //returns false, index of the pivot is stored to failed_pivot unless it is null
+    template<typename T>
+      inline bool dense_cholesky_factor(
+        T* const __RESTRICT a, const size_t lda, const size_t sz,
+        const size_t block_size = 0, const TThreading threading_model = T_Serial,
+        size_t* const failed_pivot = nullptr);
+
+    //tiled Cholesky factorization, result is the same as of dense_cholesky_factor, but tile operations are tasks
+    //of dependency graph, see tiled_lu_factor(tile_size is raised in the same way).
+    //returns false if non-positive pivot is met, see dense_cholesky_factor
+    template<typename T>
+      inline bool tiled_cholesky_factor(
+        T* const __RESTRICT a, const size_t lda, const size_t sz,
+        const size_t tile_size = 0, const TThreading threading_model = T_Serial,
+        size_t* const failed_pivot = nullptr);
+
+    //solve system using factor computed by dense_cholesky_factor or tiled_cholesky_factor, x and rhs may be the same array
+    template<typename T>
+      inline void dense_cholesky_solve(
+        const T* const __RESTRICT l, const size_t lda,
+        T* const x, const T* const rhs, const size_t sz);
+
+    //solve systems for nrhs right hand sides at once using factor computed by dense_lu_factor or tiled_lu_factor,
+    //b is sz x nrhs row major matrix with leading dimension ldb, every column of it is replaced by the solution.
+    //substitutions are done by trsm, so columns of b are split between workers
+    template<typename T>
+      inline void dense_lu_solve_multiple(
+        const T* const __RESTRICT lu, const size_t lda, const size_t* const __RESTRICT pivots,
+        T* const __RESTRICT b, const size_t ldb, const size_t sz, const size_t nrhs,
+        const TThreading threading_model = T_Serial);
+
+    //same as dense_lu_solve_multiple, but for factor computed by dense_cholesky_factor or tiled_cholesky_factor
+    template<typename T>
+      inline void dense_cholesky_solve_multiple(
+        const T* const __RESTRICT l, const size_t lda,
+        T* const __RESTRICT b, const size_t ldb, const size_t sz, const size_t nrhs,
+        const TThreading threading_model = T_Serial);
+
+    //Bunch-Kaufman factorization A = P L D L' P' of symmetric(possibly indefinite) sz x sz row major matrix, done in place:
+    //only lower triangle of a is referenced and it is replaced by unit lower triangular L(diagonal is not stored) and
+    //block diagonal D with 1x1 and 2x2 blocks. pivots are as in LAPACK dsytrf with uplo = 'L', but zero based:
+    //pivots[k] >= 0 means 1x1 block D(k,k) with rows and columns k and pivots[k] interchanged, pivots[k] = pivots[k+1] < 0
+    //means 2x2 block D(k:k+2,k:k+2) with rows and columns k+1 and -pivots[k]-1 interchanged. trailing updates are
+    //split between workers. returns false if the matrix is singular, index of zero pivot is stored to failed_pivot unless it is null
+    template<typename T>
+      inline bool dense_ldlt_factor(
+        T* const __RESTRICT a, const size_t lda, std::ptrdiff_t* const __RESTRICT pivots, const size_t sz,
+        const TThreading threading_model = T_Serial, size_t* const failed_pivot = nullptr);
+
+    //solve system using factor computed by dense_ldlt_factor, x and rhs may be the same array
+    template<typename T>
+      inline void dense_ldlt_solve(
+        const T* const __RESTRICT ldl, const size_t lda, const std::ptrdiff_t* const __RESTRICT pivots,
+        T* const x, const T* const rhs, const size_t sz);
+
+    //mixed precision iterative refinement, as in LAPACK dsgesv: copy of A in low precision TLow is factored by dense_lu_factor,
+    //residuals b - Ax are accumulated in precision TResidual and corrections found with low precision factor are added to x,
+    //which is kept in target precision T, until residual is at the level of rounding errors of T. if that doesn't happen
+    //in max_iter steps(or A, b or residual doesn't fit in TLow), A is factored in precision T instead. a is left intact, x and rhs
+    //may not overlap. returns false if the matrix is singular, number of refinement steps(or -1 if fallback factorization
+    //was used) is stored to iterations unless it is null
+    template<typename TLow, typename T, typename TResidual = T>
+      inline bool refined_lu_solve(
+        const T* const __RESTRICT a, const size_t lda, T* const __RESTRICT x, const T* const __RESTRICT rhs, const size_t sz,
+        const size_t max_iter = 30, const TThreading threading_model = T_Serial, int* const iterations = nullptr);
+
     template<typename T> T residual_l2_norm(const size_t sz, const size_t stride,
         const T* const __RESTRICT lhs, const T* const __RESTRICT rhs, const T* const __RESTRICT x);
 
@@ -37,5 +241,6 @@ namespace numeric
 }
 
 #include "numeric/lapack_impl.hpp"
+#include "numeric/lapack_sparse_impl.hpp"
 
 #endif /* _LAPACK_HPP */
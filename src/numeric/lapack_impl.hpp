@@ -4,52 +4,73 @@
 #include "config.h"
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <cmath>
+#include <utility>
+#include <limits>
 
 #include "numeric/blas.hpp"
+#include "numeric/real.hpp"
+#include "numeric/parallel_workers.hpp"
+#include "numeric/parallel_tasks.hpp"
 
 namespace numeric
 {
 
     //banded matrices are assumed to be in CDS format
     template<typename T>
-      inline void thomas_diagonal_solve(
+      inline bool thomas_diagonal_solve(
         const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage)
     {
       for(size_t i = 0; i < sz; i++ )
       {
+        if(lhs[i] == T(0))
+          return false;
         x[i] = rhs[i] / lhs[i];
       }
+      return true;
     }
 
     template<typename T>
-      inline void thomas_tridiagonal_solve(
+      inline bool thomas_tridiagonal_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage)
     {
       if(reuse_storage)
       {
         T fac;
-        //forward elimination
+        //forward elimination, pivots are diagonal elements of eliminated rows
         for(size_t i = 1; i < sz; i++ )
         {
+          if(lhs[3*i - 2] == T(0))
+            return false;
           fac = lhs[3*i] / lhs[3*i - 2];
           lhs[3*i + 1] -= fac*lhs[3*i - 1];
           rhs[i] -= fac*rhs[i - 1];
         }
         //backward substitution
+        if(lhs[3*sz - 2] == T(0))
+          return false;
         x[sz - 1] = rhs[sz - 1] / lhs[3*sz - 2];
         for(size_t i = 2; i <= sz; i++ )
         {
           x[sz - i] = (rhs[sz - i] - lhs[3*(sz - i) + 2]*x[sz - i + 1]) / lhs[3*(sz - i) + 1];
         }
+        return true;
       } else {
-        //TODO: STUB!
+        //eliminate on copies of system
+        std::vector<T> lhs_copy(lhs, lhs + 3*sz);
+        std::vector<T> rhs_copy(rhs, rhs + sz);
+        return thomas_tridiagonal_solve(lhs_copy.data(), x, rhs_copy.data(), sz, true);
       }
     }
 
     template<typename T>
-      inline void thomas_fivediagonal_solve(
+      inline bool thomas_fivediagonal_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
         const size_t sz, const bool reuse_storage)
     {
@@ -58,11 +79,16 @@ namespace numeric
         T fac1, fac2, diag;
         //forward elimination
         diag = lhs[2];
+        if(diag == T(0))
+          return false;
         lhs[3] /= diag;
         lhs[4] /= diag;
         rhs[0] /= diag;
-        fac1 = lhs[6] / lhs[2];
+        //row 0 is already normalized
+        fac1 = lhs[6];
         diag = lhs[7] - fac1*lhs[3];
+        if(diag == T(0))
+          return false;
         lhs[8] -= fac1*lhs[4];
         lhs[8] /= diag;
         lhs[9] /= diag;
@@ -73,6 +99,8 @@ namespace numeric
           fac2 = lhs[5*i] ;// / lhs[5*i - 8];
           fac1 = lhs[5*i + 1] - fac2*lhs[5*i - 7];// / lhs[5*i - 3];
           diag = lhs[5*i + 2] - fac1*lhs[5*i - 2] - fac2*lhs[5*i - 6];
+          if(diag == T(0))
+            return false;
           lhs[5*i + 3] -= fac1*lhs[5*i - 1];
           lhs[5*i + 3] /= diag;
           lhs[5*i + 4] /= diag;
@@ -86,8 +114,12 @@ namespace numeric
         {
           x[sz - i] = rhs[sz - i] - lhs[5*(sz - i) + 3]*x[sz - i + 1] - lhs[5*(sz - i) + 4]*x[sz - i + 2];
         }
+        return true;
       } else {
-        //TODO: STUB!
+        //eliminate on copies of system
+        std::vector<T> lhs_copy(lhs, lhs + 5*sz);
+        std::vector<T> rhs_copy(rhs, rhs + sz);
+        return thomas_fivediagonal_solve(lhs_copy.data(), x, rhs_copy.data(), sz, true);
       }
     }
 
@@ -121,11 +153,682 @@ namespace numeric
     }
 */
 
+    //banded LU factorization, as in LAPACK dgbtrf, but row oriented to fit CDS format
+    //row i of lu holds columns [i-lower_band,i+upper_band_lu] of matrix being eliminated, where upper_band_lu is
+    //upper_band + lower_band with pivoting(room for fill-in from swapped rows) and upper_band without it.
+    //once step k is done, first lower_band elements of row k hold multipliers of step k for rows k+1..k+lower_band
+    //and the rest of row k is row k of U. pivots[k] is row swapped with row k before step k, so that
+    //multipliers are applied in the same order as in dgbtrs
+    inline size_t banded_lu_stride(const size_t upper_band, const size_t lower_band, const bool pivoting)
+    {
+      return upper_band + ( pivoting ? 2*lower_band : lower_band ) + 1;
+    }
+
+    template<typename T>
+      inline bool banded_lu_factor(
+        const T* const __RESTRICT lhs, T* const __RESTRICT lu, size_t* const __RESTRICT pivots,
+        const size_t sz, const size_t upper_band, const size_t lower_band)
+    {
+      using std::abs;
+      const size_t stride_lhs = upper_band + lower_band + 1;
+      const size_t stride = banded_lu_stride(upper_band, lower_band, pivots != nullptr);
+      const size_t upper_band_lu = stride - lower_band - 1;
+      //copy matrix, zeroing elements outside of it and room for fill-in
+      for(size_t i = 0; i < sz; i++)
+      {
+        T* const __RESTRICT lu_i = lu + i*stride;
+        const size_t p_begin = ( lower_band > i ? lower_band - i : 0 );
+        const size_t p_end = std::min(stride_lhs, sz + lower_band - i);
+        for(size_t p = 0; p < p_begin; p++)
+          lu_i[p] = T(0);
+        for(size_t p = p_begin; p < p_end; p++)
+          lu_i[p] = lhs[i*stride_lhs + p];
+        for(size_t p = p_end; p < stride; p++)
+          lu_i[p] = T(0);
+      }
+      for(size_t k = 0; k < sz; k++)
+      {
+        const size_t i_end = std::min(sz, k + lower_band + 1);
+        const size_t j_end = std::min(sz, k + upper_band_lu + 1);
+        //element (i,j) of row i is at lu[i*stride + j - i + lower_band]
+        T* const __RESTRICT lu_k = lu + k*stride + lower_band - k;
+        if(pivots != nullptr)
+        {
+          size_t pivot = k;
+          //magnitudes are compared as reals, so that complex matrices are supported too
+          double pivot_abs = toDouble(abs(lu_k[k]));
+          for(size_t i = k + 1; i < i_end; i++)
+          {
+            const double a = toDouble(abs(lu[i*stride + k + lower_band - i]));
+            if(pivot_abs < a)
+            {
+              pivot = i;
+              pivot_abs = a;
+            }
+          }
+          pivots[k] = pivot;
+          if(pivot != k)
+          {
+            T* const __RESTRICT lu_p = lu + pivot*stride + lower_band - pivot;
+            for(size_t j = k; j < j_end; j++)
+              std::swap(lu_k[j], lu_p[j]);
+          }
+        }
+        const T diag = lu_k[k];
+        if(diag == T(0))
+          return false;
+        //eliminate column k, multipliers are stored in place of columns of row k that are already eliminated
+        for(size_t i = k + 1; i < i_end; i++)
+        {
+          T* const __RESTRICT lu_i = lu + i*stride + lower_band - i;
+          const T m = lu_i[k] / diag;
+          lu_i[k] = T(0);
+          for(size_t j = k + 1; j < j_end; j++)
+            lu_i[j] -= m * lu_k[j];
+          lu[k*stride + i - k - 1] = m;
+        }
+      }
+      return true;
+    }
+
+    template<typename T>
+      inline void banded_lu_solve(
+        const T* const __RESTRICT lu, const size_t* const __RESTRICT pivots, T* const x, const T* const rhs,
+        const size_t sz, const size_t upper_band, const size_t lower_band)
+    {
+      const size_t stride = banded_lu_stride(upper_band, lower_band, pivots != nullptr);
+      const size_t upper_band_lu = stride - lower_band - 1;
+      if(x != rhs)
+        std::copy(rhs, rhs + sz, x);
+      //forward substitution
+      for(size_t k = 0; k < sz; k++)
+      {
+        if(pivots != nullptr && pivots[k] != k)
+          std::swap(x[k], x[pivots[k]]);
+        const T* const __RESTRICT m = lu + k*stride;
+        const T x_k = x[k];
+        const size_t r_end = std::min(lower_band, sz - k - 1);
+        for(size_t r = 0; r < r_end; r++)
+          x[k + 1 + r] -= m[r] * x_k;
+      }
+      //backward substitution
+      for(size_t k = sz; k-- > 0; )
+      {
+        const T* const __RESTRICT u_k = lu + k*stride + lower_band - k;
+        const size_t j_end = std::min(sz, k + upper_band_lu + 1);
+        T sum = x[k];
+        for(size_t j = k + 1; j < j_end; j++)
+          sum -= u_k[j] * x[j];
+        x[k] = sum / u_k[k];
+      }
+    }
+
+    template<typename T>
+      inline bool banded_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t upper_band, const size_t lower_band, const bool pivoting)
+    {
+      std::vector<T> lu(sz * banded_lu_stride(upper_band, lower_band, pivoting));
+      std::vector<size_t> pivots(pivoting ? sz : 0);
+      if(!banded_lu_factor(lhs, lu.data(), ( pivoting ? pivots.data() : nullptr ), sz, upper_band, lower_band))
+        return false;
+      banded_lu_solve(lu.data(), ( pivoting ? pivots.data() : nullptr ), x, rhs, sz, upper_band, lower_band);
+      return true;
+    }
+
+    //banded LDL' factorization, as in LAPACK dpbtf2, but with unit triangular factor and without square roots.
+    //row k of ld is row k of matrix being eliminated from its diagonal to the right, once step k is done D(k) is
+    //kept on diagonal and the rest of row k is replaced by multipliers L(k+p,k) = A(k,k+p)/D(k)
+    template<typename T>
+      inline void __symmetric_banded_ldlt_step(T* const __RESTRICT ld_k, const size_t stride, const size_t p_end)
+    {
+      const T diag = ld_k[0];
+      //row k+p loses m*(row k), only diagonal and upper part of it is kept
+      for(size_t p = 1; p < p_end; p++)
+      {
+        T* const __RESTRICT ld_r = ld_k + p*(stride - 1);
+        const T m = ld_k[p] / diag;
+        for(size_t q = p; q < p_end; q++)
+          ld_r[q] -= m * ld_k[q];
+        ld_k[p] = m;
+      }
+    }
+
+    //same for compile time band width, first B elements of the next B rows are kept in registers,
+    //as they are the only ones updated before their rows are eliminated. row k+B has its first element updated by
+    //step k, and last element of every row is loaded from memory when its row is eliminated
+    template<typename T, size_t B>
+      inline bool __symmetric_banded_ldlt_factor_rows(T* const __RESTRICT ld, const size_t begin, const size_t end)
+    {
+      T w[B][B];
+      for(size_t j = 0; j < B; j++)
+        for(size_t c = 0; c < B; c++)
+          w[j][c] = ld[(begin + j)*(B+1) + c];
+      for(size_t k = begin; k < end; k++)
+      {
+        T* const __RESTRICT ld_k = ld + k*(B+1);
+        T a[B+1];
+        for(size_t c = 0; c < B; c++)
+          a[c] = w[0][c];
+        a[B] = ld_k[B];
+        const T diag = a[0];
+        if(diag == T(0))
+          return false;
+        T m[B+1];
+        for(size_t p = 1; p <= B; p++)
+          m[p] = a[p] / diag;
+        for(size_t j = 0; j + 1 < B; j++)
+          for(size_t c = 0; c < B; c++)
+            w[j][c] = w[j+1][c];
+        for(size_t c = 0; c < B; c++)
+          w[B-1][c] = ld[(k + B)*(B+1) + c];
+        //row k+p loses m*(row k), shifted window holds it at j = p-1
+        for(size_t p = 1; p <= B; p++)
+          for(size_t q = p; q <= B; q++)
+            w[p-1][q-p] -= m[p] * a[q];
+        ld_k[0] = diag;
+        for(size_t p = 1; p <= B; p++)
+          ld_k[p] = m[p];
+      }
+      for(size_t j = 0; j < B; j++)
+        for(size_t c = 0; c < B; c++)
+          ld[(end + j)*(B+1) + c] = w[j][c];
+      return true;
+    }
+
+    template<typename T>
+      inline bool symmetric_banded_ldlt_factor(
+        const T* const lhs, T* const ld,
+        const size_t sz, const size_t band)
+    {
+      const size_t stride = band + 1;
+      //copy matrix, zeroing elements outside of it
+      for(size_t i = 0; i < sz; i++)
+      {
+        const size_t p_end = std::min(stride, sz - i);
+        if(ld != lhs)
+          std::copy(lhs + i*stride, lhs + i*stride + p_end, ld + i*stride);
+        for(size_t p = p_end; p < stride; p++)
+          ld[i*stride + p] = T(0);
+      }
+      //rows [0,full_end) have all band rows below them
+      const size_t full_end = ( sz > band ? sz - band : 0 );
+      bool ok = true;
+      switch(full_end > 0 ? band : 0)
+      {
+        case 1:
+          ok = __symmetric_banded_ldlt_factor_rows<T,1>(ld, 0, full_end);
+          break;
+        case 2:
+          ok = __symmetric_banded_ldlt_factor_rows<T,2>(ld, 0, full_end);
+          break;
+        case 3:
+          ok = __symmetric_banded_ldlt_factor_rows<T,3>(ld, 0, full_end);
+          break;
+        case 4:
+          ok = __symmetric_banded_ldlt_factor_rows<T,4>(ld, 0, full_end);
+          break;
+        default:
+          for(size_t k = 0; k < full_end && ok; k++)
+          {
+            ok = ( ld[k*stride] != T(0) );
+            if(ok)
+              __symmetric_banded_ldlt_step(ld + k*stride, stride, stride);
+          }
+          break;
+      }
+      if(!ok)
+        return false;
+      for(size_t k = full_end; k < sz; k++)
+      {
+        if(ld[k*stride] == T(0))
+          return false;
+        __symmetric_banded_ldlt_step(ld + k*stride, stride, sz - k);
+      }
+      return true;
+    }
+
+    //rows [begin,end) of forward and backward substitutions for compile time band width,
+    //the next band elements of x are kept in registers instead of being reloaded from memory
+    template<typename T, size_t B>
+      inline void __symmetric_banded_ldlt_forward_rows(const T* const __RESTRICT ld, T* const __RESTRICT x,
+        const size_t begin, const size_t end)
+    {
+      T w[B];
+      for(size_t p = 0; p < B; p++)
+        w[p] = x[begin + p];
+      for(size_t k = begin; k < end; k++)
+      {
+        const T* const __RESTRICT m = ld + k*(B+1);
+        const T x_k = w[0];
+        for(size_t p = 1; p < B; p++)
+          w[p-1] = w[p] - m[p] * x_k;
+        w[B-1] = x[k + B] - m[B] * x_k;
+        x[k] = x_k / m[0];
+      }
+      for(size_t p = 0; p < B; p++)
+        x[end + p] = w[p];
+    }
+
+    template<typename T, size_t B>
+      inline void __symmetric_banded_ldlt_backward_rows(const T* const __RESTRICT ld, T* const __RESTRICT x,
+        const size_t begin, const size_t end)
+    {
+      T w[B];
+      for(size_t p = 0; p < B; p++)
+        w[p] = x[end + p];
+      for(size_t k = end; k-- > begin; )
+      {
+        const T* const __RESTRICT m = ld + k*(B+1);
+        T sum = x[k];
+        for(size_t p = 1; p <= B; p++)
+          sum -= m[p] * w[p-1];
+        for(size_t p = B - 1; p > 0; p--)
+          w[p] = w[p-1];
+        w[0] = sum;
+        x[k] = sum;
+      }
+    }
+
+    template<typename T>
+      inline void symmetric_banded_ldlt_solve(
+        const T* const __RESTRICT ld, T* const x, const T* const rhs,
+        const size_t sz, const size_t band)
+    {
+      const size_t stride = band + 1;
+      if(x != rhs)
+        std::copy(rhs, rhs + sz, x);
+      //rows [0,full_end) have all band rows below them
+      const size_t full_end = ( sz > band ? sz - band : 0 );
+      //forward substitution with L, multipliers of step k are in row k
+      size_t k_begin = 0;
+      switch(full_end > 0 ? band : 0)
+      {
+        case 1:
+          __symmetric_banded_ldlt_forward_rows<T,1>(ld, x, 0, full_end);
+          k_begin = full_end;
+          break;
+        case 2:
+          __symmetric_banded_ldlt_forward_rows<T,2>(ld, x, 0, full_end);
+          k_begin = full_end;
+          break;
+        case 3:
+          __symmetric_banded_ldlt_forward_rows<T,3>(ld, x, 0, full_end);
+          k_begin = full_end;
+          break;
+        case 4:
+          __symmetric_banded_ldlt_forward_rows<T,4>(ld, x, 0, full_end);
+          k_begin = full_end;
+          break;
+        default:
+          break;
+      }
+      for(size_t k = k_begin; k < sz; k++)
+      {
+        const T* const __RESTRICT m = ld + k*stride;
+        const T x_k = x[k];
+        const size_t p_end = std::min(stride, sz - k);
+        for(size_t p = 1; p < p_end; p++)
+          x[k + p] -= m[p] * x_k;
+        x[k] = x_k / m[0];
+      }
+      //backward substitution with L'
+      for(size_t k = sz; k-- > std::min(k_begin, sz); )
+      {
+        const T* const __RESTRICT m = ld + k*stride;
+        const size_t p_end = std::min(stride, sz - k);
+        T sum = x[k];
+        for(size_t p = 1; p < p_end; p++)
+          sum -= m[p] * x[k + p];
+        x[k] = sum;
+      }
+      switch(k_begin > 0 ? band : 0)
+      {
+        case 1:
+          __symmetric_banded_ldlt_backward_rows<T,1>(ld, x, 0, k_begin);
+          break;
+        case 2:
+          __symmetric_banded_ldlt_backward_rows<T,2>(ld, x, 0, k_begin);
+          break;
+        case 3:
+          __symmetric_banded_ldlt_backward_rows<T,3>(ld, x, 0, k_begin);
+          break;
+        case 4:
+          __symmetric_banded_ldlt_backward_rows<T,4>(ld, x, 0, k_begin);
+          break;
+        default:
+          break;
+      }
+    }
+
+    template<typename T>
+      inline bool symmetric_banded_solve(
+        T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t band, const bool reuse_storage,
+        const TThreading threading_model)
+    {
+      const size_t stride = band + 1;
+      //same partitioning rule as in thomas_solve
+      if(threading_model != T_Serial && threading_model != T_Undefined && band > 0
+          && ParallelScheduler::getThreadsNumber() > 1 && sz >= 2*std::max(size_t(4096), 4*band))
+      {
+        const size_t stride_cds = 2*band + 1;
+        std::vector<T> cds(sz*stride_cds, T(0));
+        for(size_t i = 0; i < sz; i++)
+        {
+          const size_t p_end = std::min(stride, sz - i);
+          for(size_t p = 0; p < p_end; p++)
+          {
+            cds[i*stride_cds + band + p] = lhs[i*stride + p];
+            cds[(i + p)*stride_cds + band - p] = lhs[i*stride + p];
+          }
+        }
+        if(spike_solve<T>(cds.data(), x, rhs, sz, band, threading_model))
+          return true;
+        //zero pivot in some partition, LDL' factorization of the whole matrix may still succeed
+      }
+      std::vector<T> ld_copy(reuse_storage ? 0 : sz*stride);
+      T* const ld = ( reuse_storage ? lhs : ld_copy.data() );
+      if(!symmetric_banded_ldlt_factor(lhs, ld, sz, band))
+        return false;
+      symmetric_banded_ldlt_solve(ld, x, rhs, sz, band);
+      return true;
+    }
+
+    //cyclic reduction, as in R. Hockney, "A fast direct solution of Poisson's equation using Fourier analysis", 1965.
+    //at level s equations i = 2s-1 (mod 2s) eliminate unknowns i-s and i+s using equations i-s and i+s,
+    //equations of the same level are independent and are split between workers
+    template<typename T>
+      inline bool cyclic_reduction_tridiagonal_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const TThreading threading_model)
+    {
+      if(sz == 0)
+        return true;
+      std::vector<T> a(sz), b(sz), c(sz), d(rhs, rhs + sz);
+      for(size_t i = 0; i < sz; i++)
+      {
+        a[i] = ( i > 0 ? lhs[3*i] : T(0) );
+        b[i] = lhs[3*i + 1];
+        c[i] = ( i + 1 < sz ? lhs[3*i + 2] : T(0) );
+      }
+      const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+      //don't bother with threads for less than ~8K equations per worker
+      auto level = [&](const size_t count, const std::function<void(size_t,size_t)>& func)
+      {
+        const size_t workers = std::max(size_t(1), std::min(max_workers, count / 8192));
+        run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+        {
+          func(count*t/workers, count*(t+1)/workers);
+        });
+      };
+      //forward reduction
+      size_t s = 1;
+      for(; 2*s <= sz; s *= 2)
+      {
+        level(sz / (2*s), [&](const size_t j_begin, const size_t j_end)
+        {
+          for(size_t i = 2*s*j_begin + 2*s - 1; i < 2*s*j_end + 2*s - 1; i += 2*s)
+          {
+            const T k1 = a[i] / b[i - s];
+            a[i] = -a[i - s]*k1;
+            b[i] -= c[i - s]*k1;
+            d[i] -= d[i - s]*k1;
+            if(i + s < sz)
+            {
+              const T k2 = c[i] / b[i + s];
+              c[i] = -c[i + s]*k2;
+              b[i] -= a[i + s]*k2;
+              d[i] -= d[i + s]*k2;
+            } else {
+              c[i] = T(0);
+            }
+          }
+        });
+      }
+      //every pivot b[i-s], b[i+s] of forward reduction is never modified after it is used,
+      //so all pivots of forward reduction and backward substitution are final values of b
+      if(std::find(b.begin(), b.end(), T(0)) != b.end())
+        return false;
+      //backward substitution, equation s-1 of the last level has single unknown
+      for(; s > 0; s /= 2)
+      {
+        level(( sz + s ) / (2*s), [&](const size_t j_begin, const size_t j_end)
+        {
+          for(size_t i = 2*s*j_begin + s - 1; i < 2*s*j_end + s - 1; i += 2*s)
+          {
+            T sum = d[i];
+            if(i >= s)
+              sum -= a[i]*x[i - s];
+            if(i + s < sz)
+              sum -= c[i]*x[i + s];
+            x[i] = sum / b[i];
+          }
+        });
+      }
+      return true;
+    }
+
+    //SPIKE algorithm, as in E. Polizzi and A. Sameh, "A parallel hybrid banded system solver: the SPIKE algorithm", 2006.
+    //matrix is split into diagonal blocks A_k coupled by band x band blocks B_k(to the right) and C_k(to the left).
+    //every worker factors its A_k and computes g_k = A_k^-1 f_k and spikes V_k = A_k^-1 [0 B_k]', W_k = A_k^-1 [C_k 0]',
+    //then reduced system for top and bottom band unknowns of every partition is solved and the rest is recovered as
+    //x_k = g_k - V_k top(x_{k+1}) - W_k bottom(x_{k-1})
+    template<typename T>
+      inline bool spike_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t band, const TThreading threading_model)
+    {
+      const size_t stride = 2*band + 1;
+      const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+      //partitions should be long enough to pay for 2*band extra solves and reduced system
+      const size_t partitions = std::min(max_workers, sz / std::max(size_t(4096), 4*band));
+      if(partitions < 2 || band == 0)
+        return banded_solve(lhs, x, rhs, sz, band, band, /* pivoting = */ false);
+      std::vector<std::vector<T>> lu(partitions), g(partitions), v(partitions), w(partitions);
+      std::vector<char> ok(partitions, 1);
+      run_workers(threading_model, partitions, [&](const size_t k)
+      {
+        const size_t begin = sz*k/partitions;
+        const size_t end = sz*(k+1)/partitions;
+        const size_t m = end - begin;
+        //factor is taken from the rows of partition, elements of B_k and C_k are dropped
+        lu[k].resize(m*stride);
+        if(!banded_lu_factor(lhs + begin*stride, lu[k].data(), static_cast<size_t*>(nullptr), m, band, band))
+        {
+          ok[k] = 0;
+          return;
+        }
+        g[k].resize(m);
+        banded_lu_solve(lu[k].data(), static_cast<const size_t*>(nullptr), g[k].data(), rhs + begin, m, band, band);
+        if(k + 1 < partitions)
+        {
+          //B_k(r,c) = A(end-band+r, end+c), nonzero for c <= r
+          v[k].assign(band*m, T(0));
+          for(size_t c = 0; c < band; c++)
+          {
+            T* const v_c = v[k].data() + c*m;
+            for(size_t r = c; r < band; r++)
+              v_c[m - band + r] = lhs[(end - band + r)*stride + 2*band + c - r];
+            banded_lu_solve(lu[k].data(), static_cast<const size_t*>(nullptr), v_c, v_c, m, band, band);
+          }
+        }
+        if(k > 0)
+        {
+          //C_k(r,c) = A(begin+r, begin-band+c), nonzero for c >= r
+          w[k].assign(band*m, T(0));
+          for(size_t c = 0; c < band; c++)
+          {
+            T* const w_c = w[k].data() + c*m;
+            for(size_t r = 0; r <= c; r++)
+              w_c[r] = lhs[(begin + r)*stride + c - r];
+            banded_lu_solve(lu[k].data(), static_cast<const size_t*>(nullptr), w_c, w_c, m, band, band);
+          }
+        }
+      });
+      if(std::find(ok.begin(), ok.end(), 0) != ok.end())
+        return false;
+      //reduced system, unknowns are top(x_0), bottom(x_0), top(x_1), ... by band elements,
+      //bottom equations of partition k reach bottom(x_{k-1}), so both bands are 3*band-1
+      const size_t sz_r = 2*band*partitions;
+      const size_t band_r = 3*band - 1;
+      const size_t stride_r = 2*band_r + 1;
+      std::vector<T> lhs_r(sz_r*stride_r, T(0)), rhs_r(sz_r), x_r(sz_r);
+      auto element_r = [&](const size_t i, const size_t j) -> T& { return lhs_r[i*stride_r + j + band_r - i]; };
+      for(size_t k = 0; k < partitions; k++)
+      {
+        const size_t m = sz*(k+1)/partitions - sz*k/partitions;
+        for(size_t r = 0; r < band; r++)
+        {
+          //top and bottom equations of partition k
+          const size_t rows[2] = { 2*k*band + r, (2*k + 1)*band + r };
+          const size_t idx[2] = { r, m - band + r };
+          for(size_t h = 0; h < 2; h++)
+          {
+            element_r(rows[h], rows[h]) = T(1);
+            rhs_r[rows[h]] = g[k][idx[h]];
+            for(size_t c = 0; c < band; c++)
+            {
+              if(k + 1 < partitions)
+                element_r(rows[h], 2*(k + 1)*band + c) = v[k][c*m + idx[h]];
+              if(k > 0)
+                element_r(rows[h], (2*k - 1)*band + c) = w[k][c*m + idx[h]];
+            }
+          }
+        }
+      }
+      if(!banded_solve(lhs_r.data(), x_r.data(), rhs_r.data(), sz_r, band_r, band_r, /* pivoting = */ true))
+        return false;
+      //recover the rest of solution
+      run_workers(threading_model, partitions, [&](const size_t k)
+      {
+        const size_t begin = sz*k/partitions;
+        const size_t m = sz*(k+1)/partitions - begin;
+        T* const __RESTRICT x_k = x + begin;
+        std::copy(g[k].begin(), g[k].end(), x_k);
+        for(size_t c = 0; c < band; c++)
+        {
+          if(k + 1 < partitions)
+          {
+            const T top_c = x_r[2*(k + 1)*band + c];
+            const T* const __RESTRICT v_c = v[k].data() + c*m;
+            for(size_t i = 0; i < m; i++)
+              x_k[i] -= v_c[i]*top_c;
+          }
+          if(k > 0)
+          {
+            const T bottom_c = x_r[(2*k - 1)*band + c];
+            const T* const __RESTRICT w_c = w[k].data() + c*m;
+            for(size_t i = 0; i < m; i++)
+              x_k[i] -= w_c[i]*bottom_c;
+          }
+        }
+      });
+      return true;
+    }
+
+    //Thomas algorithm for lanes [s_begin,s_end) of interleaved batch, every step of recurrence is
+    //stride-1 loop over lanes, so it is vectorized across systems. c_mod holds modified super-diagonal
+    template<typename T>
+      inline void __batched_tridiagonal_lanes(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t batch, const size_t s_begin, const size_t s_end, T* const __RESTRICT c_mod)
+    {
+      const size_t lanes = s_end - s_begin;
+      const T* const __RESTRICT b_0 = lhs + batch + s_begin;
+      const T* const __RESTRICT c_0 = lhs + 2*batch + s_begin;
+      const T* const __RESTRICT d_0 = rhs + s_begin;
+      T* const __RESTRICT x_0 = x + s_begin;
+      for(size_t s = 0; s < lanes; s++)
+      {
+        const T m = T(1) / b_0[s];
+        c_mod[s] = c_0[s] * m;
+        x_0[s] = d_0[s] * m;
+      }
+      //forward elimination
+      for(size_t r = 1; r < sz; r++)
+      {
+        const T* const __RESTRICT a_r = lhs + 3*r*batch + s_begin;
+        const T* const __RESTRICT b_r = a_r + batch;
+        const T* const __RESTRICT c_r = b_r + batch;
+        const T* const __RESTRICT d_r = rhs + r*batch + s_begin;
+        const T* const __RESTRICT c_prev = c_mod + (r - 1)*lanes;
+        const T* const __RESTRICT x_prev = x + (r - 1)*batch + s_begin;
+        T* const __RESTRICT c_cur = c_mod + r*lanes;
+        T* const __RESTRICT x_cur = x + r*batch + s_begin;
+        for(size_t s = 0; s < lanes; s++)
+        {
+          const T m = T(1) / (b_r[s] - a_r[s]*c_prev[s]);
+          c_cur[s] = c_r[s] * m;
+          x_cur[s] = (d_r[s] - a_r[s]*x_prev[s]) * m;
+        }
+      }
+      //backward substitution
+      for(size_t r = sz - 1; r-- > 0; )
+      {
+        const T* const __RESTRICT c_cur = c_mod + r*lanes;
+        const T* const __RESTRICT x_next = x + (r + 1)*batch + s_begin;
+        T* const __RESTRICT x_cur = x + r*batch + s_begin;
+        for(size_t s = 0; s < lanes; s++)
+          x_cur[s] -= c_cur[s]*x_next[s];
+      }
+    }
+
+    template<typename T>
+      inline void batched_tridiagonal_solve(
+        const T* const __RESTRICT lhs, T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        const size_t sz, const size_t batch, const TThreading threading_model)
+    {
+      if(sz == 0 || batch == 0)
+        return;
+      //lanes are processed in blocks, so that modified super-diagonal of block stays in cache
+      const size_t block = std::max(size_t(64), std::min(size_t(1024), ( size_t(1) << 18 ) / (sizeof(T) * sz)) / 64 * 64);
+      const size_t blocks = (batch + block - 1) / block;
+      const size_t max_workers = ( threading_model == T_Serial || threading_model == T_Undefined ? 1 : ParallelScheduler::getThreadsNumber() );
+      //don't bother with threads for less than ~64K equations per worker
+      const size_t workers = std::max(size_t(1), std::min(std::min(max_workers, blocks), sz * batch / 65536));
+      run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+      {
+        std::vector<T> c_mod(sz * block);
+        for(size_t k = blocks*t/workers; k < blocks*(t+1)/workers; k++)
+          __batched_tridiagonal_lanes(lhs, x, rhs, sz, batch, k*block, std::min(batch, (k + 1)*block), c_mod.data());
+      });
+    }
+
+    template<typename T>
+      inline void batched_interleave(const T* const __RESTRICT src, T* const __RESTRICT dst, const size_t len, const size_t batch)
+    {
+      for(size_t s = 0; s < batch; s++)
+        for(size_t j = 0; j < len; j++)
+          dst[j*batch + s] = src[s*len + j];
+    }
+
     template<typename T>
-      inline void thomas_solve(
+      inline void batched_deinterleave(const T* const __RESTRICT src, T* const __RESTRICT dst, const size_t len, const size_t batch)
+    {
+      for(size_t s = 0; s < batch; s++)
+        for(size_t j = 0; j < len; j++)
+          dst[s*len + j] = src[j*batch + s];
+    }
+
+    template<typename T>
+      inline bool thomas_solve(
         T* const __RESTRICT lhs, T* const __RESTRICT x, T* const __RESTRICT rhs,
-        const size_t sz, const size_t band, const bool reuse_storage)
+        const size_t sz, const size_t band, const bool reuse_storage,
+        const TThreading threading_model)
     {
+      //recurrences below are sequential, large systems are partitioned between workers instead
+      if(threading_model != T_Serial && threading_model != T_Undefined && band > 0
+          && ParallelScheduler::getThreadsNumber() > 1 && sz >= 2*std::max(size_t(4096), 4*band))
+      {
+        if(spike_solve<T>(lhs, x, rhs, sz, band, threading_model))
+          return true;
+        //zero pivot in diagonal block of some partition doesn't mean the whole matrix can't be factored without pivoting:
+        //tridiagonal system gets another parallel try by cyclic reduction, which doesn't split matrix into blocks,
+        //then serial recurrences below are used. both parallel solvers leave lhs and rhs intact
+        if(band == 1 && cyclic_reduction_tridiagonal_solve<T>(lhs, x, rhs, sz, threading_model))
+          return true;
+      }
 //      const size_t stride = 2*band + 1;
 //      if(!numeric::is_banded_diagonally_dominant(sz,band,band,stride,lhs))
 //      {
@@ -143,7 +846,816 @@ namespace numeric
         default:
           break;
       }
-      //TODO: generic case
+      //generic case, Thomas algorithm is LU factorization without pivoting, storage is never reused here
+      return banded_solve(lhs, x, rhs, sz, band, band, /* pivoting = */ false);
+    }
+
+    //default number of columns in panel of blocked LU, deep enough for trailing gemm update to run at full speed
+    constexpr inline size_t __dense_lu_block_size() { return 128; }
+    //panels at most that wide are factored by unblocked algorithm
+    constexpr inline size_t __dense_lu_panel_leaf_size() { return 8; }
+
+    //unblocked factorization of columns [c_begin,c_end) of rows [c_begin,sz), columns [s_begin,s_end) of pivot rows are swapped,
+    //blocked LU swaps rows in full, so that columns of L to the left and the rest of U to the right are permuted as well
+    template<typename T>
+      inline bool __dense_lu_panel_leaf(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t c_begin, const size_t c_end, const size_t s_begin, const size_t s_end)
+    {
+      using std::abs;
+      for(size_t k = c_begin; k < c_end; k++)
+      {
+        size_t pivot = k;
+        //magnitudes are compared as reals, so that complex matrices are supported too
+        double pivot_abs = toDouble(abs(a[k*lda + k]));
+        for(size_t i = k + 1; i < sz; i++)
+        {
+          const double a_abs = toDouble(abs(a[i*lda + k]));
+          if(pivot_abs < a_abs)
+          {
+            pivot = i;
+            pivot_abs = a_abs;
+          }
+        }
+        pivots[k] = pivot;
+        if(pivot != k)
+          std::swap_ranges(a + k*lda + s_begin, a + k*lda + s_end, a + pivot*lda + s_begin);
+        T* const __RESTRICT a_k = a + k*lda;
+        if(a_k[k] == T(0))
+          return false;
+        const T inv = T(1) / a_k[k];
+        for(size_t i = k + 1; i < sz; i++)
+        {
+          T* const __RESTRICT a_i = a + i*lda;
+          const T l = ( a_i[k] *= inv );
+          for(size_t j = k + 1; j < c_end; j++)
+            a_i[j] -= l * a_k[j];
+        }
+      }
+      return true;
+    }
+
+    //recursive panel factorization, as in F. Gustavson, "Recursion leads to automatic variable blocking
+    //for dense linear-algebra algorithms", 1997: left half is factored, top of right half is found by trsm,
+    //bottom of right half is updated by gemm and factored in turn, so that most of panel work is done by gemm too
+    template<typename T>
+      inline bool __dense_lu_panel(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t c_begin, const size_t c_end, const size_t s_begin, const size_t s_end,
+        const TThreading threading_model)
+    {
+      if(c_end - c_begin <= __dense_lu_panel_leaf_size())
+        return __dense_lu_panel_leaf(a, lda, pivots, sz, c_begin, c_end, s_begin, s_end);
+      const size_t c_mid = c_begin + (c_end - c_begin) / 2;
+      if(!__dense_lu_panel(a, lda, pivots, sz, c_begin, c_mid, s_begin, s_end, threading_model))
+        return false;
+      trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::No, TMatrixDiagonal::Unit,
+          c_mid - c_begin, c_end - c_mid, T(1), a + c_begin*lda + c_begin, lda, a + c_begin*lda + c_mid, lda, threading_model);
+      gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::No,
+          sz - c_mid, c_end - c_mid, c_mid - c_begin,
+          T(-1), a + c_mid*lda + c_begin, lda, a + c_begin*lda + c_mid, lda,
+          T(1), a + c_mid*lda + c_mid, lda, threading_model);
+      return __dense_lu_panel(a, lda, pivots, sz, c_mid, c_end, s_begin, s_end, threading_model);
+    }
+
+    //right-looking blocked LU, as in LAPACK dgetrf: once panel of columns [k,k_end) is factored,
+    //block row U(k:k_end,k_end:sz) = L(k:k_end,k:k_end)^-1 A(k:k_end,k_end:sz) is found by trsm
+    //and trailing submatrix A(k_end:sz,k_end:sz) -= L(k_end:sz,k:k_end) U(k:k_end,k_end:sz) is updated by gemm
+    template<typename T>
+      inline bool dense_lu_factor(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t block_size, const TThreading threading_model)
+    {
+      const size_t nb = ( block_size > 0 ? block_size : __dense_lu_block_size() );
+      for(size_t k = 0; k < sz; k += nb)
+      {
+        const size_t k_end = ( sz - k < nb ? sz : k + nb );
+        if(!__dense_lu_panel(a, lda, pivots, sz, k, k_end, 0, sz, threading_model))
+          return false;
+        if(k_end == sz)
+          break;
+        trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::No, TMatrixDiagonal::Unit,
+            k_end - k, sz - k_end, T(1), a + k*lda + k, lda, a + k*lda + k_end, lda, threading_model);
+        gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::No,
+            sz - k_end, sz - k_end, k_end - k,
+            T(-1), a + k_end*lda + k, lda, a + k*lda + k_end, lda,
+            T(1), a + k_end*lda + k_end, lda, threading_model);
+      }
+      return true;
+    }
+
+    template<typename T>
+      inline void dense_lu_solve(
+        const T* const __RESTRICT lu, const size_t lda, const size_t* const __RESTRICT pivots,
+        T* const x, const T* const rhs, const size_t sz)
+    {
+      if(x != rhs)
+        std::copy(rhs, rhs + sz, x);
+      for(size_t k = 0; k < sz; k++)
+        if(pivots[k] != k)
+          std::swap(x[k], x[pivots[k]]);
+      //forward substitution, L has unit diagonal
+      for(size_t i = 1; i < sz; i++)
+      {
+        const T* const __RESTRICT l_i = lu + i*lda;
+        T sum = x[i];
+        for(size_t j = 0; j < i; j++)
+          sum -= l_i[j] * x[j];
+        x[i] = sum;
+      }
+      //backward substitution
+      for(size_t r = 0; r < sz; r++)
+      {
+        const size_t i = sz - 1 - r;
+        const T* const __RESTRICT u_i = lu + i*lda;
+        T sum = x[i];
+        for(size_t j = i + 1; j < sz; j++)
+          sum -= u_i[j] * x[j];
+        x[i] = sum / u_i[i];
+      }
+    }
+
+    //row swaps done by panel [k_begin,k_end) of LU factorization applied to columns [c_begin,c_end)
+    template<typename T>
+      inline void __dense_lu_swap_rows(
+        T* const __RESTRICT a, const size_t lda, const size_t* const __RESTRICT pivots,
+        const size_t k_begin, const size_t k_end, const size_t c_begin, const size_t c_end)
+    {
+      for(size_t k = k_begin; k < k_end; k++)
+        if(pivots[k] != k)
+          std::swap_ranges(a + k*lda + c_begin, a + k*lda + c_end, a + pivots[k]*lda + c_begin);
+    }
+
+    //most tile columns of tiled factorizations, parallelism of their graphs is high enough by then(see below)
+    constexpr inline size_t __tiled_factor_max_tiles() { return 64; }
+
+    //task graph is built up front and has ~nt^3/3 tasks for LU(~nt^3/6 for Cholesky), so tiny tiles would make it
+    //take far more memory than matrix itself: tiles are made at least as wide as unblocked panels,
+    //and wide enough to keep number of tile columns nt within __tiled_factor_max_tiles()
+    inline size_t __tiled_factor_tile_size(const size_t sz, const size_t tile_size)
+    {
+      const size_t nb = std::max(( tile_size > 0 ? tile_size : tiled_tile_size() ), __dense_lu_panel_leaf_size());
+      return std::max(nb, (sz + __tiled_factor_max_tiles() - 1) / __tiled_factor_max_tiles());
+    }
+
+    //tiled LU, as in A. Buttari et al., "A class of parallel tiled linear algebra algorithms for multicore architectures", 2009,
+    //but with partial pivoting over whole tile column, as in PLASMA dgetrf. matrix is split into tile_size x tile_size tiles
+    //and every tile operation is a task of dependency graph:
+    //  P(k): panel of tile column k is factored, pivot rows are swapped within tile column k only
+    //  S(k,j): pivots of panel k are applied to tile column j > k, U(k,j) is found by trsm
+    //  G(k,i,j): A(i,j) -= L(i,k) U(k,j) by gemm for i,j > k
+    //tasks of leftmost tile columns are preferred, so panel k+1 starts as soon as tile column k+1 is updated,
+    //while the rest of trailing updates of step k is still running(look-ahead). columns of L are read by updates
+    //long after their panel is done, so pivots of later panels are applied to them once the graph is done.
+    //panels are serial tasks over whole tile column, so parallelism(flops of graph over flops of its critical path)
+    //grows with number of tiles nt: it's ~11 for nt = 12, ~36 for nt = 32, ~78 for nt = 64(~18, ~118, ~463 for Cholesky)
+    template<typename T>
+      inline bool tiled_lu_factor(
+        T* const __RESTRICT a, const size_t lda, size_t* const __RESTRICT pivots, const size_t sz,
+        const size_t tile_size, const TThreading threading_model)
+    {
+      const size_t nb = __tiled_factor_tile_size(sz, tile_size);
+      const size_t nt = (sz + nb - 1) / nb;
+      const size_t none = size_t(-1);
+      std::atomic<bool> failed(false);
+      TaskGraph graph;
+      //last task writing tile (i,j), tiles are in row major order
+      std::vector<size_t> last(nt*nt, none);
+      auto depend = [&](const size_t before, const size_t after)
+      {
+        if(before != none)
+          graph.addDependency(before, after);
+      };
+      for(size_t k = 0; k < nt; k++)
+      {
+        const size_t k0 = k*nb;
+        const size_t k1 = ( sz - k0 < nb ? sz : k0 + nb );
+        const size_t p = graph.addTask([=,&failed]()
+        {
+          if(failed)
+            return;
+          if(!__dense_lu_panel(a, lda, pivots, sz, k0, k1, k0, k1, T_Serial))
+            failed = true;
+        }, -2*long(k) + 1);
+        for(size_t i = k; i < nt; i++)
+        {
+          depend(last[i*nt + k], p);
+          last[i*nt + k] = p;
+        }
+        for(size_t j = k + 1; j < nt; j++)
+        {
+          const size_t j0 = j*nb;
+          const size_t j1 = ( sz - j0 < nb ? sz : j0 + nb );
+          const size_t s = graph.addTask([=,&failed]()
+          {
+            if(failed)
+              return;
+            __dense_lu_swap_rows(a, lda, pivots, k0, k1, j0, j1);
+            trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::No, TMatrixDiagonal::Unit,
+                k1 - k0, j1 - j0, T(1), a + k0*lda + k0, lda, a + k0*lda + j0, lda, T_Serial);
+          }, -2*long(j));
+          depend(p, s);
+          for(size_t i = k; i < nt; i++)
+          {
+            depend(last[i*nt + j], s);
+            last[i*nt + j] = s;
+          }
+          for(size_t i = k + 1; i < nt; i++)
+          {
+            const size_t i0 = i*nb;
+            const size_t i1 = ( sz - i0 < nb ? sz : i0 + nb );
+            const size_t g = graph.addTask([=,&failed]()
+            {
+              if(failed)
+                return;
+              gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::No,
+                  i1 - i0, j1 - j0, k1 - k0,
+                  T(-1), a + i0*lda + k0, lda, a + k0*lda + j0, lda,
+                  T(1), a + i0*lda + j0, lda, T_Serial);
+            }, -2*long(j));
+            depend(s, g);
+            last[i*nt + j] = g;
+          }
+        }
+      }
+      graph.run(threading_model, __gemm_workers(threading_model, nt*nt));
+      if(failed)
+        return false;
+      //tile columns of L are independent
+      const size_t workers = __gemm_workers(threading_model, ( sz*sz/65536 < nt ? sz*sz/65536 : nt ));
+      run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+      {
+        for(size_t j = nt * t / workers; j < nt * (t + 1) / workers; j++)
+          __dense_lu_swap_rows(a, lda, pivots, ( j + 1 < nt ? (j + 1)*nb : sz ), sz, j*nb, ( j + 1 < nt ? (j + 1)*nb : sz ));
+      });
+      return true;
+    }
+
+    //unblocked Cholesky factorization of sz x sz tile, lower triangle is replaced by L, upper one is left intact.
+    //left-looking(Crout) variant, so that every element is found by dot product of two contiguous rows.
+    //returns number of columns factored before non-positive pivot is met, sz if there is none
+    template<typename T>
+      inline size_t __dense_cholesky_tile(T* const __RESTRICT a, const size_t lda, const size_t sz)
+    {
+      using std::sqrt;
+      for(size_t j = 0; j < sz; j++)
+      {
+        T* const __RESTRICT a_j = a + j*lda;
+        T d = a_j[j];
+        for(size_t p = 0; p < j; p++)
+          d -= a_j[p] * a_j[p];
+        if(!(d > T(0)))
+          return j;
+        d = sqrt(d);
+        a_j[j] = d;
+        for(size_t i = j + 1; i < sz; i++)
+        {
+          T* const __RESTRICT a_i = a + i*lda;
+          T sum = a_i[j];
+          for(size_t p = 0; p < j; p++)
+            sum -= a_i[p] * a_j[p];
+          a_i[j] = sum / d;
+        }
+      }
+      return sz;
+    }
+
+    //right-looking blocked Cholesky, as in LAPACK dpotrf: once diagonal block L(k:k_end,k:k_end) is factored,
+    //panel L(k_end:sz,k:k_end) = A(k_end:sz,k:k_end) L(k:k_end,k:k_end)'^-1 is found by trsm and lower triangle of
+    //trailing submatrix A(k_end:sz,k_end:sz) -= L(k_end:sz,k:k_end) L(k_end:sz,k:k_end)' is updated by block rows:
+    //part to the left of diagonal block by gemm, lower triangle of diagonal block by dot products.
+    //block rows are dealt out to workers cyclically, as the lower ones have more work to do
+    template<typename T>
+      inline bool dense_cholesky_factor(
+        T* const __RESTRICT a, const size_t lda, const size_t sz,
+        const size_t block_size, const TThreading threading_model, size_t* const failed_pivot)
+    {
+      const size_t nb = ( block_size > 0 ? block_size : __dense_lu_block_size() );
+      for(size_t k = 0; k < sz; k += nb)
+      {
+        const size_t k_end = ( sz - k < nb ? sz : k + nb );
+        const size_t kb = k_end - k;
+        const size_t done = __dense_cholesky_tile(a + k*lda + k, lda, kb);
+        if(done != kb)
+        {
+          if(failed_pivot != nullptr)
+            *failed_pivot = k + done;
+          return false;
+        }
+        if(k_end == sz)
+          break;
+        const size_t m = sz - k_end;
+        trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Right, TMatrixTriangle::Lower, TMatrixTranspose::Transpose, TMatrixDiagonal::NonUnit,
+            m, kb, T(1), a + k*lda + k, lda, a + k_end*lda + k, lda, threading_model);
+        const size_t rows = (m + nb - 1) / nb;
+        const size_t mults = m*m/2*kb;
+        const size_t workers = __gemm_workers(threading_model, ( mults/65536 < rows ? mults/65536 : rows ));
+        run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+        {
+          for(size_t r = t; r < rows; r += workers)
+          {
+            const size_t i0 = k_end + r*nb;
+            const size_t i1 = ( sz - i0 < nb ? sz : i0 + nb );
+            if(i0 > k_end)
+              gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::Transpose,
+                  i1 - i0, i0 - k_end, kb,
+                  T(-1), a + i0*lda + k, lda, a + k_end*lda + k, lda,
+                  T(1), a + i0*lda + k_end, lda, T_Serial);
+            for(size_t i = i0; i < i1; i++)
+            {
+              const T* const __RESTRICT l_i = a + i*lda + k;
+              for(size_t j = i0; j <= i; j++)
+              {
+                const T* const __RESTRICT l_j = a + j*lda + k;
+                T sum = T(0);
+                for(size_t p = 0; p < kb; p++)
+                  sum += l_i[p] * l_j[p];
+                a[i*lda + j] -= sum;
+              }
+            }
+          }
+        });
+      }
+      return true;
+    }
+
+    //tiled Cholesky factorization, see tiled_lu_factor. tasks are:
+    //  F(k): A(k,k) = L(k,k) L(k,k)' by unblocked factorization
+    //  S(k,i): L(i,k) = A(i,k) L(k,k)'^-1 by trsm for i > k
+    //  G(k,i,j): A(i,j) -= L(i,k) L(j,k)' by gemm for k < j <= i, only lower triangle of diagonal tiles is updated
+    template<typename T>
+      inline bool tiled_cholesky_factor(
+        T* const __RESTRICT a, const size_t lda, const size_t sz,
+        const size_t tile_size, const TThreading threading_model, size_t* const failed_pivot)
+    {
+      const size_t nb = __tiled_factor_tile_size(sz, tile_size);
+      const size_t nt = (sz + nb - 1) / nb;
+      const size_t none = size_t(-1);
+      std::atomic<bool> failed(false);
+      //F(k) depends on every task of previous steps, so at most one of them fails
+      size_t failed_at = none;
+      TaskGraph graph;
+      //last task writing tile (i,j) of lower triangle, tiles are in row major order
+      std::vector<size_t> last(nt*nt, none);
+      auto depend = [&](const size_t before, const size_t after)
+      {
+        if(before != none)
+          graph.addDependency(before, after);
+      };
+      for(size_t k = 0; k < nt; k++)
+      {
+        const size_t k0 = k*nb;
+        const size_t k1 = ( sz - k0 < nb ? sz : k0 + nb );
+        const size_t f = graph.addTask([=,&failed,&failed_at]()
+        {
+          if(failed)
+            return;
+          const size_t done = __dense_cholesky_tile(a + k0*lda + k0, lda, k1 - k0);
+          if(done != k1 - k0)
+          {
+            failed_at = k0 + done;
+            failed = true;
+          }
+        }, -2*long(k) + 1);
+        depend(last[k*nt + k], f);
+        last[k*nt + k] = f;
+        for(size_t i = k + 1; i < nt; i++)
+        {
+          const size_t i0 = i*nb;
+          const size_t i1 = ( sz - i0 < nb ? sz : i0 + nb );
+          const size_t s = graph.addTask([=,&failed]()
+          {
+            if(failed)
+              return;
+            trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Right, TMatrixTriangle::Lower, TMatrixTranspose::Transpose, TMatrixDiagonal::NonUnit,
+                i1 - i0, k1 - k0, T(1), a + k0*lda + k0, lda, a + i0*lda + k0, lda, T_Serial);
+          }, -2*long(i));
+          depend(f, s);
+          depend(last[i*nt + k], s);
+          last[i*nt + k] = s;
+        }
+        for(size_t j = k + 1; j < nt; j++)
+        {
+          const size_t j0 = j*nb;
+          const size_t j1 = ( sz - j0 < nb ? sz : j0 + nb );
+          for(size_t i = j; i < nt; i++)
+          {
+            const size_t i0 = i*nb;
+            const size_t i1 = ( sz - i0 < nb ? sz : i0 + nb );
+            const size_t g = graph.addTask([=,&failed]()
+            {
+              if(failed)
+                return;
+              if(i != j)
+              {
+                gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::Transpose,
+                    i1 - i0, j1 - j0, k1 - k0,
+                    T(-1), a + i0*lda + k0, lda, a + j0*lda + k0, lda,
+                    T(1), a + i0*lda + j0, lda, T_Serial);
+                return;
+              }
+              //product is computed in full, but only its lower triangle is subtracted
+              const size_t jb = j1 - j0;
+              std::vector<T> tmp(jb*jb);
+              gemm<T>(TMatrixStorage::RowMajor, TMatrixTranspose::No, TMatrixTranspose::Transpose,
+                  jb, jb, k1 - k0,
+                  T(1), a + j0*lda + k0, lda, a + j0*lda + k0, lda,
+                  T(0), tmp.data(), jb, T_Serial);
+              for(size_t r = 0; r < jb; r++)
+                for(size_t c = 0; c <= r; c++)
+                  a[(j0 + r)*lda + j0 + c] -= tmp[r*jb + c];
+            }, -2*long(j));
+            depend(last[i*nt + k], g);
+            depend(last[j*nt + k], g);
+            depend(last[i*nt + j], g);
+            last[i*nt + j] = g;
+          }
+        }
+      }
+      graph.run(threading_model, __gemm_workers(threading_model, nt*nt));
+      if(failed && failed_pivot != nullptr)
+        *failed_pivot = failed_at;
+      return !failed;
+    }
+
+    template<typename T>
+      inline void dense_cholesky_solve(
+        const T* const __RESTRICT l, const size_t lda,
+        T* const x, const T* const rhs, const size_t sz)
+    {
+      if(x != rhs)
+        std::copy(rhs, rhs + sz, x);
+      //forward substitution
+      for(size_t i = 0; i < sz; i++)
+      {
+        const T* const __RESTRICT l_i = l + i*lda;
+        T sum = x[i];
+        for(size_t j = 0; j < i; j++)
+          sum -= l_i[j] * x[j];
+        x[i] = sum / l_i[i];
+      }
+      //backward substitution with L', L is traversed by rows, so x is updated by sequence of axpy
+      for(size_t r = 0; r < sz; r++)
+      {
+        const size_t i = sz - 1 - r;
+        const T* const __RESTRICT l_i = l + i*lda;
+        x[i] /= l_i[i];
+        const T x_i = x[i];
+        for(size_t j = 0; j < i; j++)
+          x[j] -= l_i[j] * x_i;
+      }
+    }
+
+    //symmetric rank-1 or rank-2 update of lower triangle of trailing submatrix A(k_begin:sz,k_begin:sz) done by Bunch-Kaufman step,
+    //A(i,j) -= x_i w_j + y_i v_j, where x, y are columns of L before scaling and w, v are those scaled by inverse of pivot block.
+    //every row is updated by contiguous axpy, rows are split between workers so that their shares of the triangle are even
+    template<typename T>
+      inline void __dense_ldlt_update(
+        T* const __RESTRICT a, const size_t lda, const size_t sz, const size_t k_begin,
+        const size_t kx, const T* const __RESTRICT w, const size_t ky, const T* const __RESTRICT v,
+        const TThreading threading_model)
+    {
+      using std::sqrt;
+      const size_t m = sz - k_begin;
+      const size_t mults = m*m/2*( v != nullptr ? 2 : 1 );
+      const size_t workers = __gemm_workers(threading_model, ( mults/65536 < m ? mults/65536 : m ));
+      run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+      {
+        //row i has i-k_begin+1 elements, so bounds of equal shares of the triangle grow as square root
+        const size_t r_begin = size_t(sqrt(double(m)*double(m)*double(t)/double(workers)));
+        const size_t r_end = ( t + 1 == workers ? m : size_t(sqrt(double(m)*double(m)*double(t + 1)/double(workers))) );
+        for(size_t i = k_begin + r_begin; i < k_begin + r_end; i++)
+        {
+          T* const __RESTRICT a_i = a + i*lda;
+          const T x_i = a_i[kx];
+          if(v == nullptr)
+          {
+            for(size_t j = k_begin; j <= i; j++)
+              a_i[j] -= x_i * w[j - k_begin];
+          } else {
+            const T y_i = a_i[ky];
+            for(size_t j = k_begin; j <= i; j++)
+              a_i[j] -= x_i * w[j - k_begin] + y_i * v[j - k_begin];
+          }
+        }
+      });
+    }
+
+    //Bunch-Kaufman diagonal pivoting, as in LAPACK dsytf2 with uplo = 'L': at step k either 1x1 pivot A(k,k) is used,
+    //or row and column k(or k+1 for 2x2 pivot) are interchanged with row and column kp of trailing submatrix,
+    //so that |L(i,j)| is bounded by growth factor (1+sqrt(17))/8. only lower triangle of A is referenced
+    template<typename T>
+      inline bool dense_ldlt_factor(
+        T* const __RESTRICT a, const size_t lda, std::ptrdiff_t* const __RESTRICT pivots, const size_t sz,
+        const TThreading threading_model, size_t* const failed_pivot)
+    {
+      using std::abs;
+      using std::sqrt;
+      const T alpha = (T(1) + sqrt(T(17))) / T(8);
+      auto at = [=](const size_t i, const size_t j) -> T& { return a[i*lda + j]; };
+      std::vector<T> w(sz), v(sz);
+      size_t k = 0;
+      while(k < sz)
+      {
+        size_t kstep = 1;
+        size_t kp = k;
+        const T absakk = abs(at(k,k));
+        //largest off-diagonal element in column k
+        size_t imax = k;
+        T colmax = T(0);
+        for(size_t i = k + 1; i < sz; i++)
+          if(colmax < abs(at(i,k)))
+          {
+            imax = i;
+            colmax = abs(at(i,k));
+          }
+        if(!(absakk > T(0)) && !(colmax > T(0)))
+        {
+          if(failed_pivot != nullptr)
+            *failed_pivot = k;
+          return false;
+        }
+        if(!(absakk < alpha*colmax))
+        {
+          kp = k;
+        } else {
+          //largest off-diagonal element in row and column imax
+          T rowmax = T(0);
+          for(size_t j = k; j < imax; j++)
+            rowmax = std::max(rowmax, abs(at(imax,j)));
+          for(size_t i = imax + 1; i < sz; i++)
+            rowmax = std::max(rowmax, abs(at(i,imax)));
+          if(!(absakk < alpha*colmax*(colmax/rowmax)))
+          {
+            kp = k;
+          } else if(!(abs(at(imax,imax)) < alpha*rowmax)) {
+            kp = imax;
+          } else {
+            kp = imax;
+            kstep = 2;
+          }
+        }
+        const size_t kk = k + kstep - 1;
+        if(kp != kk)
+        {
+          //interchange rows and columns kk and kp of lower triangle of trailing submatrix
+          for(size_t i = kp + 1; i < sz; i++)
+            std::swap(at(i,kk), at(i,kp));
+          for(size_t j = kk + 1; j < kp; j++)
+            std::swap(at(j,kk), at(kp,j));
+          std::swap(at(kk,kk), at(kp,kp));
+          if(kstep == 2)
+            std::swap(at(k+1,k), at(kp,k));
+        }
+        if(kstep == 1)
+        {
+          //A(k+1:sz,k+1:sz) -= L(k+1:sz,k) D(k)^-1 L(k+1:sz,k)', L(k+1:sz,k) = A(k+1:sz,k) D(k)^-1
+          const T d11 = T(1) / at(k,k);
+          for(size_t j = k + 1; j < sz; j++)
+            w[j - k - 1] = d11 * at(j,k);
+          if(k + 1 < sz)
+            __dense_ldlt_update(a, lda, sz, k + 1, k, w.data(), k, static_cast<const T*>(nullptr), threading_model);
+          for(size_t j = k + 1; j < sz; j++)
+            at(j,k) = w[j - k - 1];
+          pivots[k] = std::ptrdiff_t(kp);
+        } else {
+          //A(k+2:sz,k+2:sz) -= (L(k+2:sz,k) L(k+2:sz,k+1)) D(k)^-1 (L(k+2:sz,k) L(k+2:sz,k+1))', D(k) is 2x2 block
+          if(k + 2 < sz)
+          {
+            T d21 = at(k+1,k);
+            const T d11 = at(k+1,k+1) / d21;
+            const T d22 = at(k,k) / d21;
+            const T t = T(1) / (d11*d22 - T(1));
+            d21 = t / d21;
+            for(size_t j = k + 2; j < sz; j++)
+            {
+              w[j - k - 2] = d21 * (d11*at(j,k) - at(j,k+1));
+              v[j - k - 2] = d21 * (d22*at(j,k+1) - at(j,k));
+            }
+            __dense_ldlt_update(a, lda, sz, k + 2, k, w.data(), k + 1, v.data(), threading_model);
+            for(size_t j = k + 2; j < sz; j++)
+            {
+              at(j,k) = w[j - k - 2];
+              at(j,k+1) = v[j - k - 2];
+            }
+          }
+          pivots[k] = pivots[k+1] = -std::ptrdiff_t(kp) - 1;
+        }
+        k += kstep;
+      }
+      return true;
+    }
+
+    template<typename T>
+      inline void dense_ldlt_solve(
+        const T* const __RESTRICT ldl, const size_t lda, const std::ptrdiff_t* const __RESTRICT pivots,
+        T* const x, const T* const rhs, const size_t sz)
+    {
+      auto at = [=](const size_t i, const size_t j) -> T { return ldl[i*lda + j]; };
+      if(x != rhs)
+        std::copy(rhs, rhs + sz, x);
+      //L D y = P b, interchanges are applied as they were done by factorization
+      for(size_t k = 0; k < sz; )
+      {
+        if(pivots[k] >= 0)
+        {
+          std::swap(x[k], x[size_t(pivots[k])]);
+          for(size_t i = k + 1; i < sz; i++)
+            x[i] -= at(i,k) * x[k];
+          x[k] /= at(k,k);
+          k += 1;
+        } else {
+          std::swap(x[k+1], x[size_t(-pivots[k] - 1)]);
+          for(size_t i = k + 2; i < sz; i++)
+            x[i] -= at(i,k) * x[k] + at(i,k+1) * x[k+1];
+          const T akm1k = at(k+1,k);
+          const T akm1 = at(k,k) / akm1k;
+          const T ak = at(k+1,k+1) / akm1k;
+          const T denom = akm1*ak - T(1);
+          const T bkm1 = x[k] / akm1k;
+          const T bk = x[k+1] / akm1k;
+          x[k] = (ak*bkm1 - bk) / denom;
+          x[k+1] = (akm1*bk - bkm1) / denom;
+          k += 2;
+        }
+      }
+      //L' P' x = y, interchanges are applied in reverse order
+      for(size_t r = sz; r > 0; )
+      {
+        const size_t k = r - 1;
+        T sum = x[k];
+        for(size_t i = k + 1; i < sz; i++)
+          sum -= at(i,k) * x[i];
+        x[k] = sum;
+        if(pivots[k] >= 0)
+        {
+          std::swap(x[k], x[size_t(pivots[k])]);
+          r -= 1;
+        } else {
+          T sum_km1 = x[k-1];
+          for(size_t i = k + 1; i < sz; i++)
+            sum_km1 -= at(i,k-1) * x[i];
+          x[k-1] = sum_km1;
+          std::swap(x[k], x[size_t(-pivots[k] - 1)]);
+          r -= 2;
+        }
+      }
+    }
+
+    template<typename T>
+      inline void dense_lu_solve_multiple(
+        const T* const __RESTRICT lu, const size_t lda, const size_t* const __RESTRICT pivots,
+        T* const __RESTRICT b, const size_t ldb, const size_t sz, const size_t nrhs,
+        const TThreading threading_model)
+    {
+      if(sz == 0 || nrhs == 0)
+        return;
+      __dense_lu_swap_rows(b, ldb, pivots, 0, sz, 0, nrhs);
+      trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::No, TMatrixDiagonal::Unit,
+          sz, nrhs, T(1), lu, lda, b, ldb, threading_model);
+      trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Upper, TMatrixTranspose::No, TMatrixDiagonal::NonUnit,
+          sz, nrhs, T(1), lu, lda, b, ldb, threading_model);
+    }
+
+    template<typename T>
+      inline void dense_cholesky_solve_multiple(
+        const T* const __RESTRICT l, const size_t lda,
+        T* const __RESTRICT b, const size_t ldb, const size_t sz, const size_t nrhs,
+        const TThreading threading_model)
+    {
+      if(sz == 0 || nrhs == 0)
+        return;
+      trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::No, TMatrixDiagonal::NonUnit,
+          sz, nrhs, T(1), l, lda, b, ldb, threading_model);
+      trsm<T>(TMatrixStorage::RowMajor, TMatrixSide::Left, TMatrixTriangle::Lower, TMatrixTranspose::Transpose, TMatrixDiagonal::NonUnit,
+          sz, nrhs, T(1), l, lda, b, ldb, threading_model);
+    }
+
+    //r = b - Ax accumulated in precision TResidual, returns max norm of r. rows are split between workers
+    template<typename T, typename TResidual>
+      inline T __refined_lu_residual(
+        const T* const __RESTRICT a, const size_t lda, const T* const __RESTRICT x, const T* const __RESTRICT rhs,
+        T* const __RESTRICT r, const size_t sz, const TThreading threading_model)
+    {
+      using std::abs;
+      const size_t workers = __gemm_workers(threading_model, ( sz*sz/65536 < sz ? sz*sz/65536 : sz ));
+      std::vector<T> norms(workers, T(0));
+      run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+      {
+        T norm = T(0);
+        for(size_t i = sz * t / workers; i < sz * (t + 1) / workers; i++)
+        {
+          const T* const __RESTRICT a_i = a + i*lda;
+          TResidual sum = TResidual(rhs[i]);
+          for(size_t j = 0; j < sz; j++)
+            sum -= TResidual(a_i[j]) * TResidual(x[j]);
+          r[i] = static_cast<T>(sum);
+          norm = std::max(norm, T(abs(r[i])));
+        }
+        norms[t] = norm;
+      });
+      return *std::max_element(norms.begin(), norms.end());
+    }
+
+    //vector is rounded to low precision as by LAPACK dlag2s, returns false if some element is out of range of TLow
+    template<typename TLow, typename T>
+      inline bool __refined_lu_to_low(const T* const __RESTRICT v, TLow* const __RESTRICT d, const size_t sz)
+    {
+      using std::abs;
+      const T low_max = T(std::numeric_limits<TLow>::max());
+      for(size_t i = 0; i < sz; i++)
+      {
+        //NaN fails the check as well
+        if(!(abs(v[i]) <= low_max))
+          return false;
+        d[i] = static_cast<TLow>(v[i]);
+      }
+      return true;
+    }
+
+    //criterion of dsgesv: ||r|| < ||x|| ||A|| eps sqrt(sz), all norms are max norms
+    template<typename TLow, typename T, typename TResidual>
+      inline bool refined_lu_solve(
+        const T* const __RESTRICT a, const size_t lda, T* const __RESTRICT x, const T* const __RESTRICT rhs, const size_t sz,
+        const size_t max_iter, const TThreading threading_model, int* const iterations)
+    {
+      using std::abs;
+      using std::sqrt;
+      if(iterations != nullptr)
+        *iterations = 0;
+      if(sz == 0)
+        return true;
+      //low precision copy of A, rows are split between workers
+      std::vector<TLow> a_low(sz*sz);
+      const size_t workers = __gemm_workers(threading_model, ( sz*sz/65536 < sz ? sz*sz/65536 : sz ));
+      std::vector<T> row_norms(workers, T(0));
+      std::vector<char> fits(workers, 1);
+      const T low_max = T(std::numeric_limits<TLow>::max());
+      run_workers(( workers > 1 ? threading_model : T_Serial ), workers, [&](const size_t t)
+      {
+        T norm = T(0);
+        for(size_t i = sz * t / workers; i < sz * (t + 1) / workers; i++)
+        {
+          T row_norm = T(0);
+          for(size_t j = 0; j < sz; j++)
+          {
+            const T a_ij = a[i*lda + j];
+            if(abs(a_ij) > low_max)
+              fits[t] = 0;
+            a_low[i*sz + j] = static_cast<TLow>(a_ij);
+            row_norm += abs(a_ij);
+          }
+          norm = std::max(norm, row_norm);
+        }
+        row_norms[t] = norm;
+      });
+      const T a_norm = *std::max_element(row_norms.begin(), row_norms.end());
+      const T cte = a_norm * std::numeric_limits<T>::epsilon() * sqrt(T(sz));
+      std::vector<size_t> pivots(sz);
+      //b has to fit in TLow as well as A, overflow to inf would only burn all the iterations
+      std::vector<TLow> d(sz);
+      bool refine = ( std::find(fits.begin(), fits.end(), 0) == fits.end() )
+                    && __refined_lu_to_low<TLow,T>(rhs, d.data(), sz);
+      if(refine)
+        refine = dense_lu_factor<TLow>(a_low.data(), sz, pivots.data(), sz, 0, threading_model);
+      if(refine)
+      {
+        std::vector<T> r(sz);
+        dense_lu_solve<TLow>(a_low.data(), sz, pivots.data(), d.data(), d.data(), sz);
+        for(size_t i = 0; i < sz; i++)
+          x[i] = T(d[i]);
+        for(size_t iter = 0; iter <= max_iter; iter++)
+        {
+          const T r_norm = __refined_lu_residual<T,TResidual>(a, lda, x, rhs, r.data(), sz, threading_model);
+          T x_norm = T(0);
+          for(size_t i = 0; i < sz; i++)
+            x_norm = std::max(x_norm, T(abs(x[i])));
+          if(r_norm < x_norm * cte)
+          {
+            if(iterations != nullptr)
+              *iterations = int(iter);
+            return true;
+          }
+          //correction is found with low precision factor, residual out of range of TLow means it won't converge
+          if(iter == max_iter || !__refined_lu_to_low<TLow,T>(r.data(), d.data(), sz))
+            break;
+          dense_lu_solve<TLow>(a_low.data(), sz, pivots.data(), d.data(), d.data(), sz);
+          for(size_t i = 0; i < sz; i++)
+            x[i] += T(d[i]);
+        }
+      }
+      //refinement failed, A is factored in target precision
+      if(iterations != nullptr)
+        *iterations = -1;
+      a_low.clear();
+      a_low.shrink_to_fit();
+      std::vector<T> lu(sz*sz);
+      for(size_t i = 0; i < sz; i++)
+        std::copy(a + i*lda, a + i*lda + sz, lu.data() + i*sz);
+      if(!dense_lu_factor<T>(lu.data(), sz, pivots.data(), sz, 0, threading_model))
+        return false;
+      dense_lu_solve<T>(lu.data(), sz, pivots.data(), x, rhs, sz);
+      return true;
     }
 
     //debug residual norm calculation
@@ -0,0 +1,240 @@
+#pragma once
+#ifndef _LAPACK_SPARSE_IMPL_HPP
+#define _LAPACK_SPARSE_IMPL_HPP
+#include "config.h"
+
+#include "numeric/lapack.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace numeric
+{
+    //structure of A+A^T without diagonal, rows of adjacency are sorted
+    inline void __symmetric_adjacency(
+        const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices, const size_t sz,
+        std::vector<size_t>& adj_ptr, std::vector<size_t>& adj)
+    {
+      const size_t nnz = row_ptr[sz];
+      //transposed structure, counting sort keeps its rows sorted
+      std::vector<size_t> t_ptr(sz + 1, 0);
+      for(size_t k = 0; k < nnz; k++)
+        t_ptr[column_indices[k] + 1]++;
+      for(size_t i = 0; i < sz; i++)
+        t_ptr[i+1] += t_ptr[i];
+      std::vector<size_t> t_idx(nnz);
+      {
+        std::vector<size_t> next(t_ptr.begin(), t_ptr.end() - 1);
+        for(size_t i = 0; i < sz; i++)
+          for(size_t k = row_ptr[i]; k < row_ptr[i+1]; k++)
+            t_idx[next[column_indices[k]]++] = i;
+      }
+      //merge rows of A and A^T
+      adj_ptr.assign(sz + 1, 0);
+      adj.clear();
+      adj.reserve(2*nnz);
+      for(size_t i = 0; i < sz; i++)
+      {
+        size_t p = row_ptr[i], q = t_ptr[i];
+        while(p < row_ptr[i+1] || q < t_ptr[i+1])
+        {
+          size_t j;
+          if(q == t_ptr[i+1] || ( p < row_ptr[i+1] && column_indices[p] < t_idx[q] ))
+            j = column_indices[p++];
+          else if(p == row_ptr[i+1] || t_idx[q] < column_indices[p])
+            j = t_idx[q++];
+          else
+          {
+            j = t_idx[q++];
+            p++;
+          }
+          if(j != i && ( adj.size() == adj_ptr[i] || adj.back() != j ))
+            adj.push_back(j);
+        }
+        adj_ptr[i+1] = adj.size();
+      }
+    }
+
+    //rooted level structure: breadth first search from root, nodes are put to order level by level.
+    //returns number of levels, first node of the last level and total number of nodes reached
+    inline size_t __level_structure(
+        const std::vector<size_t>& adj_ptr, const std::vector<size_t>& adj, const size_t root,
+        std::vector<size_t>& mark, const size_t stamp, size_t* const order,
+        size_t& last_level_begin, size_t& count)
+    {
+      order[0] = root;
+      mark[root] = stamp;
+      size_t levels = 0,
+             level_begin = 0,
+             level_end = 1,
+             tail = 1;
+      while(level_begin < level_end)
+      {
+        levels++;
+        last_level_begin = level_begin;
+        for(size_t h = level_begin; h < level_end; h++)
+          for(size_t k = adj_ptr[order[h]]; k < adj_ptr[order[h]+1]; k++)
+            if(mark[adj[k]] != stamp)
+            {
+              mark[adj[k]] = stamp;
+              order[tail++] = adj[k];
+            }
+        level_begin = level_end;
+        level_end = tail;
+      }
+      count = tail;
+      return levels;
+    }
+
+    //pseudo-peripheral node of component of start, as in A. George and J. Liu, "An implementation of a
+    //pseudoperipheral node finder", 1979: root is moved to node of minimum degree in the last level of
+    //its level structure while number of levels grows
+    inline size_t __pseudo_peripheral_node(
+        const std::vector<size_t>& adj_ptr, const std::vector<size_t>& adj, const size_t start,
+        std::vector<size_t>& mark, size_t& stamp, size_t* const order)
+    {
+      size_t root = start,
+             last_level_begin = 0,
+             count = 0;
+      size_t levels = __level_structure(adj_ptr, adj, root, mark, ++stamp, order, last_level_begin, count);
+      for(;;)
+      {
+        size_t candidate = order[last_level_begin];
+        for(size_t h = last_level_begin + 1; h < count; h++)
+          if(adj_ptr[order[h]+1] - adj_ptr[order[h]] < adj_ptr[candidate+1] - adj_ptr[candidate])
+            candidate = order[h];
+        const size_t candidate_levels = __level_structure(adj_ptr, adj, candidate, mark, ++stamp, order, last_level_begin, count);
+        if(candidate_levels <= levels)
+          return root;
+        root = candidate;
+        levels = candidate_levels;
+      }
+    }
+
+    inline void rcm_ordering(
+        const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices, const size_t sz,
+        size_t* const __RESTRICT permutation)
+    {
+      std::vector<size_t> adj_ptr, adj;
+      __symmetric_adjacency(row_ptr, column_indices, sz, adj_ptr, adj);
+      auto degree = [&](const size_t i) { return adj_ptr[i+1] - adj_ptr[i]; };
+      std::vector<size_t> mark(sz, 0);
+      std::vector<size_t> order(sz);
+      std::vector<char> numbered(sz, 0);
+      size_t stamp = 0,
+             n = 0;
+      for(size_t s = 0; s < sz; s++)
+      {
+        if(numbered[s])
+          continue;
+        //cuthill-mckee: breadth first search from pseudo-peripheral node of component,
+        //neighbours of every node are numbered in order of increasing degree
+        const size_t root = __pseudo_peripheral_node(adj_ptr, adj, s, mark, stamp, order.data());
+        numbered[root] = 1;
+        permutation[n++] = root;
+        for(size_t head = n - 1; head < n; head++)
+        {
+          const size_t v = permutation[head];
+          const size_t first = n;
+          for(size_t k = adj_ptr[v]; k < adj_ptr[v+1]; k++)
+            if(!numbered[adj[k]])
+            {
+              numbered[adj[k]] = 1;
+              permutation[n++] = adj[k];
+            }
+          std::sort(permutation + first, permutation + n, [&](const size_t l, const size_t r)
+              { return degree(l) < degree(r) || ( degree(l) == degree(r) && l < r ); });
+        }
+      }
+      //reversed ordering has the same bandwidth, but less fill-in for factorization
+      std::reverse(permutation, permutation + sz);
+    }
+
+    inline void __inverse_permutation(const size_t* const __RESTRICT permutation, const size_t sz, std::vector<size_t>& inverse)
+    {
+      inverse.resize(sz);
+      for(size_t i = 0; i < sz; i++)
+        inverse[( permutation == nullptr ? i : permutation[i] )] = i;
+    }
+
+    inline void csr_bandwidth(
+        const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices, const size_t sz,
+        const size_t* const __RESTRICT permutation, size_t& upper_band, size_t& lower_band)
+    {
+      std::vector<size_t> inverse;
+      __inverse_permutation(permutation, sz, inverse);
+      upper_band = lower_band = 0;
+      for(size_t i = 0; i < sz; i++)
+      {
+        const size_t row = ( permutation == nullptr ? i : permutation[i] );
+        for(size_t k = row_ptr[row]; k < row_ptr[row+1]; k++)
+        {
+          const size_t j = inverse[column_indices[k]];
+          if(j > i)
+            upper_band = std::max(upper_band, j - i);
+          else
+            lower_band = std::max(lower_band, i - j);
+        }
+      }
+    }
+
+    template<typename T>
+      inline bool csr_to_cds(
+        const T* const __RESTRICT a, const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices,
+        const size_t sz, const size_t* const __RESTRICT permutation,
+        T* const __RESTRICT cds, const size_t upper_band, const size_t lower_band)
+    {
+      const size_t stride = upper_band + lower_band + 1;
+      std::vector<size_t> inverse;
+      __inverse_permutation(permutation, sz, inverse);
+      std::fill(cds, cds + sz*stride, T(0));
+      bool fits = true;
+      for(size_t i = 0; i < sz; i++)
+      {
+        const size_t row = ( permutation == nullptr ? i : permutation[i] );
+        for(size_t k = row_ptr[row]; k < row_ptr[row+1]; k++)
+        {
+          const size_t j = inverse[column_indices[k]];
+          if(j + lower_band < i || j > i + upper_band)
+            fits = false;
+          else
+            cds[i*stride + j + lower_band - i] += a[k];
+        }
+      }
+      return fits;
+    }
+
+    template<typename T>
+      inline bool sparse_banded_solve(
+        const T* const __RESTRICT a, const size_t* const __RESTRICT row_ptr, const size_t* const __RESTRICT column_indices,
+        T* const __RESTRICT x, const T* const __RESTRICT rhs, const size_t sz,
+        const bool pivoting, const TThreading threading_model)
+    {
+      std::vector<size_t> permutation(sz);
+      rcm_ordering(row_ptr, column_indices, sz, permutation.data());
+      size_t upper_band = 0,
+             lower_band = 0;
+      csr_bandwidth(row_ptr, column_indices, sz, permutation.data(), upper_band, lower_band);
+      //symmetric permutation keeps diagonal dominance, so spike_solve can be used if pivoting is not required
+      const bool spike = ( !pivoting && threading_model != T_Serial && threading_model != T_Undefined );
+      if(spike)
+        upper_band = lower_band = std::max(upper_band, lower_band);
+      std::vector<T> cds(sz*(upper_band + lower_band + 1));
+      csr_to_cds(a, row_ptr, column_indices, sz, permutation.data(), cds.data(), upper_band, lower_band);
+      std::vector<T> b(sz), y(sz);
+      for(size_t i = 0; i < sz; i++)
+        b[i] = rhs[permutation[i]];
+      //spike_solve fails if some partition meets zero pivot, serial factorization may still get through
+      const bool ok = ( ( spike && spike_solve(cds.data(), y.data(), b.data(), sz, upper_band, threading_model) )
+                        || banded_solve(cds.data(), y.data(), b.data(), sz, upper_band, lower_band, pivoting) );
+      if(ok)
+      {
+        for(size_t i = 0; i < sz; i++)
+          x[permutation[i]] = y[i];
+      }
+      return ok;
+    }
+
+}
+
+#endif /* _LAPACK_SPARSE_IMPL_HPP */
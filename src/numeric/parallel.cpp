@@ -66,6 +66,137 @@ unsigned hardware_concurrency()
   return 1;
 }
 
+WorkerPool::WorkerPool(const TThreading threadingBackend, const unsigned threadsNumber)
+  : m_backend(threadingBackend), m_size(1), m_busy(false), m_func(nullptr), m_workers(0), m_running(0),
+    m_generation(0), m_stop(false), m_error(nullptr)
+{
+  //calling thread is worker 0, so pool keeps one thread less
+  const size_t helpers = ( threadsNumber > 1 ? threadsNumber - 1 : 0 );
+  switch(m_backend)
+  {
+    case T_Std:
+      m_threads.reserve(helpers);
+      for(size_t id = 1; id <= helpers; id++)
+        m_threads.push_back(std::thread(&WorkerPool::loop, this, id));
+      m_size = helpers + 1;
+      return;
+#ifdef HAVE_PTHREADS
+    case T_Posix:
+      //arguments shouldn't move while threads are running
+      m_pthreads.reserve(helpers);
+      m_pthread_args.reserve(helpers);
+      for(size_t id = 1; id <= helpers; id++)
+      {
+        pthread_t thread;
+        m_pthread_args.push_back(PosixThreadArg{this, id});
+        if(pthread_create(&thread, NULL, &WorkerPool::runPosixThread, &m_pthread_args.back()) != 0)
+        {
+          m_pthread_args.pop_back();
+          break;
+        }
+        m_pthreads.push_back(thread);
+      }
+      m_size = m_pthreads.size() + 1;
+      return;
+#endif
+    default:
+      return;
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv_start.notify_all();
+  for(std::thread& thread : m_threads)
+    thread.join();
+#ifdef HAVE_PTHREADS
+  for(pthread_t& thread : m_pthreads)
+    pthread_join(thread, NULL);
+#endif
+}
+
+#ifdef HAVE_PTHREADS
+void* WorkerPool::runPosixThread(void* arg)
+{
+  PosixThreadArg* const parg = static_cast<PosixThreadArg*>(arg);
+  parg->pool->loop(parg->id);
+  return NULL;
+}
+#endif
+
+void WorkerPool::loop(const size_t id)
+{
+  size_t generation = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for(;;)
+  {
+    m_cv_start.wait(lock, [&]{ return m_stop || m_generation != generation; });
+    if(m_stop)
+      return;
+    generation = m_generation;
+    //threads above workers count sit this region out
+    if(id >= m_workers)
+      continue;
+    const std::function<void(size_t)>& func = *m_func;
+    lock.unlock();
+    std::exception_ptr error = nullptr;
+    try {
+      func(id);
+    } catch(...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if(error != nullptr && m_error == nullptr)
+      m_error = error;
+    if(--m_running == 0)
+      m_cv_done.notify_one();
+  }
+}
+
+bool WorkerPool::run(const size_t workers, const std::function<void(size_t)>& func)
+{
+  if(workers > m_size || m_busy.exchange(true))
+    return false;
+  if(workers == 0)
+  {
+    m_busy = false;
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_func = &func;
+    m_workers = workers;
+    m_running = workers - 1;
+    m_error = nullptr;
+    m_generation++;
+  }
+  if(workers > 1)
+    m_cv_start.notify_all();
+  std::exception_ptr error = nullptr;
+  try {
+    func(0);
+  } catch(...) {
+    error = std::current_exception();
+  }
+  //func is referenced by pool threads until all of them are done, so waiting in any case
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv_done.wait(lock, [&]{ return m_running == 0; });
+    m_func = nullptr;
+    if(error == nullptr)
+      error = m_error;
+    m_error = nullptr;
+  }
+  m_busy = false;
+  if(error != nullptr)
+    std::rethrow_exception(error);
+  return true;
+}
+
 unsigned ParallelScheduler::threadsNumber = 1;
 TThreading ParallelScheduler::threadingBackend = T_Serial;
 std::unique_ptr<ParallelScheduler> ParallelScheduler::pGlobalScheduler = nullptr;
@@ -80,9 +211,11 @@ public:
 
 
 ParallelScheduler::ParallelScheduler(const TThreading _threadingBackend, const unsigned _threadsNumber)
+  :
 #ifdef HAVE_TBB
-  : m_ptbb_scheduler(nullptr)
+  m_ptbb_scheduler(nullptr),
 #endif
+  m_pool(nullptr)
 {
   if(pGlobalScheduler != nullptr)
     throw ParallelException("Not allowed to create second ParallelScheduler instance");
@@ -118,6 +251,16 @@ unsigned ParallelScheduler::getThreadsNumber()
  return threadsNumber;
 }
 
+TThreading ParallelScheduler::getThreadingBackend()
+{
+ return threadingBackend;
+}
+
+WorkerPool* ParallelScheduler::getWorkerPool()
+{
+  return ( pGlobalScheduler != nullptr ? pGlobalScheduler->m_pool.get() : nullptr );
+}
+
 void ParallelScheduler::initBackend()
 {
   switch(threadingBackend)
@@ -125,9 +268,11 @@ void ParallelScheduler::initBackend()
     case T_Serial:
       return;
     case T_Std:
+      m_pool.reset(new WorkerPool(threadingBackend, threadsNumber));
       return;
 #ifdef HAVE_PTHREADS
     case T_Posix:
+      m_pool.reset(new WorkerPool(threadingBackend, threadsNumber));
       return;
 #endif
 #ifdef HAVE_OPENMP
@@ -161,9 +306,11 @@ void ParallelScheduler::terminateBackend()
     case T_Serial:
       return;
     case T_Std:
+      m_pool.reset();
       return;
 #ifdef HAVE_PTHREADS
     case T_Posix:
+      m_pool.reset();
       return;
 #endif
 #ifdef HAVE_OPENMP
@@ -193,9 +340,11 @@ void ParallelScheduler::setThreadsNumberBackend(unsigned num)
     case T_Serial:
       return;
     case T_Std:
+      m_pool.reset(new WorkerPool(threadingBackend, ( num > 0 ? num : hardware_concurrency() )));
       return;
 #ifdef HAVE_PTHREADS
     case T_Posix:
+      m_pool.reset(new WorkerPool(threadingBackend, ( num > 0 ? num : hardware_concurrency() )));
       return;
 #endif
 #ifdef HAVE_OPENMP
@@ -3,7 +3,19 @@
 #define _THREAD_HPP
 #include "config.h"
 
+# include <atomic>
+# include <condition_variable>
+# include <cstddef>
+# include <exception>
+# include <functional>
 # include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+#ifdef HAVE_PTHREADS
+# include <pthread.h>
+#endif
 
 #ifdef HAVE_TBB
 # include <tbb/task_scheduler_init.h>
@@ -24,6 +36,49 @@ enum TThreading {
 //wrapper over std::thread and many other ways to obtain number of processors
 unsigned hardware_concurrency();
 
+//persistent threads of std and posix backends, so that parallel regions don't start and join threads of their own.
+//owned by ParallelScheduler and used by run_workers, other backends keep their own pools
+class WorkerPool
+{
+public:
+  WorkerPool(const TThreading threadingBackend, const unsigned threadsNumber);
+  ~WorkerPool();
+  inline TThreading getThreadingBackend() const { return m_backend; }
+  //func(id) is called for every id in [0,workers) concurrently by calling thread(id 0) and pool threads,
+  //returns when all calls are done, first exception thrown by them is rethrown then.
+  //returns false without calling func if pool has less than workers threads or is busy with another region,
+  //e.g. if it's called from one of the calls
+  bool run(const size_t workers, const std::function<void(size_t)>& func);
+private:
+  void loop(const size_t id);
+#ifdef HAVE_PTHREADS
+  struct PosixThreadArg
+  {
+    WorkerPool* pool;
+    size_t id;
+  };
+  static void* runPosixThread(void* arg);
+  std::vector<pthread_t> m_pthreads;
+  std::vector<PosixThreadArg> m_pthread_args;
+#endif
+  std::vector<std::thread> m_threads;
+  const TThreading m_backend;
+  size_t m_size;
+  std::atomic<bool> m_busy;
+  std::mutex m_mutex;
+  std::condition_variable m_cv_start;
+  std::condition_variable m_cv_done;
+  const std::function<void(size_t)>* m_func;
+  size_t m_workers;
+  size_t m_running;
+  size_t m_generation;
+  bool m_stop;
+  std::exception_ptr m_error;
+  //no copying or copy assignment allowed
+  WorkerPool(const WorkerPool&);
+  WorkerPool& operator= (const WorkerPool&);
+};
+
 class ParallelScheduler
 {
   static unsigned threadsNumber;
@@ -32,6 +87,7 @@ class ParallelScheduler
 #ifdef HAVE_TBB
   std::unique_ptr<tbb::task_scheduler_init> m_ptbb_scheduler;
 #endif
+  std::unique_ptr<WorkerPool> m_pool;
   void initBackend();
   void terminateBackend();
   void setThreadsNumberBackend(unsigned num);
@@ -40,6 +96,9 @@ public:
   ~ParallelScheduler();
   static void setThreadsNumber(unsigned num);
   static unsigned getThreadsNumber();
+  static TThreading getThreadingBackend();
+  //pool of std or posix threads of global scheduler, null if there is none
+  static WorkerPool* getWorkerPool();
 private:
   //no copying or copy assignment allowed
   ParallelScheduler(const ParallelScheduler&);
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef _PARALLEL_TASKS_HPP
+#define _PARALLEL_TASKS_HPP
+#include "config.h"
+
+#include "numeric/parallel.hpp"
+#include "numeric/parallel_workers.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//graph of tasks with dependencies: every task is run once, after all its predecessors are done.
+//tasks are picked from ready queue by fixed number of workers started by run_workers, so the graph
+//is executed by any threading backend. among ready tasks those with larger priority are picked first
+//(and those added earlier for equal priorities), which is how look-ahead is expressed by task producers.
+//if a task throws, no more tasks are started, and the first exception is rethrown by run once workers are done
+class TaskGraph
+{
+public:
+  typedef std::function<void()> TaskFunc;
+
+  size_t addTask(const TaskFunc& func, const long priority = 0)
+  {
+    m_tasks.push_back(Task{func, priority, 0, std::vector<size_t>()});
+    return m_tasks.size() - 1;
+  }
+
+  //task after is not run until task before is done, before should be added earlier than after
+  void addDependency(const size_t before, const size_t after)
+  {
+    m_tasks[before].successors.push_back(after);
+    m_tasks[after].npredecessors++;
+  }
+
+  inline size_t size() const { return m_tasks.size(); }
+
+  void run(const TThreading threading_model, const size_t workers)
+  {
+    typedef std::pair<long, size_t> ReadyTask;
+    //larger priority first, smaller index for equal priorities
+    auto later = [](const ReadyTask& x, const ReadyTask& y)
+    {
+      return ( x.first != y.first ? x.first < y.first : x.second > y.second );
+    };
+    std::priority_queue<ReadyTask, std::vector<ReadyTask>, decltype(later)> ready(later);
+    std::vector<size_t> waiting(m_tasks.size());
+    for(size_t id = 0; id < m_tasks.size(); id++)
+    {
+      waiting[id] = m_tasks[id].npredecessors;
+      if(waiting[id] == 0)
+        ready.push(ReadyTask(m_tasks[id].priority, id));
+    }
+    size_t remaining = m_tasks.size();
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error = nullptr;
+    run_workers(( workers > 1 ? threading_model : T_Serial ), ( workers > 0 ? workers : 1 ), [&](const size_t)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      for(;;)
+      {
+        //some task is running if none is ready, as graph is acyclic
+        while(ready.empty() && remaining > 0 && error == nullptr)
+          cv.wait(lock);
+        if(remaining == 0 || error != nullptr)
+          return;
+        const size_t id = ready.top().second;
+        ready.pop();
+        lock.unlock();
+        try {
+          m_tasks[id].func();
+        } catch(...) {
+          //successors of failed task would never be ready, so waiting workers are released
+          lock.lock();
+          if(error == nullptr)
+            error = std::current_exception();
+          cv.notify_all();
+          return;
+        }
+        lock.lock();
+        remaining--;
+        bool released = false;
+        for(const size_t s : m_tasks[id].successors)
+        {
+          if(--waiting[s] == 0)
+          {
+            ready.push(ReadyTask(m_tasks[s].priority, s));
+            released = true;
+          }
+        }
+        if(released || remaining == 0)
+          cv.notify_all();
+      }
+    });
+    if(error != nullptr)
+      std::rethrow_exception(error);
+  }
+
+private:
+  struct Task
+  {
+    TaskFunc func;
+    long priority;
+    size_t npredecessors;
+    std::vector<size_t> successors;
+  };
+  std::vector<Task> m_tasks;
+};
+
+}
+
+#endif /* _PARALLEL_TASKS_HPP */
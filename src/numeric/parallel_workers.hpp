@@ -0,0 +1,175 @@
+#pragma once
+#ifndef _PARALLEL_WORKERS_HPP
+#define _PARALLEL_WORKERS_HPP
+#include "config.h"
+
+#include "numeric/parallel.hpp"
+
+#ifdef HAVE_CILK
+#include <cilk/cilk.h>
+#endif
+
+#ifdef HAVE_TBB
+#include "numeric/parallel_tbb.hpp"
+#endif
+
+#ifdef HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+
+namespace numeric {
+
+//helpers running fixed number of workers with selected threading backend:
+//func(id) is called for every id in [0,workers) concurrently, helpers return when all workers are done
+
+//persistent pool of global scheduler is used when it's of the same backend, big enough and free,
+//workers are started anew otherwise, e.g. for regions nested into pooled one
+inline bool __run_workers_pooled(const TThreading threading_model, const size_t workers, const std::function<void(size_t)>& func)
+{
+  WorkerPool* const pool = ParallelScheduler::getWorkerPool();
+  return ( pool != nullptr && pool->getThreadingBackend() == threading_model && pool->run(workers, func) );
+}
+
+//exceptions can't leave a worker thread, so each worker keeps its own one
+//and the first of them is rethrown on calling thread after all workers are joined
+inline void __run_worker_guarded(const std::function<void(size_t)>& func, const size_t id, std::exception_ptr& error)
+{
+  try {
+    func(id);
+  } catch(...) {
+    error = std::current_exception();
+  }
+}
+
+inline void __rethrow_worker_error(const std::vector<std::exception_ptr>& errors)
+{
+  for(const auto& error : errors)
+    if(error != nullptr)
+      std::rethrow_exception(error);
+}
+
+inline void run_workers_serial(const size_t workers, const std::function<void(size_t)>& func)
+{
+  for(size_t t = 0; t < workers; t++)
+    func(t);
+}
+
+inline void run_workers_stdthreads(const size_t workers, const std::function<void(size_t)>& func)
+{
+  if(workers == 0 || __run_workers_pooled(T_Std, workers, func))
+    return;
+  std::vector<std::exception_ptr> errors(workers, nullptr);
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for(size_t t = 1; t < workers; t++)
+    threads.emplace_back(&__run_worker_guarded, std::cref(func), t, std::ref(errors[t]));
+  __run_worker_guarded(func, 0, errors[0]);
+  for(auto& thread : threads)
+    thread.join();
+  __rethrow_worker_error(errors);
+}
+
+#ifdef HAVE_PTHREADS
+inline void run_workers_pthreads(const size_t workers, const std::function<void(size_t)>& func)
+{
+  struct worker_arg
+  {
+    const std::function<void(size_t)>* func;
+    size_t id;
+    std::exception_ptr* error;
+    static void* run(void* arg)
+    {
+      const worker_arg* const p = reinterpret_cast<const worker_arg*>(arg);
+      __run_worker_guarded(*p->func, p->id, *p->error);
+      return nullptr;
+    }
+  };
+  if(workers == 0 || __run_workers_pooled(T_Posix, workers, func))
+    return;
+  std::vector<pthread_t> threads(workers);
+  std::vector<worker_arg> args(workers);
+  std::vector<bool> started(workers, false);
+  std::vector<std::exception_ptr> errors(workers, nullptr);
+  for(size_t t = 1; t < workers; t++)
+  {
+    args[t] = worker_arg{&func, t, &errors[t]};
+    started[t] = ( pthread_create(&threads[t], nullptr, &worker_arg::run, &args[t]) == 0 );
+    //fall back to calling thread if we're out of resources
+    if(!started[t])
+      __run_worker_guarded(func, t, errors[t]);
+  }
+  __run_worker_guarded(func, 0, errors[0]);
+  for(size_t t = 1; t < workers; t++)
+    if(started[t])
+      pthread_join(threads[t], nullptr);
+  __rethrow_worker_error(errors);
+}
+#endif
+
+#ifdef HAVE_OPENMP
+inline void run_workers_openmp(const size_t workers, const std::function<void(size_t)>& func)
+{
+  std::vector<std::exception_ptr> errors(workers, nullptr);
+#pragma omp parallel for num_threads(workers) schedule(static,1)
+  for(size_t t = 0; t < workers; t++)
+    __run_worker_guarded(func, t, errors[t]);
+  __rethrow_worker_error(errors);
+}
+#endif
+
+#ifdef HAVE_CILK
+inline void run_workers_cilk(const size_t workers, const std::function<void(size_t)>& func)
+{
+  cilk_for(size_t t = 0; t < workers; t++)
+    func(t);
+}
+#endif
+
+#ifdef HAVE_TBB
+inline void run_workers_tbb(const size_t workers, const std::function<void(size_t)>& func)
+{
+  parallelForElem(size_t(0), workers, func);
+}
+#endif
+
+inline void run_workers(const TThreading threading_model, const size_t workers, const std::function<void(size_t)>& func)
+{
+  switch(threading_model)
+  {
+    case T_Serial:
+      return run_workers_serial(workers, func);
+    case T_Std:
+      return run_workers_stdthreads(workers, func);
+#ifdef HAVE_PTHREADS
+    case T_Posix:
+      return run_workers_pthreads(workers, func);
+#endif
+#ifdef HAVE_OPENMP
+    case T_OpenMP:
+      return run_workers_openmp(workers, func);
+#endif
+#ifdef HAVE_CILK
+    case T_Cilk:
+      return run_workers_cilk(workers, func);
+#endif
+#ifdef HAVE_TBB
+    case T_TBB:
+      return run_workers_tbb(workers, func);
+#endif
+    case T_Undefined:
+    default:
+      return run_workers_serial(workers, func);
+  }
+}
+
+}
+
+#endif /* _PARALLEL_WORKERS_HPP */
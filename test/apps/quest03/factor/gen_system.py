@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+
+# prints to stdout system with integer matrix of given kind and size, with right hand side b = A*x for
+# known integer solution x, which is printed to file given as third argument
+#   general    - random nonsymmetric matrix with zero diagonal, so that partial pivoting is required
+#   spd        - random symmetric diagonally dominant matrix with positive diagonal, i.e. positive definite one
+#   indefinite - random symmetric matrix with zero diagonal, so that Bunch-Kaufman takes 2x2 pivots with interchanges
+
+import sys
+import random
+
+if len(sys.argv) < 4:
+    sys.stderr.write("Usage: " + sys.argv[0] + " general|spd|indefinite <size> <solution file> [ <seed> ]\n")
+    sys.exit(1)
+
+kind = sys.argv[1]
+size = int(sys.argv[2])
+random.seed(int(sys.argv[4]) if len(sys.argv) > 4 else size)
+
+a = [[0] * size for i in range(size)]
+for i in range(size):
+    for j in range(size):
+        if kind == "general":
+            if i != j:
+                a[i][j] = random.randint(-9, 9)
+        elif j < i:
+            a[i][j] = a[j][i] = random.randint(-9, 9)
+if kind == "spd":
+    for i in range(size):
+        a[i][i] = sum(abs(v) for v in a[i]) + 1
+elif kind != "general" and kind != "indefinite":
+    sys.stderr.write("Unknown kind of matrix: " + kind + "\n")
+    sys.exit(1)
+
+x = [random.randint(-5, 5) for i in range(size)]
+
+sys.stdout.write("# %d\n" % size)
+for i in range(size):
+    sys.stdout.write(" ".join("%d" % v for v in a[i]) + "\n")
+for i in range(size):
+    sys.stdout.write("%d\n" % sum(a[i][j] * x[j] for j in range(size)))
+
+with open(sys.argv[3], "w") as f:
+    f.write("# %d\n" % size)
+    for v in x:
+        f.write("%d\n" % v)
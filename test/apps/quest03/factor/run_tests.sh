@@ -0,0 +1,78 @@
+#!/bin/bash
+
+# solves fixed and generated systems with known solutions by LU, Cholesky and LDL' algorithms of quest03
+# and compares results with expected solutions, prints FAIL for every mismatch and exits with non-zero status if any
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <directory with quest03 binaries> [ <size of generated systems> ]"
+  exit 1
+fi
+
+bin=$1/quest03-blocked-lu
+if [ ! -x ${bin} ]; then
+  echo "${bin} not found"
+  exit 1
+fi
+#input, output and algorithm are given by options, which apps built without boost::program_options ignore
+if ${bin} --help 2>&1 | grep -q "compiled without boost::program_options"; then
+  echo "${bin} is built without boost::program_options and can't be given test systems, rebuild with USE_BOOST"
+  exit 1
+fi
+fixture_dir=$(cd "$(dirname "$0")" && pwd)
+work_dir=$(mktemp -d)
+trap 'rm -rf ${work_dir}' EXIT
+#generated systems are larger than default panel and tile sizes, so blocked and tiled paths are exercised
+size=${2:-300}
+tolerance=1e-8
+failed=0
+
+general_algos="num-cpp-lu-b num-cpp-lu-t num-cpp-lu-mixed"
+spd_algos="num-cpp-lu-b num-cpp-lu-t num-cpp-cholesky-b num-cpp-cholesky-t num-cpp-ldlt num-cpp-lu-mixed"
+indefinite_algos="num-cpp-lu-b num-cpp-lu-t num-cpp-ldlt"
+
+#max relative difference between two vectors in .dat format is checked against tolerance
+compare() {
+  awk -v tol=${tolerance} '
+    BEGIN { n = 0; m = 0 }
+    /^#/ { next }
+    FNR == NR { x[n++] = $1; next }
+    { d = $1 - x[m]; if(d < 0) d = -d; s = x[m] < 0 ? -x[m] : x[m]; if(d > tol*(1+s)) bad = 1; m++ }
+    END { exit (bad || m != n || n == 0) }' "$1" "$2"
+}
+
+check() {
+  local name=$1 algo=$2 threading=$3
+  shift 3
+  rm -f ${work_dir}/result.dat
+  ${bin} -I ${work_dir}/${name} -O ${work_dir}/result --verbose=0 --algorithm=${algo} --threading=${threading} "$@" \
+    > /dev/null 2>&1
+  if compare ${work_dir}/${name}_solution.dat ${work_dir}/result.dat; then
+    echo "ok   ${name} ${algo} ${threading} $*"
+  else
+    echo "FAIL ${name} ${algo} ${threading} $*"
+    failed=1
+  fi
+}
+
+for kind in general spd indefinite; do
+  cp ${fixture_dir}/${kind}.dat ${fixture_dir}/${kind}_solution.dat ${work_dir}/
+  ${fixture_dir}/gen_system.py ${kind} ${size} ${work_dir}/${kind}${size}_solution.dat > ${work_dir}/${kind}${size}.dat
+  algos=${kind}_algos
+  for name in ${kind} ${kind}${size}; do
+    for algo in ${!algos}; do
+      for threading in s std; do
+        check ${name} ${algo} ${threading}
+      done
+    done
+  done
+done
+
+#factors saved by one run are read back by another one, which is given right hand side only
+{ echo "# ${size} 1"; tail -n ${size} ${work_dir}/spd${size}.dat; } > ${work_dir}/spd${size}_rhs.dat
+cp ${work_dir}/spd${size}_solution.dat ${work_dir}/spd${size}_rhs_solution.dat
+for algo in num-cpp-lu-b num-cpp-cholesky-b; do
+  check spd${size} ${algo} std --factor-out=${work_dir}/factor
+  check spd${size}_rhs ${algo} std --factor-in=${work_dir}/factor
+done
+
+exit ${failed}